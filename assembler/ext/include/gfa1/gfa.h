@@ -97,6 +97,14 @@ void gfa_destroy(gfa_t *g);
 
 gfa_t *gfa_read(const char *fn);
 
+// Line parsers used by gfa_read(); s is modified in place. Once all lines are
+// parsed, gfa_finalize() applies the same fix-ups to the graph as gfa_read().
+int gfa_parse_S(gfa_t *g, char *s);
+int gfa_parse_L(gfa_t *g, char *s);
+int gfa_parse_P(gfa_t *g, char *s);
+uint64_t gfa_add_arc1(gfa_t *g, uint32_t v, uint32_t w, int32_t ov, int32_t ow, int64_t link_id, int comp);
+void gfa_finalize(gfa_t *g);
+
 void gfa_print(const gfa_t *g, FILE *fp, int M_only);
 
 void gfa_symm(gfa_t *g); // delete multiple edges and restore skew-symmetry
@@ -552,6 +552,17 @@ uint32_t gfa_fix_symm(gfa_t *g)
 	return n_err;
 }
 
+void gfa_finalize(gfa_t *g)
+{
+	gfa_fix_no_seg(g);
+	gfa_arc_sort(g);
+	gfa_arc_index(g);
+	gfa_fix_semi_arc(g);
+	gfa_fix_symm(g);
+	gfa_fix_arc_len(g);
+	gfa_cleanup(g);
+}
+
 /****************
  * User-end I/O *
  ****************/
@@ -580,13 +591,7 @@ gfa_t *gfa_read(const char *fn)
 			fprintf(stderr, "[E] invalid %c-line at line %ld (error code %d)\n", s.s[0], (long)lineno, ret);
 	}
 	free(s.s);
-	gfa_fix_no_seg(g);
-	gfa_arc_sort(g);
-	gfa_arc_index(g);
-	gfa_fix_semi_arc(g);
-	gfa_fix_symm(g);
-	gfa_fix_arc_len(g);
-	gfa_cleanup(g);
+	gfa_finalize(g);
 	ks_destroy(ks);
 	gzclose(fp);
 	return g;
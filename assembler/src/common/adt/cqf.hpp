@@ -5,6 +5,7 @@
 #include <cmath>
 #include <cstring>
 #include <functional>
+#include <string>
 #include <cassert>
 
 namespace qf {
@@ -37,8 +38,21 @@ class cqf {
         // fprintf(stderr, "%llu %u %llu\n", num_slots_, num_hash_bits_, qf_.metadata->range);
     }
 
+    // Restores the filter written by serialize()
+    explicit cqf(const std::string &filename)
+            : insertions_(0) {
+        qf_deserialize(&qf_, filename.c_str());
+        num_hash_bits_ = unsigned(qf_.metadata->key_bits);
+        num_slots_ = qf_.metadata->nslots;
+        range_mask_ = qf_.metadata->range - 1;
+    }
+
     cqf(cqf&&) noexcept = default;
 
+    void serialize(const std::string &filename) const {
+        qf_serialize(&qf_, filename.c_str());
+    }
+
     bool add(digest d, uint64_t count = 1,
              bool lock = true, bool spin = true) {
         bool res = qf_insert(&qf_, d & range_mask_, 0, count, lock, spin);
@@ -179,6 +179,11 @@ public:
         return *runs_[winner_index].begin();
     }
 
+    // Position of the current top element inside its run
+    const It &top_iterator() const {
+        return runs_[entry_[0]].begin();
+    }
+
     void replay() {
         size_t winner_index = entry_[0];
         entry_[0] = replay(winner_index);
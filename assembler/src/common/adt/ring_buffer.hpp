@@ -0,0 +1,226 @@
+//***************************************************************************
+//* Copyright (c) 2021 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#pragma once
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace adt {
+
+// Double-ended queue stored in a single power-of-two sized circular array.
+// Unlike std::deque it makes no allocation while empty and a single one
+// afterwards, supports amortized O(1) insertion and removal at both ends and
+// keeps the elements in at most two contiguous segments, so that the scans
+// could be done over the plain arrays (see for_each_segment).
+// Slots of the removed elements are reset to T(), so T must be default constructible.
+template<class T>
+class ring_buffer {
+    static constexpr size_t MIN_CAPACITY = 4;
+
+    template<class V, class Buffer>
+    class iterator_base : public boost::iterator_facade<iterator_base<V, Buffer>, V,
+                                                        boost::random_access_traversal_tag> {
+    public:
+        iterator_base(Buffer *buffer = nullptr, size_t index = 0)
+                : buffer_(buffer), index_(index) {}
+
+        template<class V2, class Buffer2,
+                 typename = std::enable_if_t<std::is_convertible<Buffer2*, Buffer*>::value>>
+        iterator_base(const iterator_base<V2, Buffer2> &other)
+                : buffer_(other.buffer_), index_(other.index_) {}
+
+    private:
+        friend class boost::iterator_core_access;
+        template<class, class> friend class iterator_base;
+
+        V &dereference() const { return (*buffer_)[index_]; }
+        void increment() { ++index_; }
+        void decrement() { --index_; }
+        void advance(ptrdiff_t n) { index_ += n; }
+        ptrdiff_t distance_to(const iterator_base &other) const { return ptrdiff_t(other.index_ - index_); }
+        bool equal(const iterator_base &other) const { return index_ == other.index_; }
+
+        Buffer *buffer_;
+        size_t index_;
+    };
+
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef iterator_base<T, ring_buffer> iterator;
+    typedef iterator_base<const T, const ring_buffer> const_iterator;
+
+    ring_buffer() : head_(0), size_(0) {}
+
+    explicit ring_buffer(size_t count, const T &value = T())
+            : ring_buffer() {
+        resize(count, value);
+    }
+
+    ring_buffer(const ring_buffer &other)
+            : ring_buffer() {
+        reserve(other.size_);
+        for (const auto &x : other)
+            push_back(x);
+    }
+
+    ring_buffer(ring_buffer &&other) noexcept
+            : ring_buffer() {
+        swap(other);
+    }
+
+    ring_buffer &operator=(const ring_buffer &other) {
+        if (this != &other) {
+            ring_buffer copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    ring_buffer &operator=(ring_buffer &&other) noexcept {
+        ring_buffer tmp(std::move(other));
+        swap(tmp);
+        return *this;
+    }
+
+    void swap(ring_buffer &other) noexcept {
+        storage_.swap(other.storage_);
+        std::swap(head_, other.head_);
+        std::swap(size_, other.size_);
+    }
+
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    size_t capacity() const noexcept { return storage_.size(); }
+
+    T &operator[](size_t index) noexcept { return storage_[slot(index)]; }
+    const T &operator[](size_t index) const noexcept { return storage_[slot(index)]; }
+
+    T &at(size_t index) {
+        check_index(index);
+        return (*this)[index];
+    }
+
+    const T &at(size_t index) const {
+        check_index(index);
+        return (*this)[index];
+    }
+
+    T &front() noexcept { return storage_[head_]; }
+    const T &front() const noexcept { return storage_[head_]; }
+    T &back() noexcept { return (*this)[size_ - 1]; }
+    const T &back() const noexcept { return (*this)[size_ - 1]; }
+
+    void push_back(const T &value) { emplace_back(value); }
+    void push_back(T &&value) { emplace_back(std::move(value)); }
+    void push_front(const T &value) { emplace_front(value); }
+    void push_front(T &&value) { emplace_front(std::move(value)); }
+
+    template<class... Args>
+    void emplace_back(Args&&... args) {
+        T value(std::forward<Args>(args)...);
+        ensure_capacity(size_ + 1);
+        storage_[slot(size_)] = std::move(value);
+        size_ += 1;
+    }
+
+    template<class... Args>
+    void emplace_front(Args&&... args) {
+        T value(std::forward<Args>(args)...);
+        ensure_capacity(size_ + 1);
+        head_ = (head_ - 1) & mask();
+        storage_[head_] = std::move(value);
+        size_ += 1;
+    }
+
+    void pop_back() noexcept {
+        back() = T();
+        size_ -= 1;
+    }
+
+    void pop_front() noexcept {
+        front() = T();
+        head_ = (head_ + 1) & mask();
+        size_ -= 1;
+    }
+
+    void clear() noexcept {
+        while (!empty())
+            pop_back();
+        head_ = 0;
+    }
+
+    void resize(size_t count, const T &value = T()) {
+        reserve(count);
+        while (size_ > count)
+            pop_back();
+        while (size_ < count)
+            push_back(value);
+    }
+
+    void reserve(size_t count) {
+        ensure_capacity(count);
+    }
+
+    iterator begin() noexcept { return iterator(this, 0); }
+    iterator end() noexcept { return iterator(this, size_); }
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, size_); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // Calls f(ptr, count, index) for each contiguous piece of the elements [from, to):
+    // ptr[0..count) are the elements with the indices starting from index
+    template<class F>
+    void for_each_segment(size_t from, size_t to, F f) const {
+        while (from < to) {
+            size_t start = slot(from);
+            size_t count = std::min(to - from, storage_.size() - start);
+            f(storage_.data() + start, count, from);
+            from += count;
+        }
+    }
+
+private:
+    size_t mask() const noexcept { return storage_.size() - 1; }
+    size_t slot(size_t index) const noexcept { return (head_ + index) & mask(); }
+
+    void check_index(size_t index) const {
+        if (index >= size_)
+            throw std::out_of_range("ring_buffer::at");
+    }
+
+    void ensure_capacity(size_t count) {
+        if (count <= storage_.size())
+            return;
+
+        size_t capacity = storage_.empty() ? MIN_CAPACITY : storage_.size() * 2;
+        while (capacity < count)
+            capacity *= 2;
+
+        std::vector<T> storage(capacity);
+        for (size_t i = 0; i < size_; ++i)
+            storage[i] = std::move((*this)[i]);
+        storage_.swap(storage);
+        head_ = 0;
+    }
+
+    std::vector<T> storage_;
+    size_t head_;
+    size_t size_;
+};
+
+}
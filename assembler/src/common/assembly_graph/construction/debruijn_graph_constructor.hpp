@@ -264,8 +264,8 @@ private:
         return {s};
     }
 
-    void CalculateSequences(kmer_iterator &it,
-                            std::vector<Sequence> &sequences) const {
+    template<class Handler>
+    void CalculateSequences(kmer_iterator &it, Handler &&handler) const {
         SequenceBuilder builder;
         std::vector<DeEdge> start_edges;
         start_edges.reserve(8);
@@ -279,12 +279,26 @@ private:
                 if (s < !s)
                     continue;
 
-                sequences.push_back(s);
                 TRACE("From " << edge << " calculated sequence\n" << s);
+                handler(std::move(s));
             }
         }
     }
 
+    void CleanCondensed(const std::vector<Sequence> &sequences) {
+#       pragma omp parallel for schedule(guided)
+        for (size_t i = 0; i < sequences.size(); ++i) {
+            CleanCondensed(sequences[i]);
+            CleanCondensed(!sequences[i]);
+        }
+    }
+
+public:
+    UnbranchingPathExtractor(Index &origin, size_t k)
+            : origin_(origin), kmer_size_(k) {}
+
+    // Removes the k-mers of already extracted sequence from the index, so
+    // they won't be seen by CollectLoops()
     void CleanCondensed(const Sequence &sequence) {
         Kmer kmer = sequence.start<Kmer>(kmer_size_);
         KeyWithHash kwh = origin_.ConstructKWH(kmer);
@@ -295,14 +309,6 @@ private:
         }
     }
 
-    void CleanCondensed(const std::vector<Sequence> &sequences) {
-#       pragma omp parallel for schedule(guided)
-        for (size_t i = 0; i < sequences.size(); ++i) {
-            CleanCondensed(sequences[i]);
-            CleanCondensed(!sequences[i]);
-        }
-    }
-
     // This methods collects all loops that were not extracted by finding
     // unbranching paths because there are no junctions on loops.
     const std::vector<Sequence> CollectLoops(unsigned nchunks) {
@@ -343,9 +349,29 @@ private:
         return result;
     }
 
-public:
-    UnbranchingPathExtractor(Index &origin, size_t k)
-            : origin_(origin), kmer_size_(k) {}
+    // Counts the paths ProcessUnbranchingPaths() would report for every
+    // chunk. The paths are walked, but not stored. The chunks are the same as
+    // produced by kmer_begin(nchunks).
+    std::vector<size_t> CountUnbranchingPaths(unsigned nchunks) const {
+        auto its = origin_.kmer_begin(nchunks);
+        std::vector<size_t> counts(its.size(), 0);
+#       pragma omp parallel for schedule(guided)
+        for (size_t i = 0; i < its.size(); ++i)
+            CalculateSequences(its[i], [&](Sequence) { counts[i] += 1; });
+
+        return counts;
+    }
+
+    // Streams the unbranching paths to handler(chunk, sequence) as soon as
+    // they are built, without collecting them. The handler is called
+    // concurrently for different chunks, but sequentially within a chunk.
+    template<class Handler>
+    void ProcessUnbranchingPaths(unsigned nchunks, Handler &&handler) const {
+        auto its = origin_.kmer_begin(nchunks);
+#       pragma omp parallel for schedule(guided)
+        for (size_t i = 0; i < its.size(); ++i)
+            CalculateSequences(its[i], [&](Sequence s) { handler(i, std::move(s)); });
+    }
 
     //TODO very large vector is returned. But I hate to make all those artificial changes that can fix it.
     const std::vector<Sequence> ExtractUnbranchingPaths(unsigned nchunks) const {
@@ -355,7 +381,7 @@ public:
         std::vector<std::vector<Sequence>> sequences(its.size());
 #       pragma omp parallel for schedule(guided)
         for (size_t i = 0; i < its.size(); ++i)
-            CalculateSequences(its[i], sequences[i]);
+            CalculateSequences(its[i], [&](Sequence s) { sequences[i].push_back(std::move(s)); });
 
         size_t snum = std::accumulate(sequences.begin(), sequences.end(),
                                       0ULL,
@@ -476,18 +502,8 @@ private:
             helper.LinkIncomingEdge(v1, edge);
     }
 
-public:
-    FastGraphFromSequencesConstructor(size_t k, Index &origin)
-            : kmer_size_(k), origin_(origin) {}
-
-    void ConstructGraph(Graph &graph, const std::vector<Sequence> &sequences) const {
-        typename Graph::HelperT helper = graph.GetConstructionHelper();
-
-        std::vector<LinkRecord> records;
-        INFO("Total " << 2*sequences.size() << " edges to create");
-        graph.ereserve(size_t(2.01*sequences.size()));
-        INFO("Collecting link records")
-        CollectLinkRecords(helper, graph, records, sequences);
+    void ConnectGraph(typename Graph::HelperT &helper, Graph &graph,
+                      std::vector<LinkRecord> &records) const {
         INFO("Ordering link records")
         parallel::sort(records.begin(), records.end());
         INFO("Sorting done");
@@ -515,6 +531,95 @@ public:
             }
         }
     }
+
+    void AddEdge(typename Graph::HelperT &helper, const Graph &graph,
+                 const Sequence &sequence, uint64_t id,
+                 std::vector<LinkRecord> &records) const {
+        EdgeId edge = helper.AddEdge(DeBruijnEdgeData(sequence), id);
+        records.push_back(StartLink(edge, sequence));
+        if (graph.conjugate(edge) != edge)
+            records.push_back(EndLink(edge, sequence));
+    }
+
+public:
+    FastGraphFromSequencesConstructor(size_t k, Index &origin)
+            : kmer_size_(k), origin_(origin) {}
+
+    void ConstructGraph(Graph &graph, const std::vector<Sequence> &sequences) const {
+        typename Graph::HelperT helper = graph.GetConstructionHelper();
+
+        std::vector<LinkRecord> records;
+        INFO("Total " << 2*sequences.size() << " edges to create");
+        graph.ereserve(size_t(2.01*sequences.size()));
+        INFO("Collecting link records")
+        CollectLinkRecords(helper, graph, records, sequences);
+        ConnectGraph(helper, graph, records);
+    }
+
+    // Streaming construction: unbranching paths are turned into edges as soon
+    // as they are extracted, so the edge sequences are never collected
+    // together. The paths of every chunk are counted beforehand, so each
+    // chunk gets its own range of edge ids of the exact size. The chunks are
+    // consecutive parts of the index, therefore the ids are dense and do not
+    // depend on the number of chunks.
+    void ConstructGraph(Graph &graph, UnbranchingPathExtractor &extractor,
+                        unsigned nchunks, bool keep_perfect_loops) const {
+        typename Graph::HelperT helper = graph.GetConstructionHelper();
+        uint64_t min_id = graph.min_id();
+
+        INFO("Counting unbranching paths");
+        std::vector<size_t> counts = extractor.CountUnbranchingPaths(nchunks);
+        std::vector<uint64_t> next_id(counts.size()), end_id(counts.size());
+        size_t total = 0;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            next_id[i] = min_id + 2 * total;
+            total += counts[i];
+            end_id[i] = min_id + 2 * total;
+        }
+        INFO("Total " << total << " unbranching paths to extract");
+        graph.ereserve(2 * total);
+
+        INFO("Extracting unbranching paths and collecting link records");
+        std::vector<std::vector<LinkRecord>> chunk_records(counts.size());
+        extractor.ProcessUnbranchingPaths(nchunks, [&](size_t chunk, const Sequence &s) {
+                VERIFY(next_id[chunk] < end_id[chunk]);
+                AddEdge(helper, graph, s, next_id[chunk], chunk_records[chunk]);
+                next_id[chunk] += 2;
+            });
+        VERIFY(next_id == end_id);
+
+        if (keep_perfect_loops) {
+#           pragma omp parallel for schedule(guided)
+            for (size_t i = 0; i < chunk_records.size(); ++i) {
+                for (const auto &record : chunk_records[i]) {
+                    if (!record.IsStart())
+                        continue;
+                    const Sequence &s = graph.EdgeNucls(record.GetEdge());
+                    extractor.CleanCondensed(s);
+                    extractor.CleanCondensed(!s);
+                }
+            }
+
+            std::vector<Sequence> loops = extractor.CollectLoops(nchunks);
+            graph.ereserve(2 * (total + loops.size()));
+            chunk_records.emplace_back();
+            for (size_t i = 0; i < loops.size(); ++i)
+                AddEdge(helper, graph, loops[i], min_id + 2 * (total + i), chunk_records.back());
+        }
+
+        size_t nrecords = 0;
+        for (const auto &chunk : chunk_records)
+            nrecords += chunk.size();
+        std::vector<LinkRecord> records;
+        records.reserve(nrecords);
+        for (auto &chunk : chunk_records) {
+            records.insert(records.end(), chunk.begin(), chunk.end());
+            std::vector<LinkRecord>().swap(chunk);
+        }
+        INFO("Total " << graph.e_size() << " edges created");
+
+        ConnectGraph(helper, graph, records);
+    }
 };
 
 /*
@@ -538,13 +643,10 @@ public:
     }
 
     void ConstructGraph(bool keep_perfect_loops) {
-        std::vector<Sequence> edge_sequences;
         unsigned nchunks = 16 * omp_get_max_threads();
-        if (keep_perfect_loops)
-            edge_sequences = UnbranchingPathExtractor(origin_, kmer_size_).ExtractUnbranchingPathsAndLoops(nchunks);
-        else
-            edge_sequences = UnbranchingPathExtractor(origin_, kmer_size_).ExtractUnbranchingPaths(nchunks);
-        FastGraphFromSequencesConstructor<Graph>(kmer_size_, origin_).ConstructGraph(graph_, edge_sequences);
+        UnbranchingPathExtractor extractor(origin_, kmer_size_);
+        FastGraphFromSequencesConstructor<Graph>(kmer_size_, origin_).ConstructGraph(graph_, extractor,
+                                                                                    nchunks, keep_perfect_loops);
     }
 
 private:
@@ -78,17 +78,17 @@ bool ScaffoldingUniqueEdgeAnalyzer::ConservativeByLength(EdgeId e) {
     return graph_.length(e) >= length_cutoff_;
 }
 
-map<EdgeId, size_t> ScaffoldingUniqueEdgeAnalyzer::FillNextEdgeVoting(BidirectionalPathMap<size_t>& active_paths, int direction) const {
+map<EdgeId, size_t> ScaffoldingUniqueEdgeAnalyzer::FillNextEdgeVoting(vector<pair<LongReadPath, size_t>>& active_paths, int direction) const {
     map<EdgeId, size_t> voting;
-    for (const auto &pair: active_paths) {
+    for (auto &pair: active_paths) {
         int current_pos = int(pair.second) + direction;
-        auto path_iter = pair.first;
+        const LongReadPath &path = pair.first;
         //not found
-        active_paths[path_iter] = path_iter->Size();
-        while (current_pos >= 0 && current_pos < (int) path_iter->Size()) {
-            if (graph_.length(path_iter->At(current_pos)) >= length_cutoff_) {
-                voting[path_iter->At(current_pos)] += size_t(round(path_iter->GetWeight()));
-                active_paths[path_iter] = size_t(current_pos);
+        pair.second = path.Size();
+        while (current_pos >= 0 && current_pos < (int) path.Size()) {
+            if (graph_.length(path.At(current_pos)) >= length_cutoff_) {
+                voting[path.At(current_pos)] += size_t(round(path.GetWeight()));
+                pair.second = size_t(current_pos);
                 break;
             }
             current_pos += direction;
@@ -97,21 +97,21 @@ map<EdgeId, size_t> ScaffoldingUniqueEdgeAnalyzer::FillNextEdgeVoting(Bidirectio
     return voting;
 }
 
-bool ScaffoldingUniqueEdgeAnalyzer::ConservativeByPaths(EdgeId e, const GraphCoverageMap &long_reads_cov_map,
+bool ScaffoldingUniqueEdgeAnalyzer::ConservativeByPaths(EdgeId e, const LongReadsCoverageMap &long_reads_cov_map,
                                                         const pe_config::LongReads &lr_config, int direction) const {
-    BidirectionalPathSet all_set = long_reads_cov_map.GetCoveringPaths(e);
-    BidirectionalPathMap<size_t> active_paths;
+    // Covering paths with the current positions, in the order of their ids
+    vector<pair<LongReadPath, size_t>> active_paths;
     size_t loop_weight = 0;
     size_t nonloop_weight = 0;
     DEBUG ("Checking " << graph_.int_id(e) <<" dir "<< direction );
-    for (auto path_iter: all_set) {
-        auto pos = path_iter->FindAll(e);
+    for (const LongReadPath &path: long_reads_cov_map.GetCoveringPaths(e)) {
+        auto pos = path.FindAll(e);
         if (pos.size() > 1)
 //TODO:: path weight should be size_t?
-            loop_weight += size_t(round(path_iter->GetWeight()));
+            loop_weight += size_t(round(path.GetWeight()));
         else {
-            if (path_iter->Size() > 1) nonloop_weight += size_t(round(path_iter->GetWeight()));
-            active_paths[path_iter] = pos[0];
+            if (path.Size() > 1) nonloop_weight += size_t(round(path.GetWeight()));
+            active_paths.emplace_back(path, pos[0]);
         }
     }
 //TODO: small plasmid, paths a-b-a, b-a-b ?
@@ -147,13 +147,12 @@ bool ScaffoldingUniqueEdgeAnalyzer::ConservativeByPaths(EdgeId e, const GraphCov
             return false;
         } else {
             DEBUG("cur " << graph_.int_id(prev_unique) << " next " << graph_.int_id(next_unique) << " sz " << active_paths.size());
-            for (auto iter = active_paths.begin(); iter != active_paths.end();) {
-                if (iter->second >= iter->first->Size() || iter->first->At(iter->second) != next_unique) {
-                    iter = active_paths.erase(iter);
-                } else {
-                    iter++;
-                }
-            }
+            active_paths.erase(std::remove_if(active_paths.begin(), active_paths.end(),
+                                              [&](const pair<LongReadPath, size_t> &active) {
+                                                  return active.second >= active.first.Size() ||
+                                                         active.first.At(active.second) != next_unique;
+                                              }),
+                               active_paths.end());
             prev_unique = next_unique;
             DEBUG(active_paths.size() << " "<< graph_.int_id(next_unique));
         }
@@ -163,7 +162,7 @@ bool ScaffoldingUniqueEdgeAnalyzer::ConservativeByPaths(EdgeId e, const GraphCov
 }
 
 bool ScaffoldingUniqueEdgeAnalyzer::ConservativeByPaths(EdgeId e,
-                                                        const GraphCoverageMap &long_reads_cov_map,
+                                                        const LongReadsCoverageMap &long_reads_cov_map,
                                                         const pe_config::LongReads &lr_config) const{
     return (ConservativeByPaths(e, long_reads_cov_map, lr_config, 1) && ConservativeByPaths(e, long_reads_cov_map, lr_config, -1));
 }
@@ -278,7 +277,7 @@ void ScaffoldingUniqueEdgeAnalyzer::ClearLongEdgesWithPairedLib(size_t lib_index
 }
 
 
-void ScaffoldingUniqueEdgeAnalyzer::FillUniqueEdgesWithLongReads(GraphCoverageMap &long_reads_cov_map,
+void ScaffoldingUniqueEdgeAnalyzer::FillUniqueEdgesWithLongReads(const LongReadsCoverageMap &long_reads_cov_map,
                                                                  ScaffoldingUniqueEdgeStorage &unique_storage_pb,
                                                                  const pe_config::LongReads &lr_config) {
     for (auto iter = graph_.ConstEdgeBegin(); !iter.IsEnd(); ++iter) {
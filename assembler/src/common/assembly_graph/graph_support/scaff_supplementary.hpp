@@ -2,6 +2,7 @@
 
 #include "assembly_graph/core/graph.hpp"
 #include "modules/path_extend/pe_utils.hpp"
+#include "modules/path_extend/long_reads_coverage_map.hpp"
 #include "modules/path_extend/pe_config_struct.hpp"
 #include "modules/path_extend/paired_library.hpp"
 
@@ -90,10 +91,10 @@ class ScaffoldingUniqueEdgeAnalyzer {
     bool FindCommonChildren(EdgeId e1, EdgeId e2, std::map<VertexId, std::set<VertexId>> &dijkstra_cash) const;
     bool FindCommonChildren(const std::vector<std::pair<EdgeId, double>> &next_weights) const;
     bool FindCommonChildren(EdgeId from, size_t lib_index) const;
-    std::map<EdgeId, size_t> FillNextEdgeVoting(BidirectionalPathMap<size_t>& active_paths, int direction) const;
-    bool ConservativeByPaths(EdgeId e, const GraphCoverageMap &long_reads_cov_map,
+    std::map<EdgeId, size_t> FillNextEdgeVoting(std::vector<std::pair<LongReadPath, size_t>>& active_paths, int direction) const;
+    bool ConservativeByPaths(EdgeId e, const LongReadsCoverageMap &long_reads_cov_map,
                              const pe_config::LongReads &lr_config) const;
-    bool ConservativeByPaths(EdgeId e, const GraphCoverageMap &long_reads_cov_map,
+    bool ConservativeByPaths(EdgeId e, const LongReadsCoverageMap &long_reads_cov_map,
                              const pe_config::LongReads &lr_config, int direction) const;
     bool ConservativeByLength(EdgeId e);
     void CheckCorrectness(ScaffoldingUniqueEdgeStorage& unique_storage_pb);
@@ -107,7 +108,7 @@ public:
                                   double max_relative_coverage);
     void FillUniqueEdgeStorage(ScaffoldingUniqueEdgeStorage &storage);
     void ClearLongEdgesWithPairedLib(size_t lib_index, ScaffoldingUniqueEdgeStorage &storage) const;
-    void FillUniqueEdgesWithLongReads(GraphCoverageMap &long_reads_cov_map,
+    void FillUniqueEdgesWithLongReads(const LongReadsCoverageMap &long_reads_cov_map,
                                       ScaffoldingUniqueEdgeStorage &unique_storage_pb,
                                       const pe_config::LongReads &lr_config);
 };
@@ -191,7 +192,7 @@ struct UniqueData {
 
     ScaffoldingUniqueEdgeStorage unique_pb_storage_;
     std::vector<PathContainer> long_reads_paths_;
-    std::vector<GraphCoverageMap> long_reads_cov_map_;
+    std::vector<LongReadsCoverageMap> long_reads_cov_map_;
 };
 
 } // namespace path_extend
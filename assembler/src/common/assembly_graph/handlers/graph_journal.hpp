@@ -0,0 +1,102 @@
+//***************************************************************************
+//* Copyright (c) 2021 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#pragma once
+
+#include "assembly_graph/core/action_handlers.hpp"
+
+#include <string>
+#include <unordered_set>
+
+namespace omnigraph {
+
+/**
+ * Records the vertices and edges added to and removed from the graph since
+ * the last full save of the graph pack (the base), so the following saves
+ * could store only the difference against it. Once the difference grows
+ * comparable with the graph itself the journal gives up: a full save is
+ * cheaper then, and it becomes the new base.
+ */
+template<class Graph>
+class GraphJournal : public GraphActionHandler<Graph> {
+    typedef GraphActionHandler<Graph> base;
+    typedef typename Graph::VertexId VertexId;
+    typedef typename Graph::EdgeId EdgeId;
+
+    std::unordered_set<VertexId> added_vertices_, removed_vertices_;
+    std::unordered_set<EdgeId> added_edges_, removed_edges_;
+    std::string base_;
+    size_t limit_;
+
+    // Conjugate elements are added and removed together and the handler is
+    // notified about both of them, so the pair is recorded under the smaller
+    // of its ids only
+    template<class Id>
+    bool IsCanonical(Id id) const {
+        return !(this->g().conjugate(id) < id);
+    }
+
+    template<class Id>
+    void Add(std::unordered_set<Id> &added, Id id) {
+        if (base_.empty() || !IsCanonical(id))
+            return;
+        added.insert(id);
+        CheckLimit();
+    }
+
+    template<class Id>
+    void Remove(std::unordered_set<Id> &added, std::unordered_set<Id> &removed, Id id) {
+        if (base_.empty() || !IsCanonical(id))
+            return;
+        // Elements created after the base are simply forgotten
+        if (!added.erase(id))
+            removed.insert(id);
+        CheckLimit();
+    }
+
+    void CheckLimit() {
+        if (added_edges_.size() + removed_edges_.size() > limit_)
+            Reset();
+    }
+
+public:
+    explicit GraphJournal(const Graph &g)
+            : base(g, "GraphJournal"), limit_(0) {}
+
+    void HandleAdd(VertexId v) override { Add(added_vertices_, v); }
+    void HandleAdd(EdgeId e) override { Add(added_edges_, e); }
+    void HandleDelete(VertexId v) override { Remove(added_vertices_, removed_vertices_, v); }
+    void HandleDelete(EdgeId e) override { Remove(added_edges_, removed_edges_, e); }
+
+    /// Starts recording the changes against the save with the given name
+    void Rebase(const std::string &name) {
+        Reset();
+        base_ = name;
+        limit_ = this->g().e_size() / 4;
+    }
+
+    /// Forgets the base, so the next save has to be a full one
+    void Reset() {
+        base_.clear();
+        added_vertices_.clear();
+        removed_vertices_.clear();
+        added_edges_.clear();
+        removed_edges_.clear();
+    }
+
+    bool has_base() const { return !base_.empty(); }
+    const std::string &base_name() const { return base_; }
+
+    const std::unordered_set<VertexId> &added_vertices() const { return added_vertices_; }
+    const std::unordered_set<VertexId> &removed_vertices() const { return removed_vertices_; }
+    const std::unordered_set<EdgeId> &added_edges() const { return added_edges_; }
+    const std::unordered_set<EdgeId> &removed_edges() const { return removed_edges_; }
+
+private:
+    DECL_LOGGER("GraphJournal");
+};
+
+}
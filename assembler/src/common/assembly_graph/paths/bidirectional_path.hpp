@@ -10,10 +10,10 @@
 #include "assembly_graph/core/graph.hpp"
 #include "io/binary/binary.hpp"
 #include "adt/small_pod_vector.hpp"
+#include "adt/ring_buffer.hpp"
 
 #include <algorithm>
 #include <atomic>
-#include <deque>
 #include <vector>
 
 namespace path_extend {
@@ -160,15 +160,19 @@ public:
 class SimpleBidirectionalPath {
 protected:
     using EdgeId = debruijn_graph::EdgeId;
-    std::deque<EdgeId> edges_;
-    std::deque<Gap> gaps_; // gap0 -> e0 -> gap1 -> e1 -> ... -> gapN -> eN; gap0 = 0
+    // Edges are kept apart from the gaps, so that the edge scans run over contiguous arrays
+    adt::ring_buffer<EdgeId> edges_;
+    adt::ring_buffer<Gap> gaps_; // gap0 -> e0 -> gap1 -> e1 -> ... -> gapN -> eN; gap0 = 0
 
 public:
     SimpleBidirectionalPath() = default;
     SimpleBidirectionalPath(const std::vector<EdgeId>& path)
-        : edges_(path.begin(), path.end())
-        , gaps_(path.size(), Gap())
-    {}
+        : gaps_(path.size(), Gap())
+    {
+        edges_.reserve(path.size());
+        for (EdgeId e : path)
+            edges_.push_back(e);
+    }
 
     SimpleBidirectionalPath(const SimpleBidirectionalPath&) = default;
     SimpleBidirectionalPath(SimpleBidirectionalPath&&) = default;
@@ -215,9 +219,13 @@ public:
     void PushBack(SimpleBidirectionalPath path, Gap gap = Gap()) {
         if (path.Empty())
             return;
+        edges_.reserve(Size() + path.Size());
+        gaps_.reserve(Size() + path.Size());
         gaps_.push_back(std::move(gap));
-        std::move(std::next(path.gaps_.begin()), path.gaps_.end(), std::back_inserter(gaps_));
-        std::move(path.edges_.begin(), path.edges_.end(), std::back_inserter(edges_));
+        for (size_t i = 1; i < path.Size(); ++i)
+            gaps_.push_back(std::move(path.gaps_[i]));
+        for (EdgeId e : path.edges_)
+            edges_.push_back(e);
     }
 
     void PushBack(const std::vector<EdgeId>& path, Gap gap = Gap()) {
@@ -225,7 +233,9 @@ public:
             return;
         gaps_.push_back(std::move(gap));
         gaps_.resize(gaps_.size() + path.size() - 1, Gap());
-        std::copy(path.begin(), path.end(), std::back_inserter(edges_));
+        edges_.reserve(Size() + path.size());
+        for (EdgeId e : path)
+            edges_.push_back(e);
     }
 
     void PopBack() noexcept {
@@ -259,15 +269,28 @@ public:
     }
 
     int FindFirst(EdgeId e) const noexcept {
-        auto pos = std::find(edges_.begin(), edges_.end(), e);
-        if (pos == edges_.end())
-            return -1;
-        return static_cast<int>(pos - edges_.begin());
+        int result = -1;
+        edges_.for_each_segment(0, Size(), [&](const EdgeId *edges, size_t count, size_t index) {
+            if (result != -1)
+                return;
+            const EdgeId *pos = std::find(edges, edges + count, e);
+            if (pos != edges + count)
+                result = static_cast<int>(index + (pos - edges));
+        });
+        return result;
     }
 
     int FindLast(EdgeId e) const noexcept {
-        auto pos = std::find(edges_.rbegin(), edges_.rend(), e);
-        return static_cast<int>(edges_.rend() - pos - 1);
+        int result = -1;
+        edges_.for_each_segment(0, Size(), [&](const EdgeId *edges, size_t count, size_t index) {
+            for (size_t i = count; i > 0; --i) {
+                if (edges[i - 1] == e) {
+                    result = static_cast<int>(index + i - 1);
+                    return;
+                }
+            }
+        });
+        return result;
     }
 
     bool Contains(EdgeId e) const noexcept {
@@ -277,10 +300,11 @@ public:
     std::vector<size_t> FindAll(EdgeId e, size_t start = 0) const {
         VERIFY(start < Size());
         std::vector<size_t> result;
-        for (size_t i = start; i < Size(); ++i) {
-            if (edges_[i] == e)
-                result.push_back(i);
-        }
+        edges_.for_each_segment(start, Size(), [&](const EdgeId *edges, size_t count, size_t index) {
+            for (const EdgeId *pos = std::find(edges, edges + count, e); pos != edges + count;
+                 pos = std::find(pos + 1, edges + count, e))
+                result.push_back(index + (pos - edges));
+        });
         return result;
     }
 
@@ -289,11 +313,12 @@ public:
         if (from + sample.Size() > Size())
             return false;
 
-        for (size_t i = 0; i < sample.Size(); ++i) {
-            if ((*this)[from + i] != sample[i])
-                return false;
-        }
-        return true;
+        bool equal = true;
+        edges_.for_each_segment(from, from + sample.Size(), [&](const EdgeId *edges, size_t count, size_t index) {
+            for (size_t i = 0; equal && i < count; ++i)
+                equal = (edges[i] == sample[index - from + i]);
+        });
+        return equal;
     }
 
     int FindFirst(const SimpleBidirectionalPath& path, size_t from = 0) const noexcept {
@@ -378,17 +403,22 @@ class BidirectionalPath : public PathListener, public SimpleBidirectionalPath {
 
     const debruijn_graph::Graph& g_;
     BidirectionalPath* conj_path_;
-    // Length from beginning of i-th edge to path end: L(e_i + gap_(i+1) + e_(i+1) + ... + gap_N + e_N)
-    std::deque<size_t> cumulative_len_;
+    // Positions of the edge starts and of the path end in some coordinate system that is fixed
+    // while the path is modified at either end, so that the length from the beginning of i-th edge
+    // to the path end L(e_i + gap_(i+1) + e_(i+1) + ... + gap_N + e_N) is end_pos_ - start_pos_[i]
+    // (all the arithmetic is modulo 2^64)
+    adt::ring_buffer<size_t> start_pos_;
+    size_t end_pos_;
     adt::SmallPODVector<PathListener*,
                         adt::impl::HybridAllocatedStorage<PathListener*, 2>> listeners_;
-    const uint64_t id_;  //Unique ID
+    uint64_t id_;  //Unique ID
     float weight_;
     int cycle_overlapping_; // in edges; [ < 0 ] => is not cycled
 
     BidirectionalPath(const debruijn_graph::Graph& g)
             : g_(g),
               conj_path_(nullptr),
+              end_pos_(0),
               id_(path_id_++),
               weight_(1.0),
               cycle_overlapping_(-1) {}
@@ -401,13 +431,12 @@ class BidirectionalPath : public PathListener, public SimpleBidirectionalPath {
     BidirectionalPath(const debruijn_graph::Graph& g, SimpleBidirectionalPath path)
             : BidirectionalPath(g)  {
         SimpleBidirectionalPath::PushBack(std::move(path));
-        cumulative_len_.resize(Size(), 0);
-
-        for (size_t i = 0; i < Size(); ++i)
-            cumulative_len_.front() += g_.length(edges_[i]) + gaps_[i].gap;
-
-        for (size_t i = 1; i < Size(); ++i)
-            cumulative_len_[i] = cumulative_len_[i - 1] - g_.length(edges_[i - 1]) - gaps_[i].gap;
+        start_pos_.reserve(Size());
+        for (size_t i = 0; i < Size(); ++i) {
+            end_pos_ += gaps_[i].gap;
+            start_pos_.push_back(end_pos_);
+            end_pos_ += g_.length(edges_[i]);
+        }
     }
 
     BidirectionalPath(const debruijn_graph::Graph& g, std::vector<EdgeId> path)
@@ -417,7 +446,8 @@ class BidirectionalPath : public PathListener, public SimpleBidirectionalPath {
             : SimpleBidirectionalPath(path),
               g_(path.g_),
               conj_path_(nullptr),
-              cumulative_len_(path.cumulative_len_),
+              start_pos_(path.start_pos_),
+              end_pos_(path.end_pos_),
               listeners_(),
               id_(path_id_++),
               weight_(path.weight_),
@@ -502,6 +532,10 @@ public:
         listeners_.push_back(&listener);
     }
 
+    void Unsubscribe(const PathListener &listener) {
+        listeners_.erase(std::remove(listeners_.begin(), listeners_.end(), &listener), listeners_.end());
+    }
+
     void SetConjPath(BidirectionalPath* path) noexcept {
         conj_path_ = path;
     }
@@ -556,7 +590,7 @@ public:
             return 0;
         }
         VERIFY(gaps_[0].gap == 0);
-        return cumulative_len_[0];
+        return LengthAt(0);
     }
 
     int ShiftLength(size_t index) const {
@@ -565,13 +599,18 @@ public:
 
     // Length from beginning of i-th edge to path end for forward directed path: L(e1 + e2 + ... + eN)
     size_t LengthAt(size_t index) const noexcept {
-        return cumulative_len_[index];
+        return end_pos_ - start_pos_[index];
     }
 
     size_t GetId() const noexcept {
         return id_;
     }
 
+    // Gives the path a new id, larger than the ones of all the paths created so far
+    void Renumber() noexcept {
+        id_ = path_id_++;
+    }
+
     bool IsCanonical() const {
         return id_ < this->conj_path_->GetId();
     }
@@ -583,7 +622,7 @@ public:
             ++cycle_overlapping_;
         }
         SimpleBidirectionalPath::PushBack(e, std::move(gap));
-        IncreaseLengths(g_.length(e), gaps_.back().gap);
+        AppendLength(g_.length(e), gaps_.back().gap);
         NotifyBackEdgeAdded(e, gaps_.back());
     }
 
@@ -608,7 +647,7 @@ public:
             return;
 
         EdgeId e = edges_.back();
-        DecreaseLengths();
+        TruncateLength();
         SimpleBidirectionalPath::PopBack();
         NotifyBackEdgeRemoved(e);
         DecreaseCycleOverlapping();
@@ -680,20 +719,15 @@ public:
 private:
     std::vector<std::string> PrintLines() const;
 
-    void IncreaseLengths(size_t length, int gap) {
-        for (auto iter = cumulative_len_.begin(); iter != cumulative_len_.end(); ++iter) {
-            *iter += length + gap;
-        }
-        cumulative_len_.push_back(length);
+    void AppendLength(size_t length, int gap) {
+        end_pos_ += gap;
+        start_pos_.push_back(end_pos_);
+        end_pos_ += length;
     }
 
-    void DecreaseLengths() {
-        size_t length = g_.length(edges_.back()) + gaps_.back().gap;
-
-        for (auto iter = cumulative_len_.begin(); iter != cumulative_len_.end(); ++iter) {
-            *iter -= length;
-        }
-        cumulative_len_.pop_back();
+    void TruncateLength() {
+        end_pos_ = start_pos_.back() - gaps_.back().gap;
+        start_pos_.pop_back();
     }
 
     void NotifyFrontEdgeAdded(EdgeId e, const Gap& gap) {
@@ -728,18 +762,18 @@ private:
 
         SimpleBidirectionalPath::PushFront(e, gap);
 
-        int length = (int) g_.length(e);
-        if (cumulative_len_.empty()) {
-            cumulative_len_.push_front(length);
+        size_t length = g_.length(e);
+        if (start_pos_.empty()) {
+            start_pos_.push_front(end_pos_ - length);
         } else {
-            cumulative_len_.push_front(cumulative_len_.front() + length + gap.gap);
+            start_pos_.push_front(start_pos_.front() - length - gap.gap);
         }
         NotifyFrontEdgeAdded(e, gap);
     }
 
     void PopFront() {
         EdgeId e = edges_.front();
-        cumulative_len_.pop_front();
+        start_pos_.pop_front();
         SimpleBidirectionalPath::PopFront();
 
         NotifyFrontEdgeRemoved(e);
@@ -753,7 +787,8 @@ private:
     DECL_LOGGER("BidirectionalPath");
 };
 
-inline int SkipOneGap(debruijn_graph::EdgeId end, const BidirectionalPath& path, int gap, int pos, bool forward) {
+template<class Path>
+inline int SkipOneGap(debruijn_graph::EdgeId end, const Path& path, int gap, int pos, bool forward) {
     size_t len = 0;
     while (pos < (int) path.Size() && pos >= 0 && end != path.At(pos) && (int) len < 2 * gap) {
         len += path.graph().length(path.At(pos));
@@ -765,8 +800,9 @@ inline int SkipOneGap(debruijn_graph::EdgeId end, const BidirectionalPath& path,
     return -1;
 }
 
-inline void SkipGaps(const BidirectionalPath &path1, size_t &cur_pos1, int gap1,
-                     const BidirectionalPath &path2, size_t &cur_pos2, int gap2,
+template<class Path1, class Path2>
+inline void SkipGaps(const Path1 &path1, size_t &cur_pos1, int gap1,
+                     const Path2 &path2, size_t &cur_pos2, int gap2,
                      bool use_gaps, bool forward) {
     if (use_gaps) {
         if (gap1 > 0 && gap2 <= 0) {
@@ -787,8 +823,10 @@ inline void SkipGaps(const BidirectionalPath &path1, size_t &cur_pos1, int gap1,
 
 
 //Try do ignore multiple loop traversals
-inline size_t FirstNotEqualPosition(const BidirectionalPath &path1, size_t pos1,
-                                    const BidirectionalPath &path2, size_t pos2,
+//Any path type providing Size(), At(), GapAt() and graph() might be compared, e.g. LongReadPath
+template<class Path1, class Path2>
+inline size_t FirstNotEqualPosition(const Path1 &path1, size_t pos1,
+                                    const Path2 &path2, size_t pos2,
                                     bool use_gaps) {
     int cur_pos1 = (int) pos1;
     int cur_pos2 = (int) pos2;
@@ -816,15 +854,17 @@ inline size_t FirstNotEqualPosition(const BidirectionalPath &path1, size_t pos1,
     return -1UL;
 }
 
-inline bool EqualBegins(const BidirectionalPath &path1, size_t pos1,
-                        const BidirectionalPath &path2, size_t pos2,
+template<class Path1, class Path2>
+inline bool EqualBegins(const Path1 &path1, size_t pos1,
+                        const Path2 &path2, size_t pos2,
                         bool use_gaps) {
     DEBUG("Checking for equal begins");
     return FirstNotEqualPosition(path1, pos1, path2, pos2, use_gaps) == -1UL;
 }
 
-inline size_t LastNotEqualPosition(const BidirectionalPath &path1, size_t pos1,
-                                   const BidirectionalPath &path2, size_t pos2,
+template<class Path1, class Path2>
+inline size_t LastNotEqualPosition(const Path1 &path1, size_t pos1,
+                                   const Path2 &path2, size_t pos2,
                                    bool use_gaps) {
     size_t cur_pos1 = pos1;
     size_t cur_pos2 = pos2;
@@ -842,8 +882,9 @@ inline size_t LastNotEqualPosition(const BidirectionalPath &path1, size_t pos1,
     return -1UL;
 }
 
-inline bool EqualEnds(const BidirectionalPath &path1, size_t pos1,
-                      const BidirectionalPath &path2, size_t pos2,
+template<class Path1, class Path2>
+inline bool EqualEnds(const Path1 &path1, size_t pos1,
+                      const Path2 &path2, size_t pos2,
                       bool use_gaps) {
     return LastNotEqualPosition(path1, pos1, path2, pos2, use_gaps) == -1UL;
 }
@@ -125,6 +125,15 @@ public:
         return LinkPair({ *entry.first, *entry.second });
     }
 
+    // Takes over the (already linked) index-th pair of another container, leaving an empty slot there
+    std::pair<BidirectionalPath&, BidirectionalPath&>
+    Acquire(PathContainer &other, size_t index) {
+        data_.push_back(std::move(other.data_[index]));
+        auto &entry = data_.back();
+
+        return { *entry.first, *entry.second };
+    }
+
     std::pair<BidirectionalPath&, BidirectionalPath&>
     Add(std::unique_ptr<BidirectionalPath> p) {
         auto cp = (p->GetConjPath() ?
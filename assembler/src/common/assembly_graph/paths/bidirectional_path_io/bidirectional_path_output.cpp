@@ -6,6 +6,8 @@
 
 #include "bidirectional_path_output.hpp"
 
+#include "utils/parallel/openmp_wrapper.h"
+
 namespace path_extend {
 
 void path_extend::ContigWriter::OutputPaths(const PathContainer &paths, const std::vector<PathsWriterT> &writers) const {
@@ -13,17 +15,26 @@ void path_extend::ContigWriter::OutputPaths(const PathContainer &paths, const st
 
     ScaffoldSequenceMaker scaffold_maker(g_);
     DEBUG("started" << paths.size());
+    std::vector<const BidirectionalPath*> nonempty;
     for (auto iter = paths.begin(); iter != paths.end(); ++iter) {
         const BidirectionalPath &path = iter.get();
         DEBUG("path: " <<  path.Length());
         if (path.Length() <= 0)
             continue;
-        auto path_string = scaffold_maker.MakeSequence(path);
-        if (path_string.length() >= g_.k()) {
-            storage.emplace_back(path_string, &path);
-        }
-        DEBUG("over");
+        nonempty.push_back(&path);
+    }
+
+    // Scaffold sequences are formed concurrently, but kept in the order of paths
+    std::vector<std::string> sequences(nonempty.size());
+#   pragma omp parallel for schedule(guided)
+    for (size_t i = 0; i < nonempty.size(); ++i)
+        sequences[i] = scaffold_maker.MakeSequence(*nonempty[i]);
+
+    for (size_t i = 0; i < nonempty.size(); ++i) {
+        if (sequences[i].length() >= g_.k())
+            storage.emplace_back(std::move(sequences[i]), nonempty[i]);
     }
+    DEBUG("over");
     DEBUG("sort");
     //sorting by length and coverage
     std::sort(storage.begin(), storage.end(), [] (const ScaffoldInfo &a, const ScaffoldInfo &b) {
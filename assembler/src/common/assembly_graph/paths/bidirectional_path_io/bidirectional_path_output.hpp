@@ -10,6 +10,8 @@
 #include "io/utils/edge_namer.hpp"
 #include "io/graph/gfa_writer.hpp"
 #include "io/graph/fastg_writer.hpp"
+#include "io/reads/osequencestream.hpp"
+#include "io/utils/ordered_writer.hpp"
 #include "io_support.hpp"
 
 namespace path_extend {
@@ -54,12 +56,12 @@ public:
 
     void WritePaths(const ScaffoldStorage &scaffold_storage, const std::string &fn) const {
         std::ofstream os(fn);
-        for (const auto& scaffold_info : scaffold_storage) {
-            os << scaffold_info.name << "\n"
-               << path_writer_.ToPathString(*scaffold_info.path) << "\n"
-               << scaffold_info.name << "'" << "\n"
-               << path_writer_.ToPathString(*scaffold_info.path->GetConjPath()) << "\n";
-        }
+        io::WriteOrdered(os, scaffold_storage, [&](std::string &out, const ScaffoldInfo &scaffold_info) {
+            out += scaffold_info.name + "\n"
+                   + path_writer_.ToPathString(*scaffold_info.path) + "\n"
+                   + scaffold_info.name + "'" + "\n"
+                   + path_writer_.ToPathString(*scaffold_info.path->GetConjPath()) + "\n";
+        });
     }
 
   private:
@@ -68,20 +70,28 @@ public:
 
 
 class GFAPathWriter : public gfa::GFAWriter {
-    void WritePath(const std::string &name, size_t segment_id,
-                   const std::vector<std::string> &edge_strs,
-                   const std::string &flags) {
-        os_ << "P" << "\t" ;
-        os_ << name << "_" << segment_id << "\t";
+    static void WritePath(const std::string &name, size_t segment_id,
+                          const std::vector<std::string> &edge_strs,
+                          const std::string &flags, std::string &out) {
+        out += "P\t";
+        out += name + "_" + std::to_string(segment_id) + "\t";
         std::string delimeter = "";
         for (const auto& e : edge_strs) {
-            os_ << delimeter << e;
+            out += delimeter + e;
             delimeter = ",";
         }
-        os_ << "\t*";
+        out += "\t*";
         if (flags.length())
-            os_ << "\t" << flags;
-        os_ << "\n";
+            out += "\t" + flags;
+        out += "\n";
+    }
+
+    void WritePath(const std::string &name, size_t segment_id,
+                   const std::vector<std::string> &edge_strs,
+                   const std::string &flags) {
+        std::string out;
+        WritePath(name, segment_id, edge_strs, flags, out);
+        os_ << out;
     }
 
 public:
@@ -107,10 +117,10 @@ public:
     }
 
     void WritePaths(const ScaffoldStorage &scaffold_storage) {
-        for (const auto& scaffold_info : scaffold_storage) {
+        io::WriteOrdered(os_, scaffold_storage, [&](std::string &out, const ScaffoldInfo &scaffold_info) {
             const path_extend::BidirectionalPath &p = *scaffold_info.path;
             if (p.Size() == 0) {
-                continue;
+                return;
             }
             std::vector<std::string> segmented_path;
             //size_t id = p.GetId();
@@ -119,15 +129,15 @@ public:
                 EdgeId e = p[i];
                 segmented_path.push_back(edge_namer_.EdgeOrientationString(e));
                 if (graph_.EdgeEnd(e) != graph_.EdgeStart(p[i+1]) || p.GapAt(i+1).gap > 0) {
-                    WritePath(scaffold_info.name, segment_id, segmented_path, "");
+                    WritePath(scaffold_info.name, segment_id, segmented_path, "", out);
                     segment_id++;
                     segmented_path.clear();
                 }
             }
 
             segmented_path.push_back(edge_namer_.EdgeOrientationString(p.Back()));
-            WritePath(scaffold_info.name, segment_id, segmented_path, "");
-        }
+            WritePath(scaffold_info.name, segment_id, segmented_path, "", out);
+        });
     }
 };
 
@@ -139,13 +149,11 @@ class ContigWriter {
 
 public:
     static void WriteScaffolds(const ScaffoldStorage &scaffold_storage, const std::string &fn) {
-        io::OFastaReadStream oss(fn);
-        std::ofstream os_fastg;
-
-        for (const auto& scaffold_info : scaffold_storage) {
+        std::ofstream os(fn);
+        io::WriteOrdered(os, scaffold_storage, [](std::string &out, const ScaffoldInfo &scaffold_info) {
             TRACE("Scaffold " << scaffold_info.name << " originates from path " << scaffold_info.path->str());
-            oss << io::SingleRead(scaffold_info.name, scaffold_info.sequence);
-        }
+            io::AppendFasta(scaffold_info.name, scaffold_info.sequence, out);
+        });
     }
 
     static PathsWriterT BasicFastaWriter(const std::string &fn) {
@@ -22,8 +22,8 @@ struct ScaffoldInfo {
     const BidirectionalPath* path;
     std::string name;
 
-    ScaffoldInfo(const std::string& sequence, const BidirectionalPath* path) :
-        sequence(sequence), path(path) { }
+    ScaffoldInfo(std::string sequence, const BidirectionalPath* path) :
+        sequence(std::move(sequence)), path(path) { }
 
     size_t length() const {
         return sequence.length();
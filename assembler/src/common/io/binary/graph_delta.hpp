@@ -0,0 +1,152 @@
+//***************************************************************************
+//* Copyright (c) 2021 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#pragma once
+
+#include "graph.hpp"
+
+#include "assembly_graph/handlers/graph_journal.hpp"
+
+#include <fstream>
+#include <sstream>
+
+namespace io {
+
+namespace binary {
+
+/**
+ * @brief  This IOer stores the graph as the difference against the graph of an
+ *         earlier (base) save, as recorded by omnigraph::GraphJournal. The base
+ *         is referred by the name of its directory, which is a sibling of the
+ *         delta one. The table of contents of the base is kept in the delta, so
+ *         the base overwritten since is not silently used.
+ */
+template<typename Graph>
+class GraphDeltaIO {
+    typedef typename Graph::VertexId VertexId;
+    typedef typename Graph::EdgeId EdgeId;
+    typedef omnigraph::GraphJournal<Graph> Journal;
+
+public:
+    static bool Exists(const std::string &basename) {
+        return fs::FileExists(basename + ".grdelta");
+    }
+
+    /// <saves>/<base_name>/graph_pack for <saves>/<stage>/graph_pack
+    static std::string BasePath(const std::string &basename, const std::string &base_name) {
+        return fs::append_path(fs::append_path(fs::parent_path(fs::parent_path(basename)), base_name),
+                               fs::filename(basename));
+    }
+
+    void Save(const std::string &basename, const Graph &graph, const Journal &journal) {
+        std::string filename = basename + ".grdelta";
+        std::ofstream file(filename, std::ios::binary);
+        DEBUG("Saving debruijn graph delta into " << filename);
+        VERIFY(file);
+        BinOStream str(file);
+
+        VERIFY(journal.has_base());
+        str << journal.base_name() << Contents(BasePath(basename, journal.base_name()));
+        str << graph.vreserved() << graph.ereserved();
+
+        str << journal.removed_vertices().size();
+        for (VertexId v : journal.removed_vertices())
+            str << v.int_id();
+
+        str << journal.removed_edges().size();
+        for (EdgeId e : journal.removed_edges())
+            str << e.int_id();
+
+        // The journal keeps a single id of each conjugate pair
+        str << journal.added_vertices().size();
+        for (VertexId v : journal.added_vertices())
+            str << v.int_id() << graph.conjugate(v).int_id();
+
+        str << journal.added_edges().size();
+        for (EdgeId e : journal.added_edges()) {
+            str << e.int_id() << graph.conjugate(e).int_id()
+                << graph.EdgeStart(e).int_id() << graph.EdgeEnd(e).int_id()
+                << graph.EdgeNucls(e);
+        }
+    }
+
+    /**
+     * @brief  Loads the graph structure of the base and replays the delta over it.
+     *         Edge coverage is not the part of the delta.
+     */
+    void Load(const std::string &basename, Graph &graph) {
+        std::string filename = basename + ".grdelta";
+        auto file = fs::open_file(filename, std::ios::binary);
+        DEBUG("Loading debruijn graph delta from " << filename);
+        BinIStream str(file);
+
+        std::string base_name, contents;
+        str >> base_name >> contents;
+        std::string base = BasePath(basename, base_name);
+        CHECK_FATAL_ERROR(Contents(base) == contents,
+                          "The base save " << base << " of " << filename << " was changed or removed");
+
+        INFO("Loading the base graph from " << base);
+        GraphIO<Graph> base_io;
+        CHECK_FATAL_ERROR(base_io.Load(base, graph), "Failed to load the base graph from " << base);
+
+        uint64_t max_vid, max_eid;
+        str >> max_vid >> max_eid;
+        graph.reserve(max_vid, max_eid);
+
+        size_t cnt;
+        str >> cnt;
+        std::vector<uint64_t> removed_vertices(cnt);
+        for (auto &id : removed_vertices)
+            str >> id;
+
+        // Vertices are removed only when all their edges are gone
+        str >> cnt;
+        for (size_t i = 0; i < cnt; ++i) {
+            uint64_t id;
+            str >> id;
+            if (graph.contains(EdgeId(id)))
+                graph.DeleteEdge(EdgeId(id));
+        }
+        for (uint64_t id : removed_vertices) {
+            if (graph.contains(VertexId(id)))
+                graph.DeleteVertex(VertexId(id));
+        }
+
+        str >> cnt;
+        for (size_t i = 0; i < cnt; ++i) {
+            uint64_t ids[2];
+            str >> ids;
+            auto new_id = graph.AddVertex(typename Graph::VertexData(), ids[0], ids[1]);
+            VERIFY_MSG(new_id == ids[0], "Vertex " << ids[0] << " was restored as " << new_id.int_id());
+        }
+
+        str >> cnt;
+        for (size_t i = 0; i < cnt; ++i) {
+            uint64_t edge_ids[2], start, end;
+            Sequence seq;
+            str >> edge_ids >> start >> end >> seq;
+            auto new_id = graph.AddEdge(start, end, typename Graph::EdgeData(seq), edge_ids[0], edge_ids[1]);
+            VERIFY_MSG(new_id == edge_ids[0] && graph.conjugate(new_id) == edge_ids[1],
+                       "Edge " << edge_ids[0] << " was restored as " << new_id.int_id());
+        }
+    }
+
+private:
+    static std::string Contents(const std::string &basename) {
+        std::ifstream is(basename + ".toc");
+        CHECK_FATAL_ERROR(is.good(), "No table of contents found for the base save " << basename);
+        std::stringstream ss;
+        ss << is.rdbuf();
+        return ss.str();
+    }
+
+    DECL_LOGGER("GraphDeltaIO");
+};
+
+} // namespace binary
+
+} // namespace io
@@ -10,6 +10,7 @@
 #include "coverage.hpp"
 #include "edge_index.hpp"
 #include "genomic_info.hpp"
+#include "graph_delta.hpp"
 #include "kmer_mapper.hpp"
 #include "long_reads.hpp"
 #include "ss_coverage.hpp"
@@ -17,6 +18,18 @@
 #include "positions.hpp"
 #include "trusted_paths.hpp"
 
+#include "utils/filesystem/glob.hpp"
+#include "utils/parallel/openmp_wrapper.h"
+
+#include "threadpool/threadpool.hpp"
+
+#define XXH_INLINE_ALL
+#include "xxh/xxhash.h"
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+
 namespace io {
 
 namespace binary {
@@ -26,11 +39,13 @@ namespace {
 class Saver {
     const std::string &basename;
     const BasePackIO::Type &gp;
+    ComponentTasks &tasks;
     std::ofstream infoStream;
 public:
-    Saver(const std::string &basename, const BasePackIO::Type &gp)
+    Saver(const std::string &basename, const BasePackIO::Type &gp, ComponentTasks &tasks)
         : basename(basename)
         , gp(gp)
+        , tasks(tasks)
         , infoStream(basename + ".att")
     {}
 
@@ -43,8 +58,10 @@ public:
         const auto &component = gp.get<T>();
         io::binary::BinWrite<char>(infoStream, component.IsAttached());
         if (component.IsAttached()) {
-            typename IOTraits<T>::Type io;
-            io.Save(basename, component); 
+            tasks.Run([basename = basename, &component] {
+                typename IOTraits<T>::Type io;
+                io.Save(basename, component);
+            });
         }
     }
 };
@@ -76,16 +93,19 @@ public:
 class Loader {
     const std::string &basename;
     BasePackIO::Type &gp;
+    ComponentTasks &tasks;
     std::ifstream infoStream;
 public:
-    Loader(const std::string &basename, BasePackIO::Type &gp)
+    Loader(const std::string &basename, BasePackIO::Type &gp, ComponentTasks &tasks)
         : basename(basename)
         , gp(gp)
+        , tasks(tasks)
         , infoStream(fs::open_file(basename + ".att", std::ios::binary))
     {}
 
     /**
      * @brief  Restores the attachment flag of the component. Then loads it only if it was attached.
+     *         The component is attached back only after all the components are loaded.
      */
     template<class T>
     void Load() {
@@ -97,10 +117,12 @@ public:
         auto &component = gp.get_mutable<T>();
         if (component.IsAttached())
             component.Detach();
-        typename IOTraits<T>::Type io;
-        bool loaded = io.Load(basename, component);
-        VERIFY(loaded);
-        component.Attach();
+        tasks.Run([basename = basename, &component] {
+                      typename IOTraits<T>::Type io;
+                      bool loaded = io.Load(basename, component);
+                      VERIFY(loaded);
+                  },
+                  [&component] { component.Attach(); });
     }
 };
 
@@ -137,18 +159,105 @@ public:
  * @brief  Saves the component.
  */
 template<typename T>
-void SaveComponent(const std::string &basename, const BasePackIO::Type &gp, const std::string &name = "") {
+void SaveComponent(const std::string &basename, const BasePackIO::Type &gp, ComponentTasks &tasks,
+                   const std::string &name = "") {
     const auto &component = gp.get<T>(name);
-    io::binary::Save(basename, component);
+    tasks.Run([basename, &component] { io::binary::Save(basename, component); });
 }
 
 /**
  * @brief  Loads an arbitrary component.
  */
 template<typename T>
-void LoadComponent(const std::string &basename, BasePackIO::Type &gp, const std::string &name = "") {
+void LoadComponent(const std::string &basename, BasePackIO::Type &gp, ComponentTasks &tasks,
+                   const std::string &name = "") {
     auto &component = gp.get_mutable<T>(name);
-    io::binary::Load(basename, component);
+    tasks.Run([basename, &component] { io::binary::Load(basename, component); });
+}
+
+uint64_t FileChecksum(const std::string &filename) {
+    std::ifstream is(filename, std::ios::binary);
+    VERIFY_MSG(is.good(), "Cannot read " << filename);
+    XXH3_state_t state;
+    XXH3_64bits_reset(&state);
+    std::vector<char> buf(1 << 20);
+    while (is) {
+        is.read(buf.data(), buf.size());
+        XXH3_64bits_update(&state, buf.data(), is.gcount());
+    }
+    VERIFY_MSG(is.eof(), "Cannot read " << filename);
+    return XXH3_64bits_digest(&state);
+}
+
+struct ContentsEntry {
+    size_t size;
+    // Zero for the saves made before the checksums were recorded
+    uint64_t checksum;
+};
+
+typedef std::map<std::string, ContentsEntry> Contents;
+
+/**
+ * @brief  Lists all the files of the saved pack with their sizes and checksums.
+ *         Written last, so its presence also marks the save as complete.
+ *         The files are checksummed right after being written, while they are
+ *         still cached, so the following incremental saves could find out the
+ *         unchanged ones without reading this save again.
+ */
+Contents WriteContents(const std::string &basename) {
+    std::string toc = basename + ".toc";
+    fs::remove_if_exists(toc);
+    std::vector<std::string> files;
+    for (const auto &file : fs::glob(basename + "*")) {
+        if (file.back() != '/')
+            files.push_back(file);
+    }
+    std::sort(files.begin(), files.end());
+
+    std::vector<ContentsEntry> entries(files.size());
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t i = 0; i < files.size(); ++i)
+        entries[i] = { fs::filesize(files[i]), FileChecksum(files[i]) };
+
+    Contents contents;
+    std::ofstream os(toc);
+    for (size_t i = 0; i < files.size(); ++i) {
+        std::string name = fs::filename(files[i]);
+        os << name << ' ' << entries[i].size << ' ' << std::hex << entries[i].checksum << std::dec << '\n';
+        contents.emplace(name, entries[i]);
+    }
+    VERIFY_MSG(os.good(), "Failed to write " << toc);
+    return contents;
+}
+
+Contents ReadContents(std::istream &is) {
+    Contents contents;
+    std::string line;
+    while (std::getline(is, line)) {
+        std::istringstream ss(line);
+        std::string name;
+        ContentsEntry entry = { 0, 0 };
+        if (!(ss >> name >> entry.size))
+            continue;
+        ss >> std::hex >> entry.checksum;
+        contents.emplace(name, entry);
+    }
+    return contents;
+}
+
+void CheckContents(const std::string &basename) {
+    std::ifstream is(basename + ".toc");
+    if (!is.good()) {
+        WARN("No table of contents found for " << basename << ", the save might be incomplete");
+        return;
+    }
+
+    std::string dir = basename.substr(0, basename.size() - fs::filename(basename).size());
+    for (const auto &entry : ReadContents(is)) {
+        std::string file = dir + entry.first;
+        CHECK_FATAL_ERROR(fs::FileExists(file) && fs::filesize(file) == entry.second.size,
+                          "File " << file << " is missing or truncated, the save is incomplete");
+    }
 }
 
 /**
@@ -171,8 +280,67 @@ void BinReadComponent(std::istream &is, BasePackIO::Type &gp, const std::string
 
 } // namespace
 
+ComponentTasks::ComponentTasks(unsigned nthreads) {
+    if (nthreads > 1)
+        pool_ = std::make_unique<ThreadPool::ThreadPool>(nthreads);
+}
+
+ComponentTasks::~ComponentTasks() = default;
+
+void ComponentTasks::Run(std::function<void()> task, std::function<void()> finalizer) {
+    if (pool_)
+        tasks_.push_back(pool_->run(std::move(task)));
+    else
+        task();
+
+    if (finalizer)
+        finalizers_.push_back(std::move(finalizer));
+}
+
+void ComponentTasks::Wait() {
+    for (auto &task : tasks_)
+        task.get();
+    tasks_.clear();
+
+    for (auto &finalizer : finalizers_)
+        finalizer();
+    finalizers_.clear();
+}
+
 void BasePackIO::Save(const std::string &basename, const Type &gp) {
-    Saver saver(basename, gp);
+    ComponentTasks tasks(omp_get_max_threads());
+    SaveComponents(basename, gp, tasks);
+    tasks.Wait();
+
+    WriteContents(basename);
+}
+
+bool BasePackIO::Load(const std::string &basename, Type &gp) {
+    CheckContents(basename);
+
+    //1. Load basic graph with coverage, all the rest depends on it
+    auto &g = gp.get_mutable<Graph>();
+    if (GraphDeltaIO<Graph>::Exists(basename)) {
+        GraphDeltaIO<Graph>().Load(basename, g);
+        CHECK_FATAL_ERROR(io::binary::Load(basename, g.coverage_index()),
+                          "Failed to load the edge coverage of " << basename);
+    } else {
+        graph_io_.Load(basename, g);
+    }
+
+    ComponentTasks tasks(omp_get_max_threads());
+    LoadComponents(basename, gp, tasks);
+    tasks.Wait();
+
+    return true;
+}
+
+void BasePackIO::SaveGraph(const std::string &basename, const Graph &g) {
+    graph_io_.Save(basename, g);
+}
+
+void BasePackIO::SaveComponents(const std::string &basename, const Type &gp, ComponentTasks &tasks) {
+    Saver saver(basename, gp, tasks);
 
     using namespace omnigraph;
     using namespace debruijn_graph;
@@ -180,7 +348,7 @@ void BasePackIO::Save(const std::string &basename, const Type &gp) {
     if (gp.invalidated<Graph>()) {
         //1. Save basic graph with coverage
         const auto &g = gp.get<Graph>();
-        graph_io_.Save(basename, g);
+        tasks.Run([this, basename, &g] { SaveGraph(basename, g); });
     }
 
     //2. Save edge positions
@@ -196,16 +364,12 @@ void BasePackIO::Save(const std::string &basename, const Type &gp) {
     saver.Save<FlankingCoverage<Graph>>();
 }
 
-bool BasePackIO::Load(const std::string &basename, Type &gp) {
-    Loader loader(basename, gp);
+void BasePackIO::LoadComponents(const std::string &basename, Type &gp, ComponentTasks &tasks) {
+    Loader loader(basename, gp, tasks);
 
     using namespace omnigraph;
     using namespace debruijn_graph;
 
-    //1. Load basic graph with coverage
-    auto &g = gp.get_mutable<Graph>();
-    graph_io_.Load(basename, g);
-
     //2. Load edge positions
     loader.Load<EdgesPositionHandler<Graph>>();
 
@@ -217,8 +381,6 @@ bool BasePackIO::Load(const std::string &basename, Type &gp) {
 
     //5. Load flanking coverage
     loader.Load<FlankingCoverage<Graph>>();
-
-    return true;
 }
 
 void BasePackIO::BinWrite(std::ostream &os, const Type &gp)  {
@@ -267,65 +429,95 @@ bool BasePackIO::BinRead(std::istream &is, Type &gp) {
     return true;
 }
 
-void FullPackIO::Save(const std::string &basename, const Type &gp) {
+void FullPackIO::SaveComponents(const std::string &basename, const Type &gp, ComponentTasks &tasks) {
     using namespace omnigraph::de;
     using namespace debruijn_graph;
 
     //1. Save basic graph pack
-    base::Save(basename, gp);
+    base::SaveComponents(basename, gp, tasks);
 
     //2. Save unclustered paired indices
-    SaveComponent<UnclusteredPairedInfoIndicesT<Graph>>(basename, gp);
+    SaveComponent<UnclusteredPairedInfoIndicesT<Graph>>(basename, gp, tasks);
 
     //3. Save clustered indices
-    SaveComponent<PairedInfoIndicesT<Graph>>(basename + "_cl", gp, "clustered_indices");
+    SaveComponent<PairedInfoIndicesT<Graph>>(basename + "_cl", gp, tasks, "clustered_indices");
 
     //4. Save scaffolding indices
-    SaveComponent<PairedInfoIndicesT<Graph>>(basename + "_scf", gp, "scaffolding_indices");
+    SaveComponent<PairedInfoIndicesT<Graph>>(basename + "_scf", gp, tasks, "scaffolding_indices");
 
     //5. Save long reads
-    SaveComponent<LongReadContainer<Graph>>(basename, gp);
+    SaveComponent<LongReadContainer<Graph>>(basename, gp, tasks);
 
     //6. Save genomic info
-    SaveComponent<GenomicInfo>(basename, gp);
+    SaveComponent<GenomicInfo>(basename, gp, tasks);
 
     //7. Save SS coverage
-    SaveComponent<SSCoverageContainer>(basename, gp);
+    SaveComponent<SSCoverageContainer>(basename, gp, tasks);
 
     //8. Save trusted paths
-    SaveComponent<path_extend::TrustedPathsContainer>(basename, gp);
+    SaveComponent<path_extend::TrustedPathsContainer>(basename, gp, tasks);
 }
 
-bool FullPackIO::Load(const std::string &basename, Type &gp) {
+void FullPackIO::LoadComponents(const std::string &basename, Type &gp, ComponentTasks &tasks) {
     using namespace omnigraph::de;
     using namespace debruijn_graph;
 
     //1. Load basic graph pack
-    base::Load(basename, gp);
+    base::LoadComponents(basename, gp, tasks);
 
     //2. Load paired indices
-    using namespace omnigraph::de;
-    LoadComponent<UnclusteredPairedInfoIndicesT<Graph>>(basename, gp);
+    LoadComponent<UnclusteredPairedInfoIndicesT<Graph>>(basename, gp, tasks);
 
     //3. Load clustered indices
-    LoadComponent<PairedInfoIndicesT<Graph>>(basename + "_cl", gp, "clustered_indices");
+    LoadComponent<PairedInfoIndicesT<Graph>>(basename + "_cl", gp, tasks, "clustered_indices");
 
     //4. Load scaffolding indices
-    LoadComponent<PairedInfoIndicesT<Graph>>(basename + "_scf", gp, "scaffolding_indices");
+    LoadComponent<PairedInfoIndicesT<Graph>>(basename + "_scf", gp, tasks, "scaffolding_indices");
 
     //5. Load long reads
-    LoadComponent<LongReadContainer<Graph>>(basename, gp);
+    LoadComponent<LongReadContainer<Graph>>(basename, gp, tasks);
 
     //6. Load genomic info
-    LoadComponent<GenomicInfo>(basename, gp);
+    LoadComponent<GenomicInfo>(basename, gp, tasks);
 
     //7. Load SS coverage
-    LoadComponent<SSCoverageContainer>(basename, gp);
+    LoadComponent<SSCoverageContainer>(basename, gp, tasks);
 
     //8. Load trusted paths
-    LoadComponent<path_extend::TrustedPathsContainer>(basename, gp);
+    LoadComponent<path_extend::TrustedPathsContainer>(basename, gp, tasks);
+}
 
-    return true;
+void IncrementalPackIO::Save(const std::string &basename, const Type &gp) {
+    ComponentTasks tasks(omp_get_max_threads());
+    SaveComponents(basename, gp, tasks);
+    tasks.Wait();
+    Contents contents = WriteContents(basename);
+
+    // The files are compared by the sizes and checksums recorded in the
+    // tables of contents, so the base save is not read again
+    std::string base_pack = GraphDeltaIO<Graph>::BasePath(basename, journal_.base_name());
+    std::string base_dir = fs::parent_path(base_pack);
+    std::ifstream base_toc(base_pack + ".toc");
+    Contents base_contents = ReadContents(base_toc);
+    size_t shared = 0;
+    for (const auto &entry : contents) {
+        auto base_entry = base_contents.find(entry.first);
+        if (base_entry == base_contents.end() || !base_entry->second.checksum ||
+            base_entry->second.size != entry.second.size ||
+            base_entry->second.checksum != entry.second.checksum)
+            continue;
+        fs::link_or_copy(fs::append_path(base_dir, entry.first),
+                         fs::append_path(fs::parent_path(basename), entry.first));
+        shared += 1;
+    }
+    INFO("Graph saved as " << journal_.added_edges().size() << " added and "
+         << journal_.removed_edges().size() << " removed edges against " << base_pack
+         << ", " << shared << " unchanged files shared");
+}
+
+void IncrementalPackIO::SaveGraph(const std::string &basename, const Graph &g) {
+    GraphDeltaIO<Graph>().Save(basename, g, journal_);
+    io::binary::Save(basename, g.coverage_index());
 }
 
 void FullPackIO::BinWrite(std::ostream &os, const Type &gp) {
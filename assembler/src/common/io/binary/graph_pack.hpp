@@ -9,12 +9,45 @@
 #include "basic.hpp"
 #include "pipeline/graph_pack.hpp"
 
+#include "assembly_graph/handlers/graph_journal.hpp"
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace ThreadPool {
+class ThreadPool;
+}
+
 namespace io {
 
 namespace binary {
 
+/**
+ * @brief  Runs the saving / loading of independent components concurrently.
+ *         The finalizers are run sequentially by Wait() after all the tasks are done.
+ */
+class ComponentTasks {
+public:
+    explicit ComponentTasks(unsigned nthreads);
+    ~ComponentTasks();
+
+    void Run(std::function<void()> task, std::function<void()> finalizer = nullptr);
+    void Wait();
+
+private:
+    std::unique_ptr<ThreadPool::ThreadPool> pool_;
+    std::vector<std::future<void>> tasks_;
+    std::vector<std::function<void()>> finalizers_;
+};
+
 /**
  * @brief  This IOer processes the graph pack including only graph-related components.
+ *         Every component is kept in its own files, so they are saved and loaded
+ *         concurrently. The table of contents (.toc) listing all the files with
+ *         their sizes and checksums is written after everything else and is
+ *         checked on load.
  */
 class BasePackIO : public IOBase<debruijn_graph::GraphPack> {
 public:
@@ -30,6 +63,12 @@ public:
     virtual bool BinRead(std::istream &is, Type &gp);
 
 protected:
+    virtual void SaveGraph(const std::string &basename, const Graph &g);
+
+    virtual void SaveComponents(const std::string &basename, const Type &gp, ComponentTasks &tasks);
+
+    virtual void LoadComponents(const std::string &basename, Type &gp, ComponentTasks &tasks);
+
     BasicGraphIO<Graph> graph_io_;
 };
 
@@ -40,13 +79,38 @@ class FullPackIO : public BasePackIO {
 public:
     typedef BasePackIO base;
     typedef typename debruijn_graph::GraphPack Type;
-    void Save(const std::string &basename, const Type &gp) override;
-
-    bool Load(const std::string &basename, Type &gp) override;
 
     void BinWrite(std::ostream &os, const Type &gp) override;
 
     bool BinRead(std::istream &is, Type &gp) override;
+
+protected:
+    void SaveComponents(const std::string &basename, const Type &gp, ComponentTasks &tasks) override;
+
+    void LoadComponents(const std::string &basename, Type &gp, ComponentTasks &tasks) override;
+};
+
+/**
+ * @brief  This IOer processes all of the graph pack components, but the graph is
+ *         saved as the difference against the base save recorded by the journal.
+ *         The component files with the same sizes and checksums as the ones of
+ *         the base are shared with it via hard links. The saves of both kinds are
+ *         loaded by BasePackIO.
+ */
+class IncrementalPackIO : public FullPackIO {
+public:
+    typedef omnigraph::GraphJournal<Graph> Journal;
+
+    explicit IncrementalPackIO(const Journal &journal)
+            : journal_(journal) {}
+
+    void Save(const std::string &basename, const Type &gp) override;
+
+protected:
+    void SaveGraph(const std::string &basename, const Graph &g) override;
+
+private:
+    const Journal &journal_;
 };
 
 } // namespace binary
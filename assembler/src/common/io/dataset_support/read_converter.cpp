@@ -160,15 +160,22 @@ BinaryPairedStreams paired_binary_readers(SequencingLibraryT &lib,
     ReadStreamList<PairedReadSeq> paired_streams;
     const size_t n = data.binary_reads_info.chunk_num;
 
+    // The streams share the mapped files and interleave their blocks, so a
+    // run of slow reads in the file is split between all of them
+    auto paired_chunks = std::make_shared<BinaryReadBlocks>(data.binary_reads_info.paired_read_prefix);
+    std::shared_ptr<BinaryReadBlocks> merged_chunks;
+    if (include_merged) {
+        VERIFY(lib.data().unmerged_read_length != 0);
+        merged_chunks = std::make_shared<BinaryReadBlocks>(data.binary_reads_info.merged_read_prefix);
+    }
+
     for (size_t i = 0; i < n; ++i) {
-        ReadStream<PairedReadSeq> stream{BinaryFilePairedStream(data.binary_reads_info.paired_read_prefix,
-                                                                   insert_size, n, i)};
+        ReadStream<PairedReadSeq> stream{BinaryFilePairedStream(paired_chunks, insert_size, i, n)};
         if (include_merged) {
-            VERIFY(lib.data().unmerged_read_length != 0);
             stream = MultifileWrap<PairedReadSeq>(std::move(stream),
-                                                  BinaryUnmergingPairedStream(data.binary_reads_info.merged_read_prefix,
+                                                  BinaryUnmergingPairedStream(merged_chunks,
                                                                               insert_size, lib.data().unmerged_read_length,
-                                                                              n, i));
+                                                                              i, n));
         }
 
         paired_streams.push_back(std::move(stream));
@@ -190,21 +197,21 @@ BinarySingleStreams single_binary_readers(SequencingLibraryT &lib,
     BinarySingleStreams single_streams;
     const size_t n = data.binary_reads_info.chunk_num;
 
+    auto single_chunks = std::make_shared<BinaryReadBlocks>(data.binary_reads_info.single_read_prefix);
     for (size_t i = 0; i < n; ++i)
-        single_streams.push_back(BinaryFileSingleStream(data.binary_reads_info.single_read_prefix,
-                                                        n, i));
+        single_streams.push_back(BinaryFileSingleStream(single_chunks, i, n));
 
     if (including_paired_and_merged) {
         BinarySingleStreams merged_streams;
+        auto merged_chunks = std::make_shared<BinaryReadBlocks>(data.binary_reads_info.merged_read_prefix);
         for (size_t i = 0; i < n; ++i)
-            merged_streams.push_back(BinaryFileSingleStream(data.binary_reads_info.merged_read_prefix,
-                                                            n, i));
+            merged_streams.push_back(BinaryFileSingleStream(merged_chunks, i, n));
         single_streams = WrapPairsInMultifiles<SingleReadSeq>(std::move(single_streams), std::move(merged_streams));
 
         BinaryPairedStreams paired_streams;
+        auto paired_chunks = std::make_shared<BinaryReadBlocks>(data.binary_reads_info.paired_read_prefix);
         for (size_t i = 0; i < n; ++i)
-            paired_streams.push_back(BinaryFilePairedStream(data.binary_reads_info.paired_read_prefix,
-                                                            0, n, i));
+            paired_streams.push_back(BinaryFilePairedStream(paired_chunks, 0, i, n));
         single_streams = WrapPairsInMultifiles<SingleReadSeq>(std::move(single_streams),
                                                               SquashingWrap<PairedReadSeq>(std::move(paired_streams)));
     }
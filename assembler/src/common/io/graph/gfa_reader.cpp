@@ -9,25 +9,189 @@
 #include "assembly_graph/core/graph.hpp"
 #include "assembly_graph/core/construction_helper.hpp"
 
+#include "io/kmers/mmapped_reader.hpp"
 #include "io/utils/id_mapper.hpp"
+#include "utils/parallel/openmp_wrapper.h"
 
 #include "gfa1/gfa.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <string>
 #include <memory>
+#include <tuple>
 #include <vector>
-#include <unordered_set>
 
 using namespace debruijn_graph;
 
 namespace gfa {
 
+namespace {
+
+// Lines of a part of the file parsed by gfa1 into a graph of its own. Segment
+// ids there are local and follow the order of the first mention in the part.
+struct GFAChunk {
+    GFAChunk()
+            : gfa(gfa_init(), gfa_destroy) {}
+
+    std::unique_ptr<gfa_t, void(*)(gfa_t*)> gfa;
+    std::vector<uint8_t> defined; // segment is given by an S-line of the part
+    std::vector<std::tuple<uint64_t, char, int>> errors;
+    uint64_t lines = 0;
+};
+
+// The same line splitting as in gfa_read()
+void ParseChunk(const char *begin, const char *end, GFAChunk &chunk) {
+    gfa_t *g = chunk.gfa.get();
+    std::string line;
+    for (const char *p = begin; p < end; ) {
+        const char *eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!eol)
+            eol = end;
+        line.assign(p, eol);
+        p = eol + 1;
+        chunk.lines += 1;
+
+        if (line.size() > 1 && line.back() == '\r')
+            line.pop_back();
+        if (line.size() < 3 || line[1] != '\t')
+            continue;
+
+        char *s = &line[0];
+        int ret = 0;
+        if (s[0] == 'S') {
+            ret = gfa_parse_S(g, s);
+            if (ret >= 0) {
+                // The name is terminated by the parser
+                chunk.defined.resize(g->n_seg);
+                chunk.defined[gfa_name2id(g, s + 2)] = 1;
+            }
+        } else if (s[0] == 'L')
+            ret = gfa_parse_L(g, s);
+        else if (s[0] == 'P')
+            ret = gfa_parse_P(g, s);
+
+        if (ret < 0)
+            chunk.errors.emplace_back(chunk.lines, s[0], ret);
+    }
+}
+
+void AddPath(gfa_t *g, const gfa_path_t &path) {
+    if (g->m_path == g->n_path) {
+        uint32_t old_m = g->m_path;
+        g->m_path = g->m_path ? g->m_path << 1 : 16;
+        g->path = (gfa_path_t*)realloc(g->path, g->m_path * sizeof(gfa_path_t));
+        memset(&g->path[old_m], 0, (g->m_path - old_m) * sizeof(gfa_path_t));
+    }
+    g->path[g->n_path++] = path;
+}
+
+// Replays the parts in file order, so the segments, arcs and paths end up
+// exactly as if gfa_read() parsed the whole file line by line. Sequences, tags
+// and paths are moved from the parts.
+void MergeChunk(GFAChunk &chunk, uint64_t first_line, gfa_t *g) {
+    if (gfa_verbose >= 1) {
+        for (const auto &error : chunk.errors)
+            fprintf(stderr, "[E] invalid %c-line at line %ld (error code %d)\n",
+                    std::get<1>(error), (long)(first_line + std::get<0>(error)), std::get<2>(error));
+    }
+
+    gfa_t *c = chunk.gfa.get();
+    chunk.defined.resize(c->n_seg);
+    std::vector<uint32_t> ids(c->n_seg);
+    for (uint32_t i = 0; i < c->n_seg; ++i) {
+        gfa_seg_t &cseg = c->seg[i];
+        ids[i] = gfa_add_seg(g, cseg.name);
+        gfa_seg_t &seg = g->seg[ids[i]];
+        if (chunk.defined[i]) {
+            // S-line sets the length, L-lines may only extend it afterwards
+            free(seg.seq);
+            free(seg.aux.aux);
+            seg.len = cseg.len;
+            seg.seq = cseg.seq;
+            seg.aux = cseg.aux;
+            cseg.seq = nullptr;
+            cseg.aux.aux = nullptr;
+        } else
+            seg.len = std::max(seg.len, cseg.len);
+    }
+
+    auto vertex = [&](uint32_t v) { return ids[v >> 1] << 1 | (v & 1); };
+    for (uint64_t k = 0; k < c->n_arc; ++k) {
+        const gfa_arc_t &arc = c->arc[k];
+        uint64_t link_id = gfa_add_arc1(g, vertex(gfa_arc_head(arc)), vertex(arc.w),
+                                        arc.ov, arc.ow, -1, 0);
+        std::swap(g->arc_aux[link_id], c->arc_aux[k]);
+    }
+
+    for (uint32_t i = 0; i < c->n_path; ++i) {
+        gfa_path_t &path = c->path[i];
+        for (uint32_t j = 0; j < path.n_seg; ++j)
+            path.v[j] = vertex(path.v[j]);
+        AddPath(g, path);
+    }
+    c->n_path = 0;
+}
+
+// Plain text file is mapped and split at line boundaries into a few parts per
+// thread. The parts are parsed concurrently by the gfa1 line parsers, only the
+// segment name lookups and the final fix-ups stay sequential.
+gfa_t *ReadGFA(const std::string &filename) {
+    {
+        std::ifstream is(filename, std::ios::binary);
+        if (!is)
+            return nullptr;
+
+        char magic[2] = {0, 0};
+        is.read(magic, 2);
+        if (magic[0] == '\x1f' && magic[1] == '\x8b')
+            return gfa_read(filename.c_str());
+    }
+
+    MMappedReader reader(filename, /* unlink */ false, /* blocksize */ -1ULL);
+    size_t size = reader.size();
+    const char *data = static_cast<const char*>(reader.skip(size));
+
+    size_t nchunks = 4 * omp_get_max_threads();
+    std::vector<size_t> bounds(nchunks + 1, size);
+    bounds[0] = 0;
+    for (size_t i = 1; i < nchunks; ++i) {
+        size_t pos = std::max(size / nchunks * i, bounds[i - 1]);
+        if (pos > 0 && pos < size && data[pos - 1] != '\n') {
+            const char *eol = static_cast<const char*>(memchr(data + pos, '\n', size - pos));
+            pos = eol ? eol - data + 1 : size;
+        }
+        bounds[i] = pos;
+    }
+
+    std::vector<GFAChunk> chunks(nchunks);
+#   pragma omp parallel for schedule(dynamic, 1)
+    for (size_t i = 0; i < nchunks; ++i)
+        ParseChunk(data + bounds[i], data + bounds[i + 1], chunks[i]);
+
+    gfa_t *g = gfa_init();
+    uint64_t lines = 0;
+    for (auto &chunk : chunks) {
+        MergeChunk(chunk, lines, g);
+        lines += chunk.lines;
+        chunk.gfa.reset();
+    }
+    gfa_finalize(g);
+
+    return g;
+}
+
+}
+
 GFAReader::GFAReader()
         : gfa_(nullptr, gfa_destroy) {}
 GFAReader::GFAReader(const std::string &filename)
-        : gfa_(gfa_read(filename.c_str()), gfa_destroy) {}
+        : gfa_(ReadGFA(filename), gfa_destroy) {}
 bool GFAReader::open(const std::string &filename) {
-    gfa_.reset(gfa_read(filename.c_str()));
+    gfa_.reset(ReadGFA(filename));
 
     return (bool)gfa_;
 }
@@ -53,45 +217,63 @@ unsigned GFAReader::k() const {
 
 void GFAReader::to_graph(ConjugateDeBruijnGraph &g,
                          io::IdMapper<std::string> *id_mapper) {
+    // The ids are assigned exactly as the sequential construction into the
+    // empty graph would do: edges and vertices go one after another in the
+    // order of segments, self-conjugate edges taking a single id.
+    VERIFY(g.e_size() == 0 && g.size() == 0);
     auto helper = g.GetConstructionHelper();
+    size_t n = gfa_->n_seg;
 
     // INFO("Loading segments");
-    std::vector<EdgeId> edges;
-    edges.reserve(gfa_->n_seg);
-    g.ereserve(2 * gfa_->n_seg);
-    for (size_t i = 0; i < gfa_->n_seg; ++i) {
+    std::vector<Sequence> seqs(n);
+    std::vector<unsigned> covs(n, 0);
+    std::vector<uint8_t> self_conj(n);
+#   pragma omp parallel for schedule(guided)
+    for (size_t i = 0; i < n; ++i) {
         gfa_seg_t *seg = gfa_->seg + i;
 
         uint8_t *kc = gfa_aux_get(seg->aux.l_aux, seg->aux.aux, "KC");
-        unsigned cov = 0;
         if (kc && kc[0] == 'i')
-            cov = *(int32_t*)(kc+1);
-        DeBruijnEdgeData edata(Sequence(seg->seq));
-        EdgeId e = helper.AddEdge(edata);
-        g.coverage_index().SetRawCoverage(e, cov);
-        g.coverage_index().SetRawCoverage(g.conjugate(e), cov);
-
-        if (id_mapper) {
-            (*id_mapper)[e.int_id()] = seg->name;
-            if (e != g.conjugate(e)) {
-                (*id_mapper)[g.conjugate(e).int_id()] = std::string(seg->name) + '\'';
-            }
+            covs[i] = *(int32_t*)(kc+1);
+        seqs[i] = Sequence(seg->seq);
+        self_conj[i] = (seqs[i] == !seqs[i]);
+    }
+
+    std::vector<uint64_t> edge_ids(n), vertex_ids(n);
+    uint64_t eid = g.min_id(), vid = g.min_id();
+    for (size_t i = 0; i < n; ++i) {
+        edge_ids[i] = eid;
+        vertex_ids[i] = vid;
+        eid += self_conj[i] ? 1 : 2;
+        vid += self_conj[i] ? 2 : 4;
+    }
+    g.ereserve(2 * n);
+    g.vreserve(4 * n);
+
+    std::vector<EdgeId> edges(n);
+#   pragma omp parallel for schedule(guided)
+    for (size_t i = 0; i < n; ++i) {
+        EdgeId e = helper.AddEdge(DeBruijnEdgeData(std::move(seqs[i])), edge_ids[i]);
+        g.coverage_index().SetRawCoverage(e, covs[i]);
+        g.coverage_index().SetRawCoverage(g.conjugate(e), covs[i]);
+        edges[i] = e;
+
+        // INFO("Creating vertices");
+        VertexId v1 = helper.CreateVertex(DeBruijnVertexData(), vertex_ids[i], vertex_ids[i] + 1);
+        helper.LinkIncomingEdge(v1, e);
+        if (!self_conj[i]) {
+            VertexId v2 = helper.CreateVertex(DeBruijnVertexData(), vertex_ids[i] + 2, vertex_ids[i] + 3);
+            helper.LinkIncomingEdge(v2, g.conjugate(e));
         }
-        edges.push_back(e);
     }
 
-    // INFO("Creating vertices");
-    g.vreserve(gfa_->n_seg * 4);
-    std::unordered_set<VertexId> vertices;
-    for (uint32_t i = 0; i < gfa_->n_seg; ++i) {
-        VertexId v1 = helper.CreateVertex(DeBruijnVertexData());
-        helper.LinkIncomingEdge(v1, edges[i]);
-        vertices.insert(v1);
-
-        if (edges[i] != g.conjugate(edges[i])) {
-            VertexId v2 = helper.CreateVertex(DeBruijnVertexData());
-            helper.LinkIncomingEdge(v2, g.conjugate(edges[i]));
-            vertices.insert(v2);
+    if (id_mapper) {
+        for (size_t i = 0; i < n; ++i) {
+            EdgeId e = edges[i];
+            const char *name = gfa_->seg[i].name;
+            (*id_mapper)[e.int_id()] = name;
+            if (e != g.conjugate(e))
+                (*id_mapper)[g.conjugate(e).int_id()] = std::string(name) + '\'';
         }
     }
 
@@ -125,11 +307,14 @@ void GFAReader::to_graph(ConjugateDeBruijnGraph &g,
     }
 
     // INFO("Filtering dangling vertices");
-    for (VertexId v : vertices) {
-        if (g.OutgoingEdgeCount(v) > 0 || g.IncomingEdgeCount(v) > 0)
-            continue;
+    for (size_t i = 0; i < n; ++i) {
+        for (uint64_t id = vertex_ids[i]; id < vertex_ids[i] + (self_conj[i] ? 2 : 4); id += 2) {
+            VertexId v(id);
+            if (g.OutgoingEdgeCount(v) > 0 || g.IncomingEdgeCount(v) > 0)
+                continue;
 
-        g.DeleteVertex(v);
+            g.DeleteVertex(v);
+        }
     }
 
     // INFO("Reading paths")
@@ -9,6 +9,9 @@
 #include "assembly_graph/core/graph.hpp"
 #include "assembly_graph/core/graph_iterators.hpp"
 #include "assembly_graph/components/graph_component.hpp"
+#include "io/utils/ordered_writer.hpp"
+
+#include <cstdio>
 
 using namespace gfa;
 using namespace debruijn_graph;
@@ -17,11 +20,31 @@ template class omnigraph::GraphComponent<Graph>;
 
 static void WriteSegment(const std::string& edge_id, const Sequence &seq,
                          double cov, uint64_t kmers,
-                         std::ostream &os) {
-    os << "S\t"
-       << edge_id << '\t' << seq.str() << '\t'
-       << "DP:f:" << float(cov) << '\t'
-       << "KC:i:" << kmers << '\n';
+                         std::string &out) {
+    // The same as the default stream formatting of float
+    char cov_str[32];
+    snprintf(cov_str, sizeof(cov_str), "%g", float(cov));
+
+    out += "S\t";
+    out += edge_id;
+    out += '\t';
+    seq.AppendStr(out);
+    out += "\tDP:f:";
+    out += cov_str;
+    out += "\tKC:i:";
+    out += std::to_string(kmers);
+    out += '\n';
+}
+
+// Segments are formatted in parallel, sequences being the bulk of the output
+static void WriteSegments(const Graph &g, const std::vector<EdgeId> &edges,
+                          const io::CanonicalEdgeHelper<Graph> &namer,
+                          std::ostream &os) {
+    io::WriteOrdered(os, edges, [&](std::string &out, EdgeId e) {
+        WriteSegment(namer.EdgeString(e), g.EdgeNucls(e),
+                     g.coverage(e), g.kmer_multiplicity(e),
+                     out);
+    });
 }
 
 static void WriteLink(EdgeId e1, EdgeId e2, size_t overlap_size,
@@ -33,11 +56,11 @@ static void WriteLink(EdgeId e1, EdgeId e2, size_t overlap_size,
 }
 
 void GFAWriter::WriteSegments() {
-    for (EdgeId e : graph_.canonical_edges()) {
-        WriteSegment(edge_namer_.EdgeString(e), graph_.EdgeNucls(e),
-                     graph_.coverage(e), graph_.kmer_multiplicity(e),
-                     os_);
-    }
+    std::vector<EdgeId> edges;
+    for (EdgeId e : graph_.canonical_edges())
+        edges.push_back(e);
+
+    ::WriteSegments(graph_, edges, edge_namer_, os_);
 }
 
 void GFAWriter::WriteLinks() {
@@ -53,13 +76,13 @@ void GFAWriter::WriteLinks() {
 
 
 void GFAWriter::WriteSegments(const Component &gc) {
+    std::vector<EdgeId> edges;
     for (EdgeId e : gc.edges()) {
-        if (e <= graph_.conjugate(e)) {
-            WriteSegment(edge_namer_.EdgeString(e), graph_.EdgeNucls(e),
-                         graph_.coverage(e), graph_.kmer_multiplicity(e),
-                         os_);
-        }
+        if (e <= graph_.conjugate(e))
+            edges.push_back(e);
     }
+
+    ::WriteSegments(graph_, edges, edge_namer_, os_);
 }
 
 void GFAWriter::WriteLinks(const Component &gc) {
@@ -78,13 +101,14 @@ void GFAWriter::WriteLinks(const Component &gc) {
 
 void GFAComponentWriter::WriteSegments() {
     const Graph &graph = component_.g();
+    std::vector<EdgeId> edges;
     for (auto e : component_.edges()) {
         if (e.int_id() > graph.conjugate(e).int_id())
             continue;
-        WriteSegment(edge_namer_.EdgeString(e), component_.g().EdgeNucls(e),
-                     graph.coverage(e), graph.kmer_multiplicity(e),
-                     os_);
+        edges.push_back(e);
     }
+
+    ::WriteSegments(graph, edges, edge_namer_, os_);
 }
 
 void GFAComponentWriter::WriteLinks() {
@@ -0,0 +1,92 @@
+//***************************************************************************
+//* Copyright (c) 2021 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#pragma once
+
+#include "single_read.hpp"
+#include "paired_read.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace io {
+
+// Binary reads file (.seq) layout:
+//   magic, ReadStreamStat, blocks...
+// Every block is self-describing:
+//   uint32_t number of reads, uint32_t payload size in bytes, payload
+// and the payload is the sequence of read records, each of them being
+//   varint length, varint left offset, varint right offset,
+//   2-bit packed nucleotides (see Sequence::PackedWrite)
+// Paired reads are stored as two consecutive records. The offsets of the
+// blocks are kept in a separate index file (.off).
+namespace binary {
+
+struct BlockHeader {
+    uint32_t count;
+    uint32_t size;
+};
+
+inline void PutVarint(std::string &out, uint64_t val) {
+    while (val >= 0x80) {
+        out.push_back(char(val | 0x80));
+        val >>= 7;
+    }
+    out.push_back(char(val));
+}
+
+inline uint64_t GetVarint(const uint8_t *&data) {
+    uint64_t val = 0;
+    for (unsigned shift = 0; ; shift += 7) {
+        uint8_t byte = *data++;
+        val |= uint64_t(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return val;
+    }
+}
+
+inline void Encode(std::string &out, const Sequence &seq,
+                   SequenceOffsetT left_offset, SequenceOffsetT right_offset) {
+    PutVarint(out, seq.size());
+    PutVarint(out, left_offset);
+    PutVarint(out, right_offset);
+    seq.PackedWrite(out);
+}
+
+template<class SingleReadT>
+void Encode(std::string &out, const SingleReadT &read, bool rc = false) {
+    if (rc)
+        Encode(out, !read.sequence(), read.GetRightOffset(), read.GetLeftOffset());
+    else
+        Encode(out, read.sequence(), read.GetLeftOffset(), read.GetRightOffset());
+}
+
+template<class SingleReadT>
+void Encode(std::string &out, const UniversalPairedRead<SingleReadT> &read,
+            bool rc1 = false, bool rc2 = false) {
+    Encode(out, read.first(), rc1);
+    Encode(out, read.second(), rc2);
+}
+
+inline void Decode(const uint8_t *&data, SingleReadSeq &read) {
+    size_t size = GetVarint(data);
+    SequenceOffsetT left_offset = SequenceOffsetT(GetVarint(data));
+    SequenceOffsetT right_offset = SequenceOffsetT(GetVarint(data));
+    read = SingleReadSeq(Sequence::PackedRead(data, size), left_offset, right_offset);
+    data += Sequence::PackedSize(size);
+}
+
+inline void Decode(const uint8_t *&data, PairedReadSeq &read, size_t insert_size) {
+    SingleReadSeq first, second;
+    Decode(data, first);
+    Decode(data, second);
+    read = PairedReadSeq(first, second, insert_size);
+}
+
+}
+
+}
@@ -6,6 +6,7 @@
 
 #include "binary_converter.hpp"
 
+#include "binary_block.hpp"
 #include "read_stream.hpp"
 #include "single_read.hpp"
 #include "paired_read.hpp"
@@ -27,8 +28,8 @@ public:
     ReadBinaryWriter(bool rc = false)
             : rc_(rc) {}
 
-    bool Write(std::ostream& file, const Read& r) const {
-        return r.BinWrite(file, rc_);
+    void Write(std::string &block, const Read& r) const {
+        binary::Encode(block, r, rc_);
     }
 };
 
@@ -42,8 +43,8 @@ public:
         std::tie(rc1_, rc2_) = GetRCFlags(orientation);
     }
 
-    bool Write(std::ostream& file, const Read& r) const {
-        return r.BinWrite(file, rc1_, rc2_);
+    void Write(std::string &block, const Read& r) const {
+        binary::Encode(block, r, rc1_, rc2_);
     }
 };
 
@@ -54,11 +55,26 @@ ReadStreamStat BinaryWriter::ToBinary(const Writer &writer, io::ReadStream<Read>
     DEBUG("Reserving a buffer for " << BUF_SIZE << " reads");
     buf.reserve(BUF_SIZE); flush_buf.reserve(BUF_SIZE);
 
+    uint64_t magic = MAGIC;
+    file_ds_->write(reinterpret_cast<const char*>(&magic), sizeof(magic));
     // Reserve space for stats
     ReadStreamStat read_stats;
     read_stats.write(*file_ds_);
 
-    size_t rest = 1;
+    std::string block;
+    binary::BlockHeader header{0, 0};
+    auto flush_block = [&]() {
+        auto offset = (size_t)file_ds_->tellp();
+        offset_ds_->write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+
+        header.size = uint32_t(block.size());
+        VERIFY(header.size == block.size());
+        file_ds_->write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file_ds_->write(block.data(), block.size());
+        block.clear();
+        header.count = 0;
+    };
+
     std::future<void> flush_task;
     auto flush_buffer = [&]() {
         // Wait for completion of the current flush task
@@ -70,12 +86,9 @@ ReadStreamStat BinaryWriter::ToBinary(const Writer &writer, io::ReadStream<Read>
 
         auto flush_job = [&] {
             for (const Read &read : flush_buf) {
-                if (!--rest) {
-                    auto offset = (size_t)file_ds_->tellp();
-                    offset_ds_->write(reinterpret_cast<const char*>(&offset), sizeof(offset));
-                    rest = CHUNK;
-                }
-                writer.Write(*file_ds_, read);
+                writer.Write(block, read);
+                if (++header.count == CHUNK)
+                    flush_block();
             }
             flush_buf.clear();
         };
@@ -103,9 +116,11 @@ ReadStreamStat BinaryWriter::ToBinary(const Writer &writer, io::ReadStream<Read>
     if (flush_task.valid())
         flush_task.wait();
     VERIFY(flush_buf.size() == 0);
+    if (header.count)
+        flush_block();
 
     // Rewrite the reserved space with actual stats
-    file_ds_->seekp(0);
+    file_ds_->seekp(sizeof(magic));
     read_stats.write(*file_ds_);
 
     INFO(read_count << " reads written");
@@ -32,8 +32,10 @@ class BinaryWriter {
 
 public:
     typedef size_t CountType;
-    static constexpr size_t CHUNK = 100;
+    // Number of reads in a block (the last one might be incomplete)
+    static constexpr size_t CHUNK = 1024;
     static constexpr size_t BUF_SIZE = 50000;
+    static constexpr uint64_t MAGIC = 0x3242534544415053ULL; // "SPADESB2"
 
     BinaryWriter(const std::string &file_name_prefix);
 
@@ -9,25 +9,72 @@
 #include "utils/verify.hpp"
 #include "utils/logger/logger.hpp"
 
-#include <fstream>
-
 namespace io {
 
-bool BinaryFileSingleStream::ReadImpl(SingleReadSeq &read) {
-    return read.BinRead(stream_);
+BinaryReadBlocks::BinaryReadBlocks(const std::string &file_name_prefix,
+                                           size_t portion_count, size_t portion_num) {
+    DEBUG("Preparing binary reads #" << portion_num << "/" << portion_count);
+    VERIFY(portion_num < portion_count);
+    const std::string fname = file_name_prefix + ".seq";
+    if (fs::FileExists(fname)) {
+        file_ = MMappedReader(fname, /* unlink */ false, /* blocksize */ -1ULL);
+        VERIFY_MSG(file_.size() >= sizeof(BinaryWriter::MAGIC) + sizeof(ReadStreamStat),
+                   "Truncated binary reads file " << fname);
+        uint64_t magic;
+        memcpy(&magic, data(), sizeof(magic));
+        VERIFY_MSG(magic == BinaryWriter::MAGIC, "Unsupported binary reads file " << fname);
+    }
+
+    const std::string offset_name = file_name_prefix + ".off";
+    const size_t chunk_count = fs::filesize(offset_name) / sizeof(size_t);
+    offsets_.resize(chunk_count);
+    if (chunk_count) {
+        auto offset_stream = fs::open_file(offset_name, std::ios_base::binary | std::ios_base::in);
+        offset_stream.read(reinterpret_cast<char *>(offsets_.data()), chunk_count * sizeof(size_t));
+        VERIFY(offset_stream);
+    }
+
+    // We split all read chunks into portion_count portions
+    // Portion could have size (chunk_count / portion_count) or (chunk_count / portion_count + 1)
+    const size_t small_portion_size = chunk_count / portion_count;
+    const size_t big_portion_size = small_portion_size + 1;
+    const size_t big_portion_count = chunk_count % portion_count;
+    // We suppose that all small portions are placed at the end
+    // Note that small portion could have size 0
+
+    // Compute the number of big portions preceding the current portion
+    const size_t big_portion_before = std::min(portion_num, big_portion_count);
+
+    // At last, compute the number of the first chunk in the current portion
+    begin_ = big_portion_before * (big_portion_size - small_portion_size) + portion_num * small_portion_size;
+    end_ = begin_ + (portion_num < big_portion_count ? big_portion_size : small_portion_size);
+    VERIFY_MSG(end_ <= chunk_count, "chunks " << begin_ << "-" << end_ << " chunk_count " << chunk_count);
+    DEBUG("Chunks " << begin_ << "-" << end_ << "/" << chunk_count << " of " << fname);
+}
+
+void BinaryFileSingleStream::ReadImpl(const uint8_t *&data, SingleReadSeq &read) {
+    binary::Decode(data, read);
 }
 
 BinaryFileSingleStream::BinaryFileSingleStream(const std::string &file_name_prefix, size_t portion_count, size_t portion_num)
         : BinaryFileStream(file_name_prefix, portion_count, portion_num) {}
 
-bool BinaryFilePairedStream::ReadImpl(PairedReadSeq& read) {
-    return read.BinRead(stream_, insert_size_);
+BinaryFileSingleStream::BinaryFileSingleStream(std::shared_ptr<BinaryReadBlocks> chunks,
+                                               size_t stream_num, size_t stream_count)
+        : BinaryFileStream(std::move(chunks), stream_num, stream_count) {}
+
+void BinaryFilePairedStream::ReadImpl(const uint8_t *&data, PairedReadSeq& read) {
+    binary::Decode(data, read, insert_size_);
 }
 
 BinaryFilePairedStream::BinaryFilePairedStream(const std::string &file_name_prefix, size_t insert_size,
                                                size_t portion_count, size_t portion_num)
         : BinaryFileStream(file_name_prefix, portion_count, portion_num), insert_size_ (insert_size) {}
 
+BinaryFilePairedStream::BinaryFilePairedStream(std::shared_ptr<BinaryReadBlocks> chunks, size_t insert_size,
+                                               size_t stream_num, size_t stream_count)
+        : BinaryFileStream(std::move(chunks), stream_num, stream_count), insert_size_(insert_size) {}
+
 PairedReadSeq BinaryUnmergingPairedStream::Convert(const SingleReadSeq &read) const {
     if (read.GetLeftOffset() >= read_length_ ||
         read.GetRightOffset() >= read_length_) {
@@ -49,6 +96,13 @@ BinaryUnmergingPairedStream::BinaryUnmergingPairedStream(const std::string& file
         insert_size_(insert_size),
         read_length_(read_length) {}
 
+BinaryUnmergingPairedStream::BinaryUnmergingPairedStream(std::shared_ptr<BinaryReadBlocks> chunks,
+                                                         size_t insert_size, size_t read_length,
+                                                         size_t stream_num, size_t stream_count) :
+        stream_(std::move(chunks), stream_num, stream_count),
+        insert_size_(insert_size),
+        read_length_(read_length) {}
+
 BinaryUnmergingPairedStream& BinaryUnmergingPairedStream::operator>>(PairedReadSeq& read) {
     SingleReadSeq single_read;
     stream_ >> single_read;
@@ -11,31 +11,90 @@
 #include "single_read.hpp"
 #include "paired_read.hpp"
 #include "binary_converter.hpp"
+#include "binary_block.hpp"
+
+#include "io/kmers/mmapped_reader.hpp"
 
 #include "utils/verify.hpp"
 #include "utils/logger/logger.hpp"
 #include "utils/filesystem/path_helper.hpp"
 #include "utils/filesystem/file_opener.hpp"
 
-#include <fstream>
+#include <cstring>
+#include <memory>
+#include <vector>
 
 namespace io {
 
+// The memory mapped binary reads file and the offsets of its blocks (or of
+// a portion of them), shared read-only by the streams reading the file.
+// The streams split the blocks by a static interleave: the stream #i of n
+// reads the blocks i, i + n, i + 2n and so on. Unlike with contiguous
+// portions, a run of slow reads (long merged reads, reads from a repeat) is
+// spread over all the streams instead of landing in one of them. Which
+// stream reads which block does not depend on the timing, so the streams see
+// the same reads on every run; a stream still finishes late if its blocks
+// happen to be the slow ones.
+class BinaryReadBlocks {
+public:
+    /**
+     * @brief All the blocks of the file.
+     */
+    explicit BinaryReadBlocks(const std::string &file_name_prefix)
+            : BinaryReadBlocks(file_name_prefix, 1, 0) {}
+
+    /**
+     * @brief The blocks of the given portion of the file only.
+     * @param portion_count Total number of (roughly equal) portions.
+     * @param portion_num Index of the portion (0..portion_count - 1).
+     */
+    BinaryReadBlocks(const std::string &file_name_prefix, size_t portion_count, size_t portion_num);
+
+    bool is_open() const { return file_.data() != nullptr; }
+    const uint8_t *data() const { return static_cast<const uint8_t*>(file_.data()); }
+    size_t size() const { return file_.size(); }
+
+    /// The first block read by the stream #stream_num
+    size_t first(size_t stream_num) const { return begin_ + stream_num; }
+    /// The index past the last block
+    size_t end() const { return end_; }
+    size_t offset(size_t chunk) const { return offsets_[chunk]; }
+
+private:
+    MMappedReader file_;
+    std::vector<size_t> offsets_;
+    size_t begin_, end_;
+};
+
+// Reads binary reads files (see binary_block.hpp for the layout) block by
+// block. Streams constructed with a portion own the blocks of their
+// portion; the streams constructed over shared blocks read every
+// stream_count-th block of them. The streams keep their own position, so
+// each of them could be reset independently.
 template<typename SeqT>
 class BinaryFileStream {
 protected:
-    std::ifstream stream_;
-
-    virtual bool ReadImpl(SeqT &read) = 0;
+    virtual void ReadImpl(const uint8_t *&data, SeqT &read) = 0;
 
 private:
-    size_t offset_, count_, current_;
-
-    void Init() {
-        stream_.clear();
-        stream_.seekg(offset_);
-        VERIFY_MSG(stream_.good(), "Stream is not good(), offset_ " << offset_ << " count_ " << count_);
-        current_ = 0;
+    std::shared_ptr<BinaryReadBlocks> chunks_;
+    size_t stream_num_ = 0, stream_count_ = 1;
+    // Index of the next block to read, position of the next read record in
+    // the file and the number of records left in the current block
+    size_t next_chunk_ = 0, pos_ = 0, block_left_ = 0;
+
+    void NextBlock() {
+        pos_ = chunks_->offset(next_chunk_);
+        next_chunk_ += stream_count_;
+
+        VERIFY_MSG(pos_ + sizeof(binary::BlockHeader) <= chunks_->size(),
+                   "Truncated binary reads file, block offset " << pos_);
+        binary::BlockHeader header;
+        memcpy(&header, chunks_->data() + pos_, sizeof(header));
+        pos_ += sizeof(header);
+        VERIFY_MSG(header.count && pos_ + header.size <= chunks_->size(),
+                   "Malformed binary reads block at " << pos_ - sizeof(header));
+        block_left_ = header.count;
     }
 
 public:
@@ -45,56 +104,9 @@ public:
      * @param portion_count Total number of (roughly equal) portions.
      * @param portion_num Index of the portion (0..portion_count - 1).
      */
-    BinaryFileStream(const std::string &file_name_prefix, size_t portion_count, size_t portion_num) {
-        DEBUG("Preparing binary stream #" << portion_num << "/" << portion_count);
-        VERIFY(portion_num < portion_count);
-        const std::string fname = file_name_prefix + ".seq";
-        stream_.open(fname, std::ios_base::binary | std::ios_base::in);
-        ReadStreamStat stat;
-        stat.read(stream_);
-
-        const std::string offset_name = file_name_prefix + ".off";
-        const size_t chunk_count = fs::filesize(offset_name) / sizeof(size_t);
-
-        // We split all read chunks into portion_count portions
-        // Portion could have size (chunk_count / portion_count) or (chunk_count / portion_count + 1)
-        const size_t small_portion_size = chunk_count / portion_count;
-        const size_t big_portion_size = small_portion_size + 1;
-        const size_t big_portion_count = chunk_count % portion_count;
-        VERIFY(big_portion_count * big_portion_size + (portion_count - big_portion_count) * small_portion_size == chunk_count);
-        // We suppose that all small portions are placed at the end
-        // Note that small portion could have size 0
-
-        // Compute the number of big portions preceding the current portion
-        const size_t big_portion_before = std::min(portion_num, big_portion_count);
-
-        // At last, compute the number of the first chunk in the current portion
-        const size_t chunk_num = big_portion_before * (big_portion_size - small_portion_size) + portion_num * small_portion_size;
-        VERIFY_MSG(chunk_num <= chunk_count, "chunk_num " << chunk_num << " chunk_count " << chunk_count << " big_portion_before " << big_portion_before << " big_portion_size " << big_portion_size << " small_portion_size " << small_portion_size << " portion_num " << portion_num);
-
-        if (chunk_num < chunk_count) {  // if we start from existing chunk
-            // Calculating the absolute offset in the reads file
-            auto offset_stream = fs::open_file(offset_name, std::ios_base::binary | std::ios_base::in);
-            offset_stream.seekg(chunk_num * sizeof(size_t));
-            offset_stream.read(reinterpret_cast<char *>(&offset_), sizeof(offset_));
-            DEBUG("Offset read: " << offset_ << " chunk_count " << chunk_count << " chunk_num " << chunk_num << " portion_count " << portion_count << " portion_num " << portion_num << " prefix " << file_name_prefix << " name " << offset_name);
-            VERIFY(offset_stream);
-            const bool is_big_portion = portion_num < big_portion_count;
-            const size_t start_num = chunk_num * BinaryWriter::CHUNK;
-            // Last chunk could be incomplete => we should truncate count_ for last portions
-            count_ = std::min(stat.read_count - start_num,
-                              (is_big_portion ? big_portion_size : small_portion_size) * BinaryWriter::CHUNK);
-
-            DEBUG("Reads " << start_num << "-" << start_num + count_ << "/" << stat.read_count << " from " << offset_);
-        } else {  // current portion has size 0 (the case of chunk_count == 0 is also included here)
-            // Setup safe offset value
-            offset_ = sizeof(ReadStreamStat);
-            count_ = 0;
-            DEBUG("Empty BinaryFileStream constructed");
-        }
-
-        Init();
-    }
+    BinaryFileStream(const std::string &file_name_prefix, size_t portion_count, size_t portion_num)
+            : BinaryFileStream(std::make_shared<BinaryReadBlocks>(file_name_prefix, portion_count, portion_num),
+                               0, 1) {}
 
     /**
      * @brief Constructs a reader of all available reads.
@@ -102,46 +114,68 @@ public:
     BinaryFileStream(const std::string &file_name_prefix)
             : BinaryFileStream(file_name_prefix, 1, 0) {}
 
+    /**
+     * @brief Constructs a reader of every stream_count-th of the shared blocks.
+     * @param stream_count Total number of the streams sharing the blocks.
+     * @param stream_num Index of the stream (0..stream_count - 1).
+     */
+    BinaryFileStream(std::shared_ptr<BinaryReadBlocks> chunks, size_t stream_num, size_t stream_count)
+            : chunks_(std::move(chunks)), stream_num_(stream_num), stream_count_(stream_count) {
+        VERIFY(stream_num_ < stream_count_);
+        reset();
+    }
+
     BinaryFileStream<SeqT>& operator>>(SeqT &read) {
-        ReadImpl(read);
-        VERIFY(current_ < count_);
-        ++current_;
+        VERIFY(!eof());
+        if (block_left_ == 0)
+            NextBlock();
+        const uint8_t *record = chunks_->data() + pos_;
+        ReadImpl(record, read);
+        pos_ = record - chunks_->data();
+        --block_left_;
         return *this;
     }
 
     bool is_open() {
-        return stream_.is_open();
+        return chunks_ && chunks_->is_open();
     }
 
-    bool eof() {
-        return current_ >= count_;
+    // Blocks are never empty, so there is a read left as long as there is
+    // a block left
+    bool eof() const {
+        return block_left_ == 0 && (!chunks_ || next_chunk_ >= chunks_->end());
     }
 
     void close() {
-        current_ = 0;
-        stream_.close();
+        block_left_ = 0;
+        chunks_.reset();
     }
 
     void reset() {
-        Init();
+        block_left_ = 0;
+        if (chunks_)
+            next_chunk_ = chunks_->first(stream_num_);
     }
 
 };
 
 class BinaryFileSingleStream : public BinaryFileStream<SingleReadSeq>  {
 protected:
-    bool ReadImpl(SingleReadSeq &read) override;
+    void ReadImpl(const uint8_t *&data, SingleReadSeq &read) override;
 public:
     BinaryFileSingleStream(const std::string &file_name_prefix, size_t portion_count, size_t portion_num);
+    BinaryFileSingleStream(std::shared_ptr<BinaryReadBlocks> chunks, size_t stream_num, size_t stream_count);
 };
 
 class BinaryFilePairedStream: public BinaryFileStream<PairedReadSeq> {
     size_t insert_size_;
 protected:
-    bool ReadImpl(PairedReadSeq& read) override;
+    void ReadImpl(const uint8_t *&data, PairedReadSeq& read) override;
 public:
     BinaryFilePairedStream(const std::string &file_name_prefix, size_t insert_size,
                            size_t portion_count, size_t portion_num);
+    BinaryFilePairedStream(std::shared_ptr<BinaryReadBlocks> chunks, size_t insert_size,
+                           size_t stream_num, size_t stream_count);
 };
 
 // returns FF oriented paired reads
@@ -155,6 +189,9 @@ class BinaryUnmergingPairedStream {
 public:
     BinaryUnmergingPairedStream(const std::string& file_name_prefix, size_t insert_size, size_t read_length,
                                 size_t portion_count, size_t portion_num);
+    BinaryUnmergingPairedStream(std::shared_ptr<BinaryReadBlocks> chunks,
+                                size_t insert_size, size_t read_length,
+                                size_t stream_num, size_t stream_count);
 
     bool is_open() { return stream_.is_open(); }
     bool eof() { return stream_.eof(); }
@@ -27,6 +27,22 @@ inline void WriteWrapped(const std::string &s, std::ostream &os, size_t max_widt
     }
 }
 
+// Same as WriteWrapped, but appends to the buffer
+inline void AppendWrapped(const std::string &s, std::string &out, size_t max_width = 60) {
+    for (size_t cur = 0; cur < s.size(); cur += max_width) {
+        out.append(s, cur, max_width);
+        out += '\n';
+    }
+}
+
+// FASTA record as written by FastaWriter
+inline void AppendFasta(const std::string &name, const std::string &s, std::string &out) {
+    out += '>';
+    out += name;
+    out += '\n';
+    AppendWrapped(s, out);
+}
+
 class osequencestream {
 protected:
     std::ofstream ofstream_;
@@ -89,21 +89,6 @@ public:
                insert_size_ == paired_read.insert_size_;
     }
 
-    bool BinRead(std::istream &file, size_t estimated_is) {
-        first_.BinRead(file);
-        second_.BinRead(file);
-
-        insert_size_ = estimated_is;
-        return !file.fail();
-    }
-
-    bool BinWrite(std::ostream &file, bool rc1 = false, bool rc2 = false) const {
-        first_.BinWrite(file, rc1);
-        second_.BinWrite(file, rc2);
-
-        return !file.fail();
-    }
-
     UniversalPairedRead() : first_(), second_(), insert_size_(0) { }
 
     UniversalPairedRead(const SingleReadT &first,
@@ -184,23 +184,6 @@ public:
         return right_offset_;
     }
 
-    bool BinWrite(std::ostream &file, bool rc = false) const {
-        sequence(rc).BinWrite(file);
-        if (rc) {
-            file.write((const char *) &right_offset_, sizeof(right_offset_));
-            file.write((const char *) &left_offset_, sizeof(left_offset_));
-        } else {
-            file.write((const char *) &left_offset_, sizeof(left_offset_));
-            file.write((const char *) &right_offset_, sizeof(right_offset_));
-        }
-        return !file.fail();
-    }
-
-    bool BinRead(std::istream &/*file*/) {
-        VERIFY(false);
-        return false;
-    }
-
 private:
     /*
      * @variable The name of SingleRead in input file.
@@ -276,27 +259,6 @@ public:
     SingleReadSeq() : seq_(), left_offset_(0), right_offset_(0) {
     }
 
-    bool BinRead(std::istream &file) {
-        seq_.BinRead(file);
-        file.read((char *) &left_offset_, sizeof(left_offset_));
-        file.read((char *) &right_offset_, sizeof(right_offset_));
-        return !file.fail();
-    }
-
-    bool BinWrite(std::ostream &file, bool rc = false) const {
-        if (rc)
-            (!seq_).BinWrite(file);
-        else
-            seq_.BinWrite(file);
-        if (rc) {
-            file.write((const char *) &right_offset_, sizeof(right_offset_));
-            file.write((const char *) &left_offset_, sizeof(left_offset_));
-        } else {
-            file.write((const char *) &left_offset_, sizeof(left_offset_));
-            file.write((const char *) &right_offset_, sizeof(right_offset_));
-        }
-        return !file.fail();
-    }
 
     //    SingleReadSeq(std::istream& file): seq_(file, true) {
     //    }
@@ -7,11 +7,16 @@
 //todo rename to reader
 #pragma once
 
+#include "bgzf_reader.hpp"
+
 #include "io/reads/read_stream.hpp"
 #include "io/reads/single_read.hpp"
 
 #include <bamtools/api/BamReader.h>
 
+#include <future>
+#include <memory>
+
 namespace io {
 class BamRead : public BamTools::BamAlignment {
 public:
@@ -104,4 +109,90 @@ private:
     }
 
 };
+// Same as UnmappedBamStream, but BGZF decompression and record parsing are
+// done by a pool of worker threads. The next batch of reads is prepared in
+// background while the current one is consumed.
+class ParallelUnmappedBamStream {
+public:
+    typedef BamRead ReadT;
+
+    ParallelUnmappedBamStream(const std::string &filename, unsigned nthreads)
+            : filename_(filename), nthreads_(nthreads),
+              pool_(std::make_unique<ThreadPool::ThreadPool>(std::max(nthreads, 1u))) {
+        open();
+    }
+
+    ~ParallelUnmappedBamStream() {
+        wait_prefetch();
+    }
+
+    bool is_open() { return is_open_; }
+
+    bool eof() { return eof_; }
+
+    ParallelUnmappedBamStream &operator>>(BamRead &read) {
+        if (!is_open_ || eof_)
+            return *this;
+
+        read = std::move(read_buffer_[read_pos_++]);
+        if (read_pos_ == read_buffer_.size())
+            next_batch();
+
+        return *this;
+    }
+
+    void close() {
+        wait_prefetch();
+        parser_.reset();
+        is_open_ = false;
+        eof_ = true;
+    }
+
+    void reset() {
+        close();
+        open();
+    }
+
+private:
+    std::string filename_;
+    unsigned nthreads_;
+    std::unique_ptr<ThreadPool::ThreadPool> pool_;
+    std::unique_ptr<ParallelBamParser> parser_;
+    std::vector<BamRead> read_buffer_;
+    std::vector<BamRead> write_buffer_;
+    size_t read_pos_ = 0;
+    std::future<bool> prefetch_;
+    bool is_open_;
+    bool eof_;
+
+    void open() {
+        parser_ = std::make_unique<ParallelBamParser>(filename_, *pool_, nthreads_);
+        is_open_ = parser_->is_open();
+        eof_ = !is_open_;
+        if (is_open_) {
+            prefetch();
+            next_batch();
+        }
+    }
+
+    void prefetch() {
+        prefetch_ = std::async(std::launch::async,
+                               [this] { return parser_->ReadBatch(write_buffer_); });
+    }
+
+    void wait_prefetch() {
+        if (prefetch_.valid())
+            prefetch_.wait();
+    }
+
+    void next_batch() {
+        bool has_more = prefetch_.get();
+        std::swap(read_buffer_, write_buffer_);
+        read_pos_ = 0;
+        eof_ = !has_more;
+        if (has_more)
+            prefetch();
+    }
+};
+
 }
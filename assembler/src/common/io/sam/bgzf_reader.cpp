@@ -0,0 +1,262 @@
+//***************************************************************************
+//* Copyright (c) 2021 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#include "bgzf_reader.hpp"
+
+#include "utils/verify.hpp"
+
+#include <bamtools/api/BamAux.h>
+#include <bamtools/api/BamConstants.h>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace io {
+
+static constexpr size_t BGZF_BLOCK_HEADER_LENGTH = 18;
+static constexpr size_t BGZF_BLOCK_FOOTER_LENGTH = 8;
+
+static uint16_t UnpackUInt16(const char *data) {
+    return uint16_t(uint8_t(data[0]) | (uint8_t(data[1]) << 8));
+}
+
+static void InflateBlock(const std::string &block, std::string &out) {
+    uint32_t isize = BamTools::UnpackUnsignedInt(block.data() + block.size() - 4);
+    out.resize(isize);
+    if (!isize)
+        return;
+
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    zs.next_in = (Bytef*)(block.data() + BGZF_BLOCK_HEADER_LENGTH);
+    zs.avail_in = (uInt)(block.size() - BGZF_BLOCK_HEADER_LENGTH - BGZF_BLOCK_FOOTER_LENGTH);
+    zs.next_out = (Bytef*)&out[0];
+    zs.avail_out = isize;
+
+    int status = inflateInit2(&zs, -15);
+    VERIFY_MSG(status == Z_OK, "Failed to initialize BGZF decompressor");
+    status = inflate(&zs, Z_FINISH);
+    inflateEnd(&zs);
+    VERIFY_MSG(status == Z_STREAM_END && zs.total_out == isize, "Failed to decompress BGZF block");
+}
+
+BGZFReader::BGZFReader(const std::string &filename,
+                       ThreadPool::ThreadPool &pool, unsigned nthreads)
+        : is_(filename, std::ios::in | std::ios::binary), pool_(pool), nthreads_(std::max(nthreads, 1u)) {
+    eof_ = !is_.is_open();
+}
+
+bool BGZFReader::ReadRawBlock(std::string &block) {
+    char header[BGZF_BLOCK_HEADER_LENGTH];
+    is_.read(header, BGZF_BLOCK_HEADER_LENGTH);
+    if (is_.gcount() == 0)
+        return false;
+
+    VERIFY_MSG(size_t(is_.gcount()) == BGZF_BLOCK_HEADER_LENGTH &&
+               uint8_t(header[0]) == 31 && uint8_t(header[1]) == 139 &&
+               uint8_t(header[2]) == 8 && (uint8_t(header[3]) & 4) &&
+               header[12] == 'B' && header[13] == 'C',
+               "Invalid BGZF block header");
+
+    size_t block_length = size_t(UnpackUInt16(header + 16)) + 1;
+    VERIFY(block_length > BGZF_BLOCK_HEADER_LENGTH + BGZF_BLOCK_FOOTER_LENGTH);
+    block.resize(block_length);
+    memcpy(&block[0], header, BGZF_BLOCK_HEADER_LENGTH);
+    is_.read(&block[BGZF_BLOCK_HEADER_LENGTH], block_length - BGZF_BLOCK_HEADER_LENGTH);
+    VERIFY_MSG(size_t(is_.gcount()) == block_length - BGZF_BLOCK_HEADER_LENGTH, "Truncated BGZF block");
+
+    return true;
+}
+
+bool BGZFReader::ReadBatch(std::string &out) {
+    if (eof_)
+        return false;
+
+    size_t max_blocks = BLOCKS_PER_THREAD * nthreads_;
+    raw_blocks_.resize(max_blocks);
+
+    size_t nblocks = 0;
+    while (nblocks < max_blocks && ReadRawBlock(raw_blocks_[nblocks]))
+        nblocks += 1;
+    if (nblocks < max_blocks)
+        eof_ = true;
+
+    blocks_.resize(nblocks);
+    std::vector<std::future<void>> tasks;
+    size_t step = std::max<size_t>((nblocks + nthreads_ - 1) / nthreads_, 1);
+    for (size_t start = 0; start < nblocks; start += step) {
+        size_t end = std::min(nblocks, start + step);
+        tasks.push_back(pool_.run([this, start, end] {
+                    for (size_t i = start; i < end; ++i)
+                        InflateBlock(raw_blocks_[i], blocks_[i]);
+                }));
+    }
+    for (auto &task : tasks)
+        task.get();
+
+    for (size_t i = 0; i < nblocks; ++i)
+        out.append(blocks_[i]);
+
+    return nblocks > 0;
+}
+
+void ParseBamRecord(const char *data, size_t length, BamTools::BamAlignment &alignment) {
+    using namespace BamTools;
+    using namespace BamTools::Constants;
+
+    VERIFY(length >= sizeof(uint32_t) + BAM_CORE_SIZE);
+    const char *core = data + sizeof(uint32_t);
+
+    alignment.RefID = UnpackSignedInt(core);
+    alignment.Position = UnpackSignedInt(core + 4);
+
+    uint32_t bin_mq_nl = UnpackUnsignedInt(core + 8);
+    alignment.Bin = uint16_t(bin_mq_nl >> 16);
+    alignment.MapQuality = uint16_t(bin_mq_nl >> 8 & 0xff);
+    uint32_t name_length = bin_mq_nl & 0xff;
+
+    uint32_t flag_nc = UnpackUnsignedInt(core + 12);
+    alignment.AlignmentFlag = flag_nc >> 16;
+    uint32_t num_cigar = flag_nc & 0xffff;
+
+    uint32_t seq_length = UnpackUnsignedInt(core + 16);
+    alignment.Length = int32_t(seq_length);
+    alignment.MateRefID = UnpackSignedInt(core + 20);
+    alignment.MatePosition = UnpackSignedInt(core + 24);
+    alignment.InsertSize = UnpackSignedInt(core + 28);
+
+    const char *name = core + BAM_CORE_SIZE;
+    const char *cigar = name + name_length;
+    const char *seq = cigar + num_cigar * sizeof(uint32_t);
+    const char *qual = seq + (seq_length + 1) / 2;
+    const char *tags = qual + seq_length;
+    const char *end = data + length;
+    VERIFY_MSG(tags <= end, "Malformed BAM record");
+
+    alignment.Name.assign(name, strnlen(name, name_length));
+
+    alignment.CigarData.clear();
+    alignment.CigarData.reserve(num_cigar);
+    for (uint32_t i = 0; i < num_cigar; ++i) {
+        uint32_t op = UnpackUnsignedInt(cigar + i * sizeof(uint32_t));
+        alignment.CigarData.emplace_back(BAM_CIGAR_LOOKUP[op & BAM_CIGAR_MASK], op >> BAM_CIGAR_SHIFT);
+    }
+
+    alignment.QueryBases.resize(seq_length);
+    for (uint32_t i = 0; i < seq_length; ++i)
+        alignment.QueryBases[i] = BAM_DNA_LOOKUP[(seq[i / 2] >> (4 * (1 - (i % 2)))) & 0xf];
+
+    // Unstored qualities (sequence of 0xFF) are kept as-is, same as BamTools does
+    alignment.Qualities.resize(seq_length);
+    if (seq_length && qual[0] == (char)0xFF)
+        std::fill(alignment.Qualities.begin(), alignment.Qualities.end(), (char)0xFF);
+    else {
+        for (uint32_t i = 0; i < seq_length; ++i)
+            alignment.Qualities[i] = char(qual[i] + 33);
+    }
+
+    alignment.AlignedBases.clear();
+    if (!alignment.QueryBases.empty() && alignment.QueryBases != "*") {
+        size_t k = 0;
+        for (const auto &op : alignment.CigarData) {
+            switch (op.Type) {
+                case BAM_CIGAR_MATCH_CHAR:
+                case BAM_CIGAR_INS_CHAR:
+                case BAM_CIGAR_SEQMATCH_CHAR:
+                case BAM_CIGAR_MISMATCH_CHAR:
+                    alignment.AlignedBases.append(alignment.QueryBases, k, op.Length);
+                    // fall through
+                case BAM_CIGAR_SOFTCLIP_CHAR:
+                    k += op.Length;
+                    break;
+                case BAM_CIGAR_DEL_CHAR:
+                    alignment.AlignedBases.append(op.Length, BAM_DNA_DEL);
+                    break;
+                case BAM_CIGAR_PAD_CHAR:
+                    alignment.AlignedBases.append(op.Length, BAM_DNA_PAD);
+                    break;
+                case BAM_CIGAR_REFSKIP_CHAR:
+                    alignment.AlignedBases.append(op.Length, BAM_DNA_N);
+                    break;
+                case BAM_CIGAR_HARDCLIP_CHAR:
+                    break;
+                default:
+                    VERIFY_MSG(false, "Invalid CIGAR operation type: " << op.Type);
+            }
+        }
+    }
+
+    alignment.TagData.assign(tags, end);
+}
+
+ParallelBamParser::ParallelBamParser(const std::string &filename,
+                                     ThreadPool::ThreadPool &pool, unsigned nthreads)
+        : reader_(filename, pool, nthreads), pool_(pool) {}
+
+bool ParallelBamParser::SkipHeader() {
+    // magic, l_text, text, n_ref, then n_ref x (l_name, name, l_ref)
+    size_t size = buffer_.size();
+    const char *data = buffer_.data();
+    if (size < 8)
+        return false;
+    VERIFY_MSG(memcmp(data, "BAM\1", 4) == 0, "Invalid BAM magic");
+
+    size_t pos = 8 + BamTools::UnpackUnsignedInt(data + 4);
+    if (size < pos + 4)
+        return false;
+    uint32_t num_refs = BamTools::UnpackUnsignedInt(data + pos);
+    pos += 4;
+    for (uint32_t i = 0; i < num_refs; ++i) {
+        if (size < pos + 4)
+            return false;
+        pos += 4 + BamTools::UnpackUnsignedInt(data + pos) + 4;
+    }
+    if (size < pos)
+        return false;
+
+    pos_ = pos;
+    header_skipped_ = true;
+    return true;
+}
+
+bool ParallelBamParser::NextRecords() {
+    buffer_.erase(0, pos_);
+    pos_ = 0;
+    offsets_.clear();
+
+    while (true) {
+        bool has_more = reader_.ReadBatch(buffer_);
+        if (!header_skipped_ && !SkipHeader()) {
+            VERIFY_MSG(has_more, "Truncated BAM header");
+            continue;
+        }
+
+        size_t pos = pos_;
+        while (pos + sizeof(uint32_t) <= buffer_.size()) {
+            size_t record_length = sizeof(uint32_t) + BamTools::UnpackUnsignedInt(buffer_.data() + pos);
+            if (pos + record_length > buffer_.size())
+                break;
+            offsets_.push_back(pos);
+            pos += record_length;
+        }
+
+        if (!offsets_.empty()) {
+            // Leave the header (if any) in front of the first record, it
+            // will be dropped together with the records on the next call
+            pos_ = pos;
+            return true;
+        }
+
+        if (!has_more) {
+            VERIFY_MSG(pos == buffer_.size(), "Truncated BAM record");
+            return false;
+        }
+    }
+}
+
+}
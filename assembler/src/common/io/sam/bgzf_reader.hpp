@@ -0,0 +1,102 @@
+//***************************************************************************
+//* Copyright (c) 2021 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#pragma once
+
+#include "threadpool/threadpool.hpp"
+
+#include <bamtools/api/BamAlignment.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace io {
+
+// Reads BGZF-compressed files (e.g. BAM) in batches of blocks. Raw blocks are
+// read sequentially, but decompressed concurrently on the thread pool.
+class BGZFReader {
+    static constexpr size_t BLOCKS_PER_THREAD = 64;
+  public:
+    BGZFReader(const std::string &filename,
+               ThreadPool::ThreadPool &pool, unsigned nthreads);
+
+    bool is_open() const { return is_.is_open(); }
+    bool eof() const { return eof_; }
+
+    // Appends the decompressed contents of the next batch of blocks to
+    // out. Returns false if there is nothing more to read.
+    bool ReadBatch(std::string &out);
+
+  private:
+    bool ReadRawBlock(std::string &block);
+
+    std::ifstream is_;
+    ThreadPool::ThreadPool &pool_;
+    unsigned nthreads_;
+    std::vector<std::string> raw_blocks_;
+    std::vector<std::string> blocks_;
+    bool eof_ = false;
+};
+
+// Parses BAM records out of the decompressed BGZF stream. The record
+// boundaries are determined sequentially, the records themselves are
+// decoded into BamTools::BamAlignment concurrently.
+class ParallelBamParser {
+    static constexpr size_t RECORDS_PER_TASK = 4096;
+  public:
+    ParallelBamParser(const std::string &filename,
+                      ThreadPool::ThreadPool &pool, unsigned nthreads);
+
+    bool is_open() const { return reader_.is_open(); }
+
+    // Fills the next batch of alignments. Returns false if there is
+    // nothing more to read.
+    template<class Alignment>
+    bool ReadBatch(std::vector<Alignment> &alignments) {
+        alignments.clear();
+        if (!NextRecords())
+            return false;
+
+        alignments.resize(offsets_.size());
+        ParseRecords([&](size_t i) -> BamTools::BamAlignment& { return alignments[i]; });
+        return true;
+    }
+
+  private:
+    bool NextRecords();
+    bool SkipHeader();
+    template<class Accessor>
+    void ParseRecords(Accessor alignment);
+
+    BGZFReader reader_;
+    ThreadPool::ThreadPool &pool_;
+    std::string buffer_;
+    size_t pos_ = 0;
+    std::vector<size_t> offsets_;
+    bool header_skipped_ = false;
+};
+
+void ParseBamRecord(const char *data, size_t length, BamTools::BamAlignment &alignment);
+
+template<class Accessor>
+void ParallelBamParser::ParseRecords(Accessor alignment) {
+    std::vector<std::future<void>> tasks;
+    for (size_t start = 0; start < offsets_.size(); start += RECORDS_PER_TASK) {
+        size_t end = std::min(offsets_.size(), start + RECORDS_PER_TASK);
+        tasks.push_back(pool_.run([this, &alignment, start, end] {
+                    for (size_t i = start; i < end; ++i) {
+                        size_t next = (i + 1 < offsets_.size() ? offsets_[i + 1] : pos_);
+                        ParseBamRecord(buffer_.data() + offsets_[i], next - offsets_[i], alignment(i));
+                    }
+                }));
+    }
+
+    for (auto &task : tasks)
+        task.get();
+}
+
+}
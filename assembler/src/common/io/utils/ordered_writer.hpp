@@ -0,0 +1,48 @@
+//***************************************************************************
+//* Copyright (c) 2021 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#pragma once
+
+#include "utils/parallel/openmp_wrapper.h"
+
+#include <algorithm>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace io {
+
+/**
+ * Formats the items in parallel and writes them out in their original order,
+ * so the output is byte-identical to the one of the sequential loop. Items are
+ * processed in batches: every thread formats a contiguous chunk of the batch
+ * into its own buffer, then the buffers are flushed one after another.
+ * @param format  void(std::string &out, const Item &item), appends the item
+ *                text to the buffer. Called concurrently.
+ */
+template<class Item, class Formatter>
+void WriteOrdered(std::ostream &os, const std::vector<Item> &items, Formatter format,
+                  size_t chunk_size = 1024) {
+    size_t nchunks = omp_get_max_threads();
+    std::vector<std::string> buffers(nchunks);
+    size_t batch_size = nchunks * chunk_size;
+    for (size_t batch = 0; batch < items.size(); batch += batch_size) {
+#       pragma omp parallel for schedule(static, 1)
+        for (size_t chunk = 0; chunk < nchunks; ++chunk) {
+            std::string &buf = buffers[chunk];
+            buf.clear();
+            size_t start = std::min(items.size(), batch + chunk * chunk_size);
+            size_t end = std::min(items.size(), start + chunk_size);
+            for (size_t i = start; i < end; ++i)
+                format(buf, items[i]);
+        }
+
+        for (const auto &buf : buffers)
+            os.write(buf.data(), buf.size());
+    }
+}
+
+}
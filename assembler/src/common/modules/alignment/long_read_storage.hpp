@@ -8,15 +8,19 @@
 #pragma once
 
 #include "io/binary/binary.hpp"
+#include "adt/iterator_range.hpp"
 
 #include "common/utils/logger/logger.hpp"
 #include "utils/filesystem/file_opener.hpp"
 
+#include <parallel_hashmap/phmap.h>
+
 #include <string>
 #include <vector>
 #include <map>
 #include <set>
 #include <algorithm>
+#include <numeric>
 
 namespace debruijn_graph {
 
@@ -62,98 +66,145 @@ public:
     }
 };
 
+/**
+ * @brief Deduplicated set of weighted edge paths.
+ *        Paths are interned into a single edge arena, equal paths are found via hashing
+ *        and merged by summing their weights. Paths are reported in the lexicographic order.
+ */
 template<class Graph>
 class PathStorage {
     friend class PathInfo<Graph> ;
     typedef typename Graph::EdgeId EdgeId;
-    typedef std::map<EdgeId, std::set<PathInfo<Graph>>> InnerIndex;
+    typedef typename std::vector<EdgeId>::const_iterator EdgeIterator;
 
-    const Graph &g_;
-    InnerIndex inner_index_;
     static const size_t kLongEdgeForStats = 500;
+    static const size_t kNoPath = -1ul;
 
-    void HiddenAddPath(const std::vector<EdgeId> &p, int w) {
-        if (p.size() == 0 ) return;
-        for (typename std::set<PathInfo<Graph>>::iterator iter = inner_index_[p[0]].begin(); iter != inner_index_[p[0]].end(); ++iter) {
-            if (iter->path() == p) {
-                iter->increase_weight(w);
-                return;
-            }
+    const Graph &g_;
+    // i-th path occupies [offsets_[i], offsets_[i + 1]) of the arena
+    std::vector<EdgeId> edges_;
+    std::vector<size_t> offsets_;
+    std::vector<size_t> weights_;
+    // Paths with the same hash are chained via next_
+    phmap::flat_hash_map<uint64_t, size_t> heads_;
+    std::vector<size_t> next_;
+    // Per-edge index of the paths going through the edge, see BuildCoverageIndex()
+    std::vector<size_t> coverage_offsets_;
+    std::vector<size_t> coverage_paths_;
+
+    template<class It>
+    static uint64_t Hash(It begin, It end) {
+        uint64_t hash = 0;
+        for (It it = begin; it != end; ++it)
+            hash = phmap::HashState().combine(hash, it->int_id());
+        return hash;
+    }
+
+    EdgeIterator path_begin(size_t id) const {
+        return edges_.begin() + offsets_[id];
+    }
+
+    EdgeIterator path_end(size_t id) const {
+        return edges_.begin() + offsets_[id + 1];
+    }
+
+    template<class It>
+    size_t Find(It begin, It end, uint64_t hash) const {
+        auto head = heads_.find(hash);
+        if (head == heads_.end())
+            return kNoPath;
+        for (size_t id = head->second; id != kNoPath; id = next_[id]) {
+            if (std::equal(begin, end, path_begin(id), path_end(id)))
+                return id;
         }
-        inner_index_[p[0]].insert(PathInfo<Graph>(p, w));
-        size_++;
+        return kNoPath;
+    }
+
+    template<class It>
+    void Insert(It begin, It end, uint64_t hash, size_t w) {
+        size_t id = weights_.size();
+        edges_.insert(edges_.end(), begin, end);
+        offsets_.push_back(edges_.size());
+        weights_.push_back(w);
+        auto head = heads_.emplace(hash, size_t(kNoPath)).first;
+        next_.push_back(head->second);
+        head->second = id;
+        coverage_offsets_.clear();
+        coverage_paths_.clear();
+    }
+
+    template<class It>
+    void HiddenAddPath(It begin, It end, size_t w) {
+        if (begin == end) return;
+        uint64_t hash = Hash(begin, end);
+        size_t id = Find(begin, end, hash);
+        if (id != kNoPath)
+            weights_[id] += w;
+        else
+            Insert(begin, end, hash, w);
+    }
+
+    std::vector<size_t> SortedIds() const {
+        std::vector<size_t> ids(size());
+        std::iota(ids.begin(), ids.end(), 0);
+        std::sort(ids.begin(), ids.end(), [this](size_t a, size_t b) {
+            return std::lexicographical_compare(path_begin(a), path_end(a), path_begin(b), path_end(b));
+        });
+        return ids;
+    }
+
+    // Sorted ids split into the groups of paths starting with the same edge
+    std::vector<std::vector<size_t>> GroupByFirstEdge() const {
+        std::vector<std::vector<size_t>> groups;
+        for (size_t id : SortedIds()) {
+            if (groups.empty() || edges_[offsets_[groups.back().front()]] != edges_[offsets_[id]])
+                groups.emplace_back();
+            groups.back().push_back(id);
+        }
+        return groups;
     }
 
 public:
     PathStorage(const Graph &g)
             : g_(g),
-              inner_index_(),
-              size_(0) {
-    }
-
-    PathStorage(const PathStorage & p)
-            : g_(p.g_),
-              inner_index_(),
-              size_(0) {
-        for (auto iter = p.inner_index_.begin(); iter != p.inner_index_.end();
-                iter++) {
-            for (auto j_iter = iter->second.begin();
-                    j_iter != iter->second.end(); j_iter++) {
-                this->AddPath(j_iter->path(), (int) j_iter->weight());
-            }
-        }
+              offsets_(1, 0) {
     }
 
-    void ReplaceEdges(std::map<EdgeId, EdgeId> &old_to_new){
-        std::map<int, EdgeId> tmp_map;
-//        for (auto iter = g_.SmartEdgeBegin(); !iter.IsEnd(); ++iter ){
-//            tmp_map[g_.int_id(*iter)] = *iter;
-//        }
-        InnerIndex new_index;
-        for (auto iter = inner_index_.begin(); iter != inner_index_.end(); iter++) {
-            auto tmp = iter->second;
-            EdgeId new_first;
-            if (old_to_new.find(iter->first) == old_to_new.end())
-                new_first = iter->first;
-            else {
-                DEBUG("new first edge: "<< g_.int_id(old_to_new[iter->first]) << " with " << tmp.size() << " edges ");
-                new_first = old_to_new[iter->first];
-            }
-            std::set<PathInfo<Graph>> new_tmp;
-            for (auto j_iter = tmp.begin(); j_iter != tmp.end(); j_iter++) {
-                PathInfo<Graph> pi = *(j_iter);
-                for (size_t k = 0; k < pi.path().size(); k++)
-                    if (old_to_new.find(pi.path()[k]) != old_to_new.end()) {
-//                        INFO(g_.int_id(old_to_new[pi.path[k]]));
-                        pi.path()[k] = old_to_new[pi.path()[k]];
-                    }
-                DEBUG(pi.str(g_));
-                new_tmp.insert(pi);
+    PathStorage(const PathStorage &p) = default;
 
+    void ReplaceEdges(std::map<EdgeId, EdgeId> &old_to_new){
+        PathStorage<Graph> replaced(g_);
+        std::vector<EdgeId> path;
+        for (size_t id : SortedIds()) {
+            path.assign(path_begin(id), path_end(id));
+            for (EdgeId &e : path) {
+                auto it = old_to_new.find(e);
+                if (it != old_to_new.end())
+                    e = it->second;
             }
-            if (new_first != iter->first) {
-                TRACE("and mmew_tmp.size: "<< new_tmp.size());
-            }
-            if (new_index.find(new_first) == new_index.end()) {
-                new_index[new_first] = new_tmp;
-            } else {
-                for (auto j_iter = new_tmp.begin(); j_iter != new_tmp.end(); j_iter++) {
-                    new_index[new_first].insert(*j_iter);
-                }
-            }
-
+            DEBUG(PathInfo<Graph>(path, weights_[id]).str(g_));
+            // Paths which became equal are not merged, the first one is kept
+            uint64_t hash = Hash(path.begin(), path.end());
+            if (replaced.Find(path.begin(), path.end(), hash) == kNoPath)
+                replaced.Insert(path.begin(), path.end(), hash, weights_[id]);
         }
-
-        inner_index_ = new_index;
+        std::swap(edges_, replaced.edges_);
+        std::swap(offsets_, replaced.offsets_);
+        std::swap(weights_, replaced.weights_);
+        std::swap(heads_, replaced.heads_);
+        std::swap(next_, replaced.next_);
+        coverage_offsets_.clear();
+        coverage_paths_.clear();
     }
 
     void AddPath(const std::vector<EdgeId> &p, int w, bool add_rc = false) {
-        HiddenAddPath(p, w);
+        VERIFY(w >= 0);
+        HiddenAddPath(p.begin(), p.end(), size_t(w));
         if (add_rc) {
             std::vector<EdgeId> rc_p(p.size());
             for (size_t i = 0; i < p.size(); i++)
                 rc_p[i] = g_.conjugate(p[p.size() - 1 - i]);
-            HiddenAddPath(rc_p, w);
+            HiddenAddPath(rc_p.begin(), rc_p.end(), size_t(w));
         }
     }
 
@@ -164,21 +215,22 @@ public:
 
     void BinWrite(std::ostream &str) const {
         using io::binary::BinWrite;
-        BinWrite(str, inner_index_.size());
-        for (const auto &i : inner_index_) {
-            BinWrite(str, (size_t)i.second.size());
-            for (const auto &j : i.second) {
-                BinWrite(str, j.weight());
-                BinWrite(str, j.path().size());
-                for (const auto &p : j.path()) {
-                    BinWrite(str, g_.int_id(p));
+        auto groups = GroupByFirstEdge();
+        BinWrite(str, groups.size());
+        for (const auto &group : groups) {
+            BinWrite(str, group.size());
+            for (size_t id : group) {
+                BinWrite(str, weights_[id]);
+                BinWrite(str, size_t(offsets_[id + 1] - offsets_[id]));
+                for (auto it = path_begin(id); it != path_end(id); ++it) {
+                    BinWrite(str, g_.int_id(*it));
                 }
             }
         }
     }
 
     void BinRead(std::istream &str) {
-        inner_index_.clear();
+        Clear();
         using io::binary::BinRead;
 
         auto size = BinRead<size_t>(str);
@@ -193,7 +245,7 @@ public:
                     auto eid = BinRead<uint64_t>(str);
                     path.push_back(eid);
                 }
-                AddPath(path, (int)weight);
+                HiddenAddPath(path.begin(), path.end(), weight);
             }
         }
     }
@@ -203,17 +255,18 @@ public:
         std::ofstream filestr(filename);
         std::set<EdgeId> continued_edges;
 
-        for(auto iter = inner_index_.begin(); iter != inner_index_.end(); ++iter){
-            filestr << iter->second.size() << std::endl;
+        for (const auto &group : GroupByFirstEdge()) {
+            filestr << group.size() << std::endl;
             int non1 = 0;
-            for (auto j_iter = iter->second.begin(); j_iter != iter->second.end(); ++j_iter) {
-                filestr << " Weight: " << j_iter->weight();
-                if (j_iter->weight() > stats_weight_cutoff)
+            for (size_t id : group) {
+                size_t weight = weights_[id];
+                filestr << " Weight: " << weight;
+                if (weight > stats_weight_cutoff)
                     non1++;
 
-                filestr << " length: " << j_iter->path().size() << " ";
-                for (auto p_iter = j_iter->path().begin(); p_iter != j_iter->path().end(); ++p_iter) {
-                    if (p_iter != j_iter->path().end() - 1 && j_iter->weight() > stats_weight_cutoff) {
+                filestr << " length: " << offsets_[id + 1] - offsets_[id] << " ";
+                for (auto p_iter = path_begin(id); p_iter != path_end(id); ++p_iter) {
+                    if (p_iter != path_end(id) - 1 && weight > stats_weight_cutoff) {
                         continued_edges.insert(*p_iter);
                     }
 
@@ -257,11 +310,9 @@ public:
     }
 
     void SaveAllPaths(std::vector<PathInfo<Graph>> &res) const {
-        for (auto iter = inner_index_.begin(); iter != inner_index_.end(); ++iter) {
-            for (auto j_iter = iter->second.begin(); j_iter != iter->second.end(); ++j_iter) {
-                res.push_back(*j_iter);
-            }
-        }
+        res.reserve(res.size() + size());
+        for (size_t id : SortedIds())
+            res.emplace_back(std::vector<EdgeId>(path_begin(id), path_end(id)), weights_[id]);
     }
 
     void LoadFromFile(const std::string &s, bool force_exists = true) {
@@ -316,35 +367,109 @@ public:
         INFO("Loading finished.");
     }
 
-    void AddStorage(PathStorage<Graph> &to_add) {
-        for (auto iter = to_add.inner_index_.begin(); iter != to_add.inner_index_.end(); iter++) {
-            for(auto j_iter = iter->second.begin(); j_iter != iter->second.end(); j_iter ++) {
-                this->AddPath(j_iter->path(), (int) j_iter->weight());
-            }
-        }
+    void AddStorage(const PathStorage<Graph> &to_add) {
+        for (size_t id = 0; id < to_add.size(); ++id)
+            HiddenAddPath(to_add.path_begin(id), to_add.path_end(id), to_add.weights_[id]);
     }
 
     void Clear() {
-        inner_index_.clear();
-        size_ = 0;
+        edges_.clear();
+        offsets_.assign(1, 0);
+        weights_.clear();
+        heads_.clear();
+        next_.clear();
+        coverage_offsets_.clear();
+        coverage_paths_.clear();
     }
 
     size_t size() const {
-        return size_;
-    }
-
-//    typename InnerIndex::iterator begin() const {
-//        return inner_index.begin();
-//    }
-//
-//    typename InnerIndex::iterator end() const {
-//        return inner_index.end();
-//    }
-//    typename InnerIndex::iterator operator*(){
-//        return this->first;
-//    }
-private:
-    size_t size_;
+        return weights_.size();
+    }
+
+    /// Edges of the id-th path, ids are in [0, size())
+    adt::iterator_range<EdgeIterator> path(size_t id) const {
+        return adt::make_range(path_begin(id), path_end(id));
+    }
+
+    size_t weight(size_t id) const {
+        return weights_[id];
+    }
+
+    /**
+     * @brief Builds the per-edge index for the coverage queries below.
+     *        The paths are renumbered into the lexicographic order first, paths with
+     *        less than min_path_size edges are left out of the index.
+     *        Any addition of a new path invalidates it.
+     */
+    void BuildCoverageIndex(size_t min_path_size = 1) {
+        PathStorage<Graph> sorted(g_);
+        sorted.edges_.reserve(edges_.size());
+        sorted.offsets_.reserve(offsets_.size());
+        sorted.weights_.reserve(weights_.size());
+        sorted.next_.reserve(next_.size());
+        for (size_t id : SortedIds())
+            sorted.Insert(path_begin(id), path_end(id), Hash(path_begin(id), path_end(id)), weights_[id]);
+        std::swap(edges_, sorted.edges_);
+        std::swap(offsets_, sorted.offsets_);
+        std::swap(weights_, sorted.weights_);
+        std::swap(heads_, sorted.heads_);
+        std::swap(next_, sorted.next_);
+
+        size_t max_id = 0;
+        for (EdgeId e : edges_)
+            max_id = std::max<size_t>(max_id, e.int_id());
+
+        coverage_offsets_.assign(max_id + 2, 0);
+        coverage_paths_.clear();
+        // Paths are counted once per edge, even if they go through it several times
+        std::vector<size_t> last_path(max_id + 1, size_t(kNoPath));
+        for (size_t id = 0; id < size(); ++id) {
+            if (size_t(path_end(id) - path_begin(id)) < min_path_size)
+                continue;
+            for (auto it = path_begin(id); it != path_end(id); ++it) {
+                size_t e = it->int_id();
+                if (last_path[e] != id) {
+                    last_path[e] = id;
+                    coverage_offsets_[e + 1] += 1;
+                }
+            }
+        }
+        std::partial_sum(coverage_offsets_.begin(), coverage_offsets_.end(), coverage_offsets_.begin());
+
+        coverage_paths_.resize(coverage_offsets_.back());
+        std::vector<size_t> pos(coverage_offsets_.begin(), coverage_offsets_.end() - 1);
+        std::fill(last_path.begin(), last_path.end(), size_t(kNoPath));
+        for (size_t id = 0; id < size(); ++id) {
+            if (size_t(path_end(id) - path_begin(id)) < min_path_size)
+                continue;
+            for (auto it = path_begin(id); it != path_end(id); ++it) {
+                size_t e = it->int_id();
+                if (last_path[e] != id) {
+                    last_path[e] = id;
+                    coverage_paths_[pos[e]++] = id;
+                }
+            }
+        }
+    }
+
+    bool HasCoverageIndex() const {
+        return !coverage_offsets_.empty() || edges_.empty();
+    }
+
+    /// Ids of the indexed paths going through the edge (in ascending order)
+    adt::iterator_range<std::vector<size_t>::const_iterator> GetCoveringPaths(EdgeId e) const {
+        VERIFY_MSG(HasCoverageIndex(), "Coverage index should be built first");
+        size_t id = e.int_id();
+        if (id + 1 >= coverage_offsets_.size())
+            return adt::make_range(coverage_paths_.end(), coverage_paths_.end());
+        return adt::make_range(coverage_paths_.begin() + coverage_offsets_[id],
+                               coverage_paths_.begin() + coverage_offsets_[id + 1]);
+    }
+
+    size_t GetCoverage(EdgeId e) const {
+        auto paths = GetCoveringPaths(e);
+        return paths.end() - paths.begin();
+    }
 };
 
 template<class Graph>
@@ -43,6 +43,12 @@ class GAligner {
            const alignment::BWAIndex::AlignmentMode &mode)
     : pac_index_(g, pb_config, mode), g_(g), pb_config_(pb_config), restore_ends_(false), gap_filler_(g, GAlignerConfig(pb_config, mode)) {}
 
+  void CollectStats(StatsCounter &stats) const {
+    stats.gap_fill_cache_hits = gap_filler_.cache().hits();
+    stats.gap_fill_cache_misses = gap_filler_.cache().misses();
+    stats.gap_fill_cache_evictions = gap_filler_.cache().evictions();
+  }
+
 
  private:
   PacBioMappingIndex pac_index_;
@@ -10,6 +10,38 @@ namespace sensitive_aligner {
 
 using namespace std;
 
+constexpr int StateQueue::NOT_QUEUED;
+
+void StateQueue::Push(size_t id, int score, const States &states) {
+    if (id >= scores_.size())
+        scores_.resize(id + 1, NOT_QUEUED);
+    if (scores_[id] == NOT_QUEUED)
+        ++ size_;
+    scores_[id] = score;
+    heap_.emplace_back(score, id);
+    std::push_heap(heap_.begin(), heap_.end(), Order(states));
+}
+
+void StateQueue::Remove(size_t id) {
+    if (id < scores_.size() && scores_[id] != NOT_QUEUED) {
+        scores_[id] = NOT_QUEUED;
+        -- size_;
+    }
+}
+
+size_t StateQueue::Pop(const States &states) {
+    VERIFY(size_ > 0);
+    while (true) {
+        std::pop_heap(heap_.begin(), heap_.end(), Order(states));
+        Entry entry = heap_.back();
+        heap_.pop_back();
+        if (scores_[entry.second] == entry.first) {
+            Remove(entry.second);
+            return entry.second;
+        }
+    }
+}
+
 const int DijkstraGraphSequenceBase::SHORT_SEQ_LENGTH;
 const int DijkstraGraphSequenceBase::ED_DEVIATION;
 
@@ -30,29 +62,49 @@ bool DijkstraGraphSequenceBase::IsBetter(int seq_ind, int ed) {
     return false;
 }
 
+size_t DijkstraGraphSequenceBase::StateId(const QueueState &state) {
+    auto res = state_ids_.emplace(state, states_.size());
+    if (res.second) {
+        states_.push_back(state);
+        scores_.push_back(0);
+        prev_states_.push_back(QueueState());
+    }
+    return res.first->second;
+}
+
+const string &DijkstraGraphSequenceBase::EdgeSeq(EdgeId e) {
+    auto it = edge_seqs_.find(e);
+    if (it == edge_seqs_.end())
+        it = edge_seqs_.emplace(e, g_.EdgeNucls(e).str()).first;
+    return it->second;
+}
+
 void DijkstraGraphSequenceBase::Update(const QueueState &state, const QueueState &prev_state, int score) {
-    if (visited_.count(state) > 0) {
-        if (visited_[state] >= score) {
+    auto it = state_ids_.find(state);
+    if (it != state_ids_.end()) {
+        size_t id = it->second;
+        if (scores_[id] >= score) {
             ++ updates_;
-            q_.erase(make_pair(visited_[state], state));
+            q_.Remove(id);
             if (IsBetter(state.i, score)) {
-                q_.insert(make_pair(score, state));
-                visited_[state] = score;
-                prev_states_[state] = prev_state;
+                scores_[id] = score;
+                prev_states_[id] = prev_state;
+                q_.Push(id, score, states_);
             }
         }
     } else {
         if (IsBetter(state.i, score)) {
             ++ updates_;
-            visited_.insert(make_pair(state, score));
-            prev_states_.insert(make_pair(state, prev_state));
-            q_.insert(make_pair(score, state));
+            size_t id = StateId(state);
+            scores_[id] = score;
+            prev_states_[id] = prev_state;
+            q_.Push(id, score, states_);
         }
     }
 }
 
 void DijkstraGraphSequenceBase::AddNewEdge(const GraphState &gs, const QueueState &prev_state, int ed) {
-    string edge_str = g_.EdgeNucls(gs.e).Subseq(gs.start_pos, gs.end_pos).str();
+    string edge_str = EdgeSeq(gs.e).substr(gs.start_pos, gs.end_pos - gs.start_pos);
     if (0 == edge_str.size()) {
         QueueState state(gs, prev_state.i);
         Update(state, prev_state,  ed);
@@ -102,15 +154,15 @@ bool DijkstraGraphSequenceBase::RunDijkstra() {
     size_t iter = 0;
     QueueState cur_state;
     int ed = 0;
-    while (q_.size() > 0 &&
+    while (!q_.empty() &&
             !QueueLimitsExceeded(iter) &&
             ed <= path_max_length_ &&
             updates_ < gap_cfg_.updates_limit) {
-        cur_state = q_.begin()->second;
-        ed = visited_[cur_state];
+        size_t id = q_.Pop(states_);
+        cur_state = states_[id];
+        ed = scores_[id];
         ++ iter;
-        q_.erase(q_.begin());
-        if (visited_.count(end_qstate_) > 0) {
+        if (state_ids_.count(end_qstate_) > 0) {
             found_path = true;
         }
         if (IsEndPosition(cur_state)) {
@@ -136,13 +188,14 @@ void DijkstraGraphSequenceBase::CloseGap() {
     if (found_path) {
         QueueState state(end_qstate_);
         while (!state.empty()) {
-            min_score_ = visited_[end_qstate_];
-            int start_edge = prev_states_[state].i;
+            min_score_ = scores_[StateId(end_qstate_)];
+            const QueueState &prev_state = prev_states_[StateId(state)];
+            int start_edge = prev_state.i;
             int end_edge =  state.i;
             mapping_path_.push_back(state.gs.e,
                                     omnigraph::MappingRange(Range(start_edge, end_edge),
                                             Range(state.gs.start_pos, state.gs.end_pos) ));
-            state = prev_states_[state];
+            state = prev_state;
         }
         mapping_path_.reverse();
     }
@@ -160,7 +213,7 @@ bool DijkstraGapFiller::AddState(const QueueState &cur_state, EdgeId e, int ed)
         }
         if (e == end_e_ && path_max_length_ - ed >= 0) {
             string seq_str = ss_.substr(cur_state.i);
-            string edge_str = g_.EdgeNucls(e).Subseq(0, end_p_).str();
+            string edge_str = EdgeSeq(e).substr(0, end_p_);
             int score = StringDistance(seq_str, edge_str, path_max_length_ - ed);
             if (score != numeric_limits<int>::max()) {
                 path_max_length_ = min(path_max_length_, ed + score);
@@ -196,7 +249,7 @@ bool DijkstraEndsReconstructor::AddState(const QueueState &cur_state, EdgeId e,
     size_t remaining = ss_.size() - cur_state.i;
     if (g_.length(e) + g_.k() + path_max_length_ - ed > remaining && path_max_length_ - ed >= 0) {
         string seq_str = ss_.substr(cur_state.i);
-        string edge_str = g_.EdgeNucls(e).str();
+        const string &edge_str = EdgeSeq(e);
         int position = -1;
         int score = SHWDistance(seq_str, edge_str, path_max_length_ - ed, position);
         if (score != numeric_limits<int>::max()) {
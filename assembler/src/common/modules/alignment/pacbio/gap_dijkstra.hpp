@@ -12,6 +12,10 @@
 #include "sequence/sequence_tools.hpp"
 #include "utils/perf/perfcounter.hpp"
 
+#include <parallel_hashmap/phmap.h>
+
+#include <algorithm>
+
 namespace sensitive_aligner {
 
 using debruijn_graph::EdgeId;
@@ -143,6 +147,56 @@ struct hash<sensitive_aligner::QueueState> {
 
 namespace sensitive_aligner {
 
+// Queue of the Dijkstra states numbered by the owner, who also keeps the
+// states themselves. The smallest score goes first, ties are broken by the
+// state order, just like with the std::set of (score, state) pairs used
+// before. It is a binary heap with lazy deletion: the entries of the states
+// removed or queued again with another score since are skipped on pop.
+class StateQueue {
+  public:
+    typedef std::vector<QueueState> States;
+
+    void Push(size_t id, int score, const States &states);
+
+    // Does nothing if the state is not queued
+    void Remove(size_t id);
+
+    size_t Pop(const States &states);
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+  private:
+    typedef std::pair<int, size_t> Entry;
+
+    class Order {
+      public:
+        Order(const States &states)
+            : states_(states) {}
+
+        bool operator()(const Entry &a, const Entry &b) const {
+            if (a.first != b.first)
+                return a.first > b.first;
+            return states_[b.second] < states_[a.second];
+        }
+
+      private:
+        const States &states_;
+    };
+
+    static constexpr int NOT_QUEUED = std::numeric_limits<int>::min();
+
+    std::vector<Entry> heap_;
+    // Score the state is queued with, NOT_QUEUED if it is not
+    std::vector<int> scores_;
+    size_t size_ = 0;
+};
+
 class DijkstraGraphSequenceBase {
   public:
     DijkstraGraphSequenceBase(const debruijn_graph::Graph &g,
@@ -211,6 +265,9 @@ class DijkstraGraphSequenceBase {
 
     bool RunDijkstra();
 
+    // Nucleotides of the whole edge, extracted once per edge
+    const std::string &EdgeSeq(EdgeId e);
+
     virtual bool AddState(const QueueState &cur_state, EdgeId e, int ed) = 0;
 
     virtual bool IsEndPosition(const QueueState &cur_state) = 0;
@@ -234,14 +291,22 @@ class DijkstraGraphSequenceBase {
     static const int SHORT_SEQ_LENGTH = 100;
     static const int ED_DEVIATION = 20;
 
-    std::set<std::pair<int, QueueState>> q_;
-    std::unordered_map<QueueState, int> visited_;
-    std::unordered_map<QueueState, QueueState> prev_states_;
+    size_t StateId(const QueueState &state);
+
+    // States are numbered in the order they are reached, the per-state data is
+    // kept in the dense arrays indexed by the state number
+    phmap::flat_hash_map<QueueState, size_t> state_ids_;
+    std::vector<QueueState> states_;
+    std::vector<int> scores_;
+    std::vector<QueueState> prev_states_;
     std::vector<int> best_ed_;
+    phmap::node_hash_map<EdgeId, std::string> edge_seqs_;
 
     const size_t queue_limit_;
     const size_t iter_limit_;
     size_t updates_;
+
+    StateQueue q_;
 };
 
 
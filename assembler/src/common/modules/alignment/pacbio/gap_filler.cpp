@@ -175,6 +175,15 @@ GapFillerResult GapFiller::Run(const string &s,
                                const GraphPosition &start_pos,
                                const GraphPosition &end_pos,
                                int path_min_length, int path_max_length) const {
+    return cache_.Get(s, start_pos, end_pos, path_min_length, path_max_length, [&]() {
+        return FillGap(s, start_pos, end_pos, path_min_length, path_max_length);
+    });
+}
+
+GapFillerResult GapFiller::FillGap(const string &s,
+                                   const GraphPosition &start_pos,
+                                   const GraphPosition &end_pos,
+                                   int path_min_length, int path_max_length) const {
     utils::perf_counter pc;
     GapClosingConfig gap_cfg = cfg_.gap_cfg;
     auto bf_res = BestScoredPathBruteForce(s, start_pos, end_pos, path_min_length, path_max_length);
@@ -14,6 +14,15 @@
 #include "modules/alignment/bwa_index.hpp"
 #include "modules/alignment/pacbio/gap_dijkstra.hpp"
 
+#include <parallel_hashmap/phmap.h>
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 namespace sensitive_aligner {
 using debruijn_graph::EdgeId;
 using debruijn_graph::VertexId;
@@ -81,6 +90,158 @@ struct GraphPosition {
         edgeid(edgeid_), position(position_) {}
 };
 
+// Results of gap filling between two graph positions. Similar reads (e.g. the
+// ones from high-copy plasmids or repeats) fill the same gaps with the same
+// sequences over and over. The result depends on everything in the key, so
+// the gap sequences are compared entirely. Sharded, so it could be shared
+// between threads; every shard keeps its least recently used gaps within
+// its part of the memory limit.
+class GapFillerCache {
+  public:
+    static constexpr size_t DEFAULT_MAX_BYTES = size_t(256) << 20;
+    static constexpr size_t DEFAULT_SHARDS = 64;
+
+    explicit GapFillerCache(size_t max_bytes = DEFAULT_MAX_BYTES, size_t shards = DEFAULT_SHARDS)
+        : shard_count_(shards), shard_max_bytes_(max_bytes / shards), shards_(new Shard[shards]),
+          hits_(0), misses_(0), evictions_(0) {
+        VERIFY(shards > 0);
+    }
+
+    /// Returns the cached result of the gap, calling fill() on the first query
+    template<class Fill>
+    GapFillerResult Get(const std::string &s,
+                        const GraphPosition &start_pos,
+                        const GraphPosition &end_pos,
+                        int path_min_length, int path_max_length, Fill fill) const {
+        // Probe with the caller's sequence, it is only copied when inserted
+        KeyRef key{start_pos.edgeid, start_pos.position, end_pos.edgeid, end_pos.position,
+                   path_min_length, path_max_length, &s};
+        Shard &shard = shards_[KeyHash()(key) % shard_count_];
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.map.find(key);
+            if (it != shard.map.end()) {
+                hits_ += 1;
+                shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+                return it->second->result;
+            }
+        }
+
+        GapFillerResult result = fill();
+        misses_ += 1;
+
+        size_t bytes = EntryBytes(s.size(), result);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        // Another thread could have filled the same gap meanwhile
+        if (bytes > shard_max_bytes_ || shard.map.count(key))
+            return result;
+
+        while (shard.bytes + bytes > shard_max_bytes_) {
+            const Entry &last = shard.lru.back();
+            shard.bytes -= EntryBytes(last.seq.size(), last.result);
+            shard.map.erase(last.key());
+            shard.lru.pop_back();
+            evictions_ += 1;
+        }
+        shard.lru.push_front(Entry{key, s, result});
+        shard.map.emplace(shard.lru.front().key(), shard.lru.begin());
+        shard.bytes += bytes;
+        return result;
+    }
+
+    size_t hits() const { return hits_; }
+    size_t misses() const { return misses_; }
+    size_t evictions() const { return evictions_; }
+
+    /// Number of the gaps kept
+    size_t size() const {
+        size_t res = 0;
+        for (size_t i = 0; i < shard_count_; ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            res += shards_[i].lru.size();
+        }
+        return res;
+    }
+
+    /// Estimated memory taken by the gaps kept
+    size_t bytes() const {
+        size_t res = 0;
+        for (size_t i = 0; i < shard_count_; ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            res += shards_[i].bytes;
+        }
+        return res;
+    }
+
+  private:
+    // Does not own the gap sequence: the map keys refer either to the
+    // sequences stored in the list or, while probing, to the query one
+    struct KeyRef {
+        EdgeId start_e;
+        size_t start_p;
+        EdgeId end_e;
+        size_t end_p;
+        int path_min_length;
+        int path_max_length;
+        const std::string *seq;
+
+        bool operator==(const KeyRef &other) const {
+            return start_e == other.start_e && start_p == other.start_p &&
+                   end_e == other.end_e && end_p == other.end_p &&
+                   path_min_length == other.path_min_length &&
+                   path_max_length == other.path_max_length &&
+                   *seq == *other.seq;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const KeyRef &key) const {
+            return phmap::HashState().combine(0, key.start_e.int_id(), key.start_p,
+                                              key.end_e.int_id(), key.end_p,
+                                              key.path_min_length, key.path_max_length, *key.seq);
+        }
+    };
+
+    struct Entry {
+        Entry(const KeyRef &key, const std::string &s, const GapFillerResult &r)
+                : pos(key), seq(s), result(r) {}
+
+        KeyRef key() const {
+            KeyRef res = pos;
+            res.seq = &seq;
+            return res;
+        }
+
+        KeyRef pos;
+        std::string seq;
+        GapFillerResult result;
+    };
+
+    typedef std::list<Entry> Entries;
+
+    // Rough estimate of the memory taken by the entry including the list
+    // node and the hash map node
+    static size_t EntryBytes(size_t seq_size, const GapFillerResult &result) {
+        return sizeof(Entry) + seq_size +
+               result.full_intermediate_path.size() * sizeof(EdgeId) + 6 * sizeof(void*);
+    }
+
+    // Most recently used gaps are at the front of the list
+    struct Shard {
+        std::mutex mutex;
+        Entries lru;
+        std::unordered_map<KeyRef, Entries::iterator, KeyHash> map;
+        size_t bytes = 0;
+    };
+
+    size_t shard_count_;
+    size_t shard_max_bytes_;
+    std::unique_ptr<Shard[]> shards_;
+    mutable std::atomic<size_t> hits_;
+    mutable std::atomic<size_t> misses_;
+    mutable std::atomic<size_t> evictions_;
+};
+
 class GapFiller {
   public:
 
@@ -99,8 +260,17 @@ class GapFiller {
                         std::vector<debruijn_graph::EdgeId> &path,
                         PathRange &range) const;
 
+    const GapFillerCache &cache() const {
+        return cache_;
+    }
+
   private:
 
+    GapFillerResult FillGap(const std::string &s,
+                            const GraphPosition &start_pos,
+                            const GraphPosition &end_pos,
+                            int path_min_length, int path_max_length) const;
+
     std::string PathToString(std::vector<EdgeId> &path) const;
 
     GapFillerResult BestScoredPathDijkstra(const std::string &s,
@@ -121,6 +291,7 @@ class GapFiller {
 
     const debruijn_graph::Graph &g_;
     const GAlignerConfig cfg_;
+    GapFillerCache cache_;
 };
 
 
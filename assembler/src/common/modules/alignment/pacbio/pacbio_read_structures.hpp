@@ -118,14 +118,23 @@ class StatsCounter {
     size_t reads_with_conjugate;
     size_t subreads_count;
     std::map<size_t, size_t> seeds_percentage;
+    size_t gap_fill_cache_hits;
+    size_t gap_fill_cache_misses;
+    size_t gap_fill_cache_evictions;
     StatsCounter() {
         total_len = 0;
         reads_with_conjugate = 0;
+        gap_fill_cache_hits = 0;
+        gap_fill_cache_misses = 0;
+        gap_fill_cache_evictions = 0;
     }
 
     void AddStorage(StatsCounter &other) {
         total_len += other.total_len;
         reads_with_conjugate += other.reads_with_conjugate;
+        gap_fill_cache_hits += other.gap_fill_cache_hits;
+        gap_fill_cache_misses += other.gap_fill_cache_misses;
+        gap_fill_cache_evictions += other.gap_fill_cache_evictions;
         for (auto iter = other.subreads_length.begin(); iter != other.subreads_length.end(); ++iter) {
             subreads_length.push_back(*iter);
         }
@@ -161,6 +170,16 @@ class StatsCounter {
             if (cur * 2 > total) break;
         }
         INFO("Median fraction of present seeds in maximal alignmnent among reads aligned to the graph: " << double(percentage) * 0.001);
+        ReportGapFillCache();
+    }
+
+    void ReportGapFillCache() const {
+        size_t queries = gap_fill_cache_hits + gap_fill_cache_misses;
+        if (queries == 0)
+            return;
+        INFO("Gap filling cache hits: " << gap_fill_cache_hits << " of " << queries << " queries ("
+             << double(gap_fill_cache_hits) * 100. / double(queries) << "%), "
+             << gap_fill_cache_evictions << " gaps evicted");
     }
 
   private:
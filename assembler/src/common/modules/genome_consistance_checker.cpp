@@ -101,18 +101,18 @@ void GenomeConsistenceChecker::ReportVariants(vector<pair<double, EdgeId>> &sort
     }
 }
 
-void GenomeConsistenceChecker::ReportPathEndByLongLib(const path_extend::BidirectionalPathSet &covering_paths,
+void GenomeConsistenceChecker::ReportPathEndByLongLib(const vector<path_extend::LongReadPath> &covering_paths,
                                                       EdgeId current_edge) const {
     vector<pair<double, EdgeId>> sorted_w;
     for (const auto & cov_path: covering_paths) {
-        double w = cov_path->GetWeight();
+        double w = cov_path.GetWeight();
         map<EdgeId, double> next_weigths;
         if (math::gr(w, 1.0)) {
-            for (size_t p_ind = 0; p_ind < cov_path->Size(); p_ind++) {
-                if (cov_path->At(p_ind) == current_edge) {
-                    for (size_t p_ind2  = p_ind + 1; p_ind2 < cov_path->Size(); p_ind2++) {
-                        if (graph_.length(cov_path->At(p_ind2)) >= storage_.min_length() ) {
-                            next_weigths[cov_path->At(p_ind2)] += w;
+            for (size_t p_ind = 0; p_ind < cov_path.Size(); p_ind++) {
+                if (cov_path.At(p_ind) == current_edge) {
+                    for (size_t p_ind2  = p_ind + 1; p_ind2 < cov_path.Size(); p_ind2++) {
+                        if (graph_.length(cov_path.At(p_ind2)) >= storage_.min_length() ) {
+                            next_weigths[cov_path.At(p_ind2)] += w;
                         }
                     }
                     break;
@@ -184,13 +184,13 @@ size_t GenomeConsistenceChecker::GetSupportingPathCount(EdgeId e1, EdgeId e2, si
     auto covering_paths = long_reads_cov_map_[lib_index].GetCoveringPaths(e1);
     size_t res = 0;
     for (const auto & cov_path: covering_paths) {
-        double w = cov_path->GetWeight();
+        double w = cov_path.GetWeight();
         if (math::gr(w, 1.0)) {
-            for (size_t p_ind = 0; p_ind < cov_path->Size(); p_ind++) {
-                if (cov_path->At(p_ind) == e1) {
-                    for (size_t p_ind2 = p_ind + 1; p_ind2 < cov_path->Size(); p_ind2++) {
-                        if (storage_.IsUnique(cov_path->At(p_ind2))) {
-                            if (e2 == cov_path->At(p_ind2))
+            for (size_t p_ind = 0; p_ind < cov_path.Size(); p_ind++) {
+                if (cov_path.At(p_ind) == e1) {
+                    for (size_t p_ind2 = p_ind + 1; p_ind2 < cov_path.Size(); p_ind2++) {
+                        if (storage_.IsUnique(cov_path.At(p_ind2))) {
+                            if (e2 == cov_path.At(p_ind2))
                                 res += size_t(w);
                             break;
                         }
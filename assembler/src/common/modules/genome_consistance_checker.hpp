@@ -17,6 +17,7 @@
 #include "assembly_graph/paths/mapping_path.hpp"
 #include "assembly_graph/graph_support/scaff_supplementary.hpp"
 #include "modules/path_extend/pe_utils.hpp"
+#include "modules/path_extend/long_reads_coverage_map.hpp"
 #include "pipeline/config_struct.hpp"
 
 namespace debruijn_graph {
@@ -145,7 +146,7 @@ class GenomeConsistenceChecker {
     const size_t unresolvable_len_;
 
     const ScaffoldingUniqueEdgeStorage &storage_;
-    const std::vector<path_extend::GraphCoverageMap> &long_reads_cov_map_;
+    const std::vector<path_extend::LongReadsCoverageMap> &long_reads_cov_map_;
     static const size_t SIGNIFICANT_LENGTH_LOWER_LIMIT = 10000;
     GenomeInfo genome_info_;
     //Edges containing zero point for each reference
@@ -174,7 +175,7 @@ class GenomeConsistenceChecker {
 
     void ReportPathEndByPairedLib(const std::shared_ptr<path_extend::PairedInfoLibrary> paired_lib, EdgeId current_edge) const;
 
-    void ReportPathEndByLongLib(const path_extend::BidirectionalPathSet &covering_paths, EdgeId current_edge) const;
+    void ReportPathEndByLongLib(const std::vector<path_extend::LongReadPath> &covering_paths, EdgeId current_edge) const;
 
     void ReportEdge(EdgeId e, double w) const;
 
@@ -207,7 +208,7 @@ public:
                              double relative_max_gap /*= 0.2*/,
                              size_t unresolvable_len,
                              const ScaffoldingUniqueEdgeStorage &storage,
-                             const std::vector<path_extend::GraphCoverageMap> &long_reads_cov_map,
+                             const std::vector<path_extend::LongReadsCoverageMap> &long_reads_cov_map,
                              const io::DataSet<config::LibraryData> reads) :
             gp_(gp),
             graph_(gp.get_mutable<Graph>()),
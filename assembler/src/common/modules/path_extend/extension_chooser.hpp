@@ -10,6 +10,7 @@
 
 #include "weight_counter.hpp"
 #include "pe_utils.hpp"
+#include "long_reads_coverage_map.hpp"
 #include "assembly_graph/components/graph_component.hpp"
 #include "modules/alignment/rna/ss_coverage.hpp"
 
@@ -797,7 +798,7 @@ inline bool EdgeWithWeightCompareReverse(const std::pair<T, double>& p1,
 class LongReadsUniqueEdgeAnalyzer {
     DECL_LOGGER("LongReadsUniqueEdgeAnalyzer")
 public:
-    LongReadsUniqueEdgeAnalyzer(const Graph& g, const GraphCoverageMap& cov_map,
+    LongReadsUniqueEdgeAnalyzer(const Graph& g, const LongReadsCoverageMap& cov_map,
                                 double filter_threshold, double prior_threshold,
                                 size_t max_repeat_length, bool uneven_depth)
             : g_(g),
@@ -843,25 +844,25 @@ private:
             return false;
         }
 
-        if (cov_map_.size() == 0) {
+        if (cov_map_.empty()) {
             return false;
         }
         auto cov_paths = cov_map_.GetCoveringPaths(e);
         for (auto it1 = cov_paths.begin(); it1 != cov_paths.end(); ++it1) {
-            auto pos1 = (*it1)->FindAll(e);
+            auto pos1 = it1->FindAll(e);
             if (pos1.size() > 1) {
                 DEBUG("***not unique " << g_.int_id(e) << " len " << g_.length(e) << "***");
                 return false;
             }
             for (auto it2 = it1; it2 != cov_paths.end(); it2++) {
-                auto pos2 = (*it2)->FindAll(e);
+                auto pos2 = it2->FindAll(e);
                 if (pos2.size() > 1) {
                     DEBUG("***not unique " << g_.int_id(e) << " len " << g_.length(e) << "***");
                     return false;
                 }
-                if (!ConsistentPath(**it1, pos1[0], **it2, pos2[0])) {
+                if (!ConsistentPath(*it1, pos1[0], *it2, pos2[0])) {
                     DEBUG("Checking inconsistency");
-                    if (CheckInconsistence(**it1, pos1[0], **it2, pos2[0],
+                    if (CheckInconsistence(*it1, pos1[0], *it2, pos2[0],
                                            cov_paths)) {
                         DEBUG("***not unique " << g_.int_id(e) << " len " << g_.length(e) << "***");
                         return false;
@@ -873,8 +874,8 @@ private:
         return true;
     }
 
-    bool ConsistentPath(const BidirectionalPath& path1, size_t pos1,
-                        const BidirectionalPath& path2, size_t pos2) const {
+    bool ConsistentPath(const LongReadPath& path1, size_t pos1,
+                        const LongReadPath& path2, size_t pos2) const {
         return EqualBegins(path1, pos1, path2, pos2, false)
                 && EqualEnds(path1, pos1, path2, pos2, false);
     }
@@ -888,17 +889,14 @@ private:
         return true;
     }
 
-    bool CheckInconsistence(const BidirectionalPath& path1, size_t pos1,
-                            const BidirectionalPath& path2, size_t pos2,
-                            const BidirectionalPathSet& cov_paths) const {
+    bool CheckInconsistence(const LongReadPath& path1, size_t pos1,
+                            const LongReadPath& path2, size_t pos2,
+                            const std::vector<LongReadPath>& cov_paths) const {
         size_t first_diff_pos1 = FirstNotEqualPosition(path1, pos1, path2, pos2, false);
         size_t first_diff_pos2 = FirstNotEqualPosition(path2, pos2, path1, pos1, false);
         if (first_diff_pos1 != -1UL && first_diff_pos2 != -1UL) {
-            const BidirectionalPath cand1 = path1.SubPath(first_diff_pos1,
-                                                          pos1 + 1);
-            const BidirectionalPath cand2 = path2.SubPath(first_diff_pos2,
-                                                          pos2 + 1);
-            std::pair<double, double> weights = GetSubPathsWeights(cand1, cand2,
+            std::pair<double, double> weights = GetSubPathsWeights(path1, first_diff_pos1, pos1 + 1,
+                                                                   path2, first_diff_pos2, pos2 + 1,
                                                                    cov_paths);
             DEBUG("Not equal begin " << g_.int_id(path1.At(first_diff_pos1)) << " weight " << weights.first << "; " << g_.int_id(path2.At(first_diff_pos2)) << " weight " << weights.second);
             if (!SignificantlyDiffWeights(weights.first, weights.second)) {
@@ -909,11 +907,8 @@ private:
         size_t last_diff_pos1 = LastNotEqualPosition(path1, pos1, path2, pos2, false);
         size_t last_diff_pos2 = LastNotEqualPosition(path2, pos2, path1, pos1, false);
         if (last_diff_pos1 != -1UL) {
-            const BidirectionalPath cand1 = path1.SubPath(pos1,
-                                                          last_diff_pos1 + 1);
-            const BidirectionalPath cand2 = path2.SubPath(pos2,
-                                                          last_diff_pos2 + 1);
-            std::pair<double, double> weights = GetSubPathsWeights(cand1, cand2,
+            std::pair<double, double> weights = GetSubPathsWeights(path1, pos1, last_diff_pos1 + 1,
+                                                                   path2, pos2, last_diff_pos2 + 1,
                                                                    cov_paths);
             DEBUG("Not equal end " << g_.int_id(path1.At(last_diff_pos1)) << " weight " << weights.first << "; " << g_.int_id(path2.At(last_diff_pos2)) << " weight " << weights.second);
             if (!SignificantlyDiffWeights(weights.first, weights.second)) {
@@ -924,25 +919,30 @@ private:
         return false;
     }
 
-    std::pair<double, double> GetSubPathsWeights(const BidirectionalPath& cand1,
-                                                 const BidirectionalPath& cand2,
-                                                 const BidirectionalPathSet& cov_paths) const {
+    // Candidates are the subpaths [from, to) of the paths, to < from stands for the empty one
+    std::pair<double, double> GetSubPathsWeights(const LongReadPath& path1, size_t from1, size_t to1,
+                                                 const LongReadPath& path2, size_t from2, size_t to2,
+                                                 const std::vector<LongReadPath>& cov_paths) const {
         double weight1 = 0.0;
         double weight2 = 0.0;
-        for (const BidirectionalPath *path : cov_paths) {
-            if (ContainSubPath(*path, cand1)) {
-                weight1 += path->GetWeight();
-            } else if (ContainSubPath(*path, cand2)) {
-                weight2 += path->GetWeight();
+        for (const LongReadPath &path : cov_paths) {
+            if (ContainSubPath(path, path1, from1, to1)) {
+                weight1 += path.GetWeight();
+            } else if (ContainSubPath(path, path2, from2, to2)) {
+                weight2 += path.GetWeight();
             }
         }
         return std::make_pair(weight1, weight2);
     }
 
-    bool ContainSubPath(const BidirectionalPath& path,
-                        const BidirectionalPath& subpath) const {
-        for (size_t i = 0; i < path.Size(); ++i) {
-            if (path.CompareFrom(i, subpath))
+    bool ContainSubPath(const LongReadPath& path,
+                        const LongReadPath& subpath, size_t from, size_t to) const {
+        size_t length = from < to ? to - from : 0;
+        for (size_t i = 0; i + length <= path.Size() && i < path.Size(); ++i) {
+            size_t j = 0;
+            while (j < length && path.At(i + j) == subpath.At(from + j))
+                ++j;
+            if (j == length)
                 return true;
         }
         return false;
@@ -996,7 +996,7 @@ private:
     }
 
     const Graph& g_;
-    const GraphCoverageMap& cov_map_;
+    const LongReadsCoverageMap& cov_map_;
     double filter_threshold_;
     double prior_threshold_;
     std::set<EdgeId> unique_edges_;
@@ -1007,7 +1007,7 @@ private:
 class LongReadsRNAExtensionChooser : public ExtensionChooser {
 public:
     LongReadsRNAExtensionChooser(const Graph& g,
-                                 const GraphCoverageMap& read_paths_cov_map,
+                                 const LongReadsCoverageMap& read_paths_cov_map,
                                  double filtering_threshold,
                                  size_t min_significant_overlap)
         : ExtensionChooser(g),
@@ -1040,20 +1040,19 @@ public:
         std::set<EdgeId> filtered_candidates;
         auto support_paths = cov_map_.GetCoveringPaths(path.Back());
         DEBUG("Found " << support_paths.size() << " supporting paths");
-        for (auto it = support_paths.begin(); it != support_paths.end(); ++it) {
-            auto supporting_path = *it;
-            auto positions = supporting_path->FindAll(path.Back());
+        for (const LongReadPath &supporting_path : support_paths) {
+            auto positions = supporting_path.FindAll(path.Back());
 
             for (size_t i = 0; i < positions.size(); ++i) {
-                if ((int) positions[i] < (int) supporting_path->Size() - 1
-                    && EqualBegins(path, path.Size() - 1, *supporting_path, positions[i], false)) {
-                    DEBUG("Supporting path matches, Checking unique path_back for " << supporting_path->GetId());
+                if ((int) positions[i] < (int) supporting_path.Size() - 1
+                    && EqualBegins(path, path.Size() - 1, supporting_path, positions[i], false)) {
+                    DEBUG("Supporting path matches, Checking unique path_back for " << supporting_path.GetId());
 
-                    if (UniqueBackPath(*supporting_path, positions[i])) {
+                    if (UniqueBackPath(supporting_path, positions[i])) {
                         DEBUG("Success");
 
-                        EdgeId next = supporting_path->At(positions[i] + 1);
-                        weights_candidates[next] += supporting_path->GetWeight();
+                        EdgeId next = supporting_path.At(positions[i] + 1);
+                        weights_candidates[next] += supporting_path.GetWeight();
                         filtered_candidates.insert(next);
                     }
                 }
@@ -1082,7 +1081,7 @@ public:
 
 private:
 
-    bool UniqueBackPath(const BidirectionalPath& path, size_t pos) const {
+    bool UniqueBackPath(const LongReadPath& path, size_t pos) const {
         int int_pos = (int) pos;
         while (int_pos >= 0) {
             if (g_.length(path.At(int_pos)) >= min_significant_overlap_)
@@ -1100,7 +1099,7 @@ private:
 
     double filtering_threshold_;
     size_t min_significant_overlap_;
-    const GraphCoverageMap& cov_map_;
+    const LongReadsCoverageMap& cov_map_;
 
     DECL_LOGGER("LongReadsRNAExtensionChooser");
 };
@@ -1108,7 +1107,7 @@ private:
 class LongReadsExtensionChooser : public ExtensionChooser {
 public:
     LongReadsExtensionChooser(const Graph& g,
-                              const GraphCoverageMap& read_paths_cov_map,
+                              const LongReadsCoverageMap& read_paths_cov_map,
                               double filtering_threshold,
                               double weight_priority_threshold,
                               double unique_edge_priority_threshold,
@@ -1145,17 +1144,17 @@ public:
         DEBUG("Found " << support_paths.size() << " covering paths!!!");
         bool success = false;
         for (auto it = support_paths.begin(); it != support_paths.end(); ++it) {
-            auto positions = (*it)->FindAll(path.Back());
+            auto positions = it->FindAll(path.Back());
             for (size_t i = 0; i < positions.size(); ++i) {
-                if ((int) positions[i] < (int) (*it)->Size() - 1
-                        && EqualBegins(path, (int) path.Size() - 1, **it,
+                if ((int) positions[i] < (int) it->Size() - 1
+                        && EqualBegins(path, (int) path.Size() - 1, *it,
                                        positions[i], false)) {
-                    DEBUG("Checking unique path_back for " << (*it)->GetId());
+                    DEBUG("Checking unique path_back for " << it->GetId());
 
-                    if (UniqueBackPath(**it, positions[i])) {
+                    if (UniqueBackPath(*it, positions[i])) {
                         DEBUG("Success");
-                        EdgeId next = (*it)->At(positions[i] + 1);
-                        weights_cands[next] += (*it)->GetWeight();
+                        EdgeId next = it->At(positions[i] + 1);
+                        weights_cands[next] += it->GetWeight();
                         if (weights_cands[next] > 2) {
                             success = true;
                         }
@@ -1168,13 +1167,13 @@ public:
             std::map<EdgeId, int> next_variants;
             EdgeId second_candidate;
             for (auto it = support_paths.begin(); it != support_paths.end(); ++it) {
-                auto positions = (*it)->FindAll(path.Back());
+                auto positions = it->FindAll(path.Back());
                 for (size_t i = 0; i < positions.size(); ++i) {
-                    if ((int) positions[i] < (int) (*it)->Size() - 1
-                        && EqualBegins(path, (int) path.Size() - 1, **it,
+                    if ((int) positions[i] < (int) it->Size() - 1
+                        && EqualBegins(path, (int) path.Size() - 1, *it,
                                        positions[i], false)) {
-                            EdgeId next = (*it)->At(positions[i] + 1);
-                            next_variants[next] += (*it)->GetWeight();
+                            EdgeId next = it->At(positions[i] + 1);
+                            next_variants[next] += it->GetWeight();
                             second_candidate = next;
                     }
                 }
@@ -1221,7 +1220,7 @@ public:
 
 private:
 
-    bool UniqueBackPath(const BidirectionalPath& path, size_t pos) const {
+    bool UniqueBackPath(const LongReadPath& path, size_t pos) const {
         int int_pos = (int) pos;
         while (int_pos >= 0) {
             if (unique_edge_analyzer_.IsUnique(path.At(int_pos)) > 0 && g_.length(path.At(int_pos)) >= min_significant_overlap_)
@@ -1240,7 +1239,7 @@ private:
     double filtering_threshold_;
     double weight_priority_threshold_;
     size_t min_significant_overlap_;
-    const GraphCoverageMap& cov_map_;
+    const LongReadsCoverageMap& cov_map_;
     LongReadsUniqueEdgeAnalyzer unique_edge_analyzer_;
 
     DECL_LOGGER("LongReadsExtensionChooser");
@@ -1249,7 +1248,7 @@ private:
 class TrustedContigsExtensionChooser : public ExtensionChooser {
 public:
     TrustedContigsExtensionChooser(const Graph& g,
-                                    const GraphCoverageMap& read_paths_cov_map,
+                                    const LongReadsCoverageMap& read_paths_cov_map,
                                     double filtering_threshold,
                                     double weight_priority_threshold,
                                     double unique_edge_priority_threshold,
@@ -1309,22 +1308,22 @@ private:
     std::pair<bool, std::set<EdgeWithDistance>> GetCandidates(const BidirectionalPath &path,
                                              std::map<EdgeWithDistance, double> &weights_cands,
                                              size_t start_pos,
-                                             const std::function<std::pair<bool, size_t>(const BidirectionalPath&, size_t)> &comparator) const
+                                             const std::function<std::pair<bool, size_t>(const LongReadPath&, size_t)> &comparator) const
     {
         VERIFY(start_pos < path.Size());
         std::set<EdgeWithDistance> filtered_cands;
         auto support_paths = cov_map_.GetCoveringPaths(path[start_pos]);
         DEBUG("Found " << support_paths.size() << " covering paths!!!");
-        for (auto const & it : support_paths) {
-            for (auto pos : it->FindAll(path[start_pos])) {
-                if (pos + 1 < it->Size()) {
-                    auto tmp = comparator(*it, pos);
+        for (auto const & support_path : support_paths) {
+            for (auto pos : support_path.FindAll(path[start_pos])) {
+                if (pos + 1 < support_path.Size()) {
+                    auto tmp = comparator(support_path, pos);
                     auto& is_good_path = tmp.first;
                     auto& matched_len = tmp.second;
                     if (is_good_path) {
-                        auto gap = it->GapAt(pos + 1);
-                        EdgeWithDistance next = {it->At(pos + 1), gap.gap, std::move(gap.gap_seq)};
-                        weights_cands[next] += static_cast<double>(matched_len)*it->GetWeight();
+                        auto gap = support_path.GapAt(pos + 1);
+                        EdgeWithDistance next = {support_path.At(pos + 1), gap.gap, std::move(gap.gap_seq)};
+                        weights_cands[next] += static_cast<double>(matched_len)*support_path.GetWeight();
                         filtered_cands.insert(next);
                     }
                 }
@@ -1335,7 +1334,7 @@ private:
 
     std::set<EdgeWithDistance> GetHighQualityCandidats(const BidirectionalPath &path, std::map<EdgeWithDistance, double> &weights_cands) const {
         auto start_pos = path.Size() - 1;
-        auto comparator = [&path, start_pos, th = this] (const BidirectionalPath &coverage_path, size_t pos) {
+        auto comparator = [&path, start_pos, th = this] (const LongReadPath &coverage_path, size_t pos) {
             auto is_good_path = (FirstNotEqualPosition(path, start_pos, coverage_path, pos, false) == -1ul);
             auto matched_len = start_pos + 1;
             auto privilege_scalar = (th->HasUniqueEdge(path, 0, matched_len) ? 3 : 1);
@@ -1348,7 +1347,7 @@ private:
         DEBUG("Fallback mode");
         auto get_comparator = [&path, th = this](size_t start_pos){
             /// compares the two path prefixes from 'start_pos', might skip several nonunique edges
-            return [&path, start_pos, th] (const BidirectionalPath &coverage_path, size_t pos) {
+            return [&path, start_pos, th] (const LongReadPath &coverage_path, size_t pos) {
                 auto pos1 = static_cast<int>(start_pos);
                 auto pos2 = static_cast<int>(pos);
                 auto skipped_non_unique_edges = 0;
@@ -1387,7 +1386,8 @@ private:
         return unique_edge_analyzer_.IsUnique(edge) && g_.length(edge) >= min_significant_overlap_;
     }
 
-    bool HasUniqueEdge(const BidirectionalPath& path, size_t from, size_t len) const {
+    template<class Path>
+    bool HasUniqueEdge(const Path& path, size_t from, size_t len) const {
         for (size_t i = 0; i < len; ++i) {
             auto edge = path.At(from + i);
             if (IsUniqueEdge(edge))
@@ -1405,7 +1405,7 @@ private:
     double filtering_threshold_;
     double weight_priority_threshold_;
     size_t min_significant_overlap_;
-    const GraphCoverageMap& cov_map_;
+    const LongReadsCoverageMap& cov_map_;
     LongReadsUniqueEdgeAnalyzer unique_edge_analyzer_;
     bool use_low_quality_matching_;
 
@@ -10,6 +10,10 @@
 #include "assembly_graph/core/graph.hpp"
 #include "adt/flat_map.hpp"
 #include <parallel_hashmap/phmap.h>
+#include <array>
+#include <limits>
+#include <mutex>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -36,15 +40,60 @@ public:
         for (auto it = left_bound; it != right_bound; ++it)
             insert_size_distrib_[it->first] = double(it->second) / double(sum);
 
+        max_gap_ = std::numeric_limits<int>::min();
+        for (const auto &entry : insert_size_distrib_) {
+            if (entry.second > 0)
+                max_gap_ = std::max(max_gap_, entry.first - int(k_) - 2);
+        }
+
         PreCalculateNotTotalReadsWeight();
     }
 
+    /// No ideal (non-additive) paired info for edges at positive distance
+    /// separated by a gap longer than this: no insert spans it
+    int max_gap() const { return max_gap_; }
+
+    /// Lookups take a lock only in the concurrent mode, which has to be set
+    /// before a library is shared by the extenders of different threads
+    void set_concurrent(bool concurrent) {
+        if (concurrent == concurrent_)
+            return;
+        concurrent_ = concurrent;
+        if (concurrent_) {
+            for (const auto &entry : weights_)
+                pi_[KeyHash()(entry.first) % SHARDS].weights.insert(entry);
+            weights_.clear();
+        } else {
+            for (auto &shard : pi_) {
+                weights_.insert(shard.weights.begin(), shard.weights.end());
+                shard.weights.clear();
+            }
+        }
+    }
+
+    bool concurrent() const { return concurrent_; }
+
     double IdealPairedInfo(EdgeId e1, EdgeId e2, int dist, bool additive = false) const {
-        auto &weights = pi_[std::make_pair(g_.length(e1), g_.length(e2))];
-        auto entry = weights.insert(std::make_pair(dist, 0.));
-        if (entry.second)
-            entry.first->second = IdealPairedInfo(g_.length(e1), g_.length(e2), dist, additive);
-        return entry.first->second;
+        Key key(g_.length(e1), g_.length(e2), dist);
+        if (!concurrent_) {
+            auto it = weights_.find(key);
+            if (it == weights_.end())
+                it = weights_.emplace(key, IdealPairedInfo(std::get<0>(key), std::get<1>(key), dist, additive)).first;
+            return it->second;
+        }
+
+        Shard &shard = pi_[KeyHash()(key) % SHARDS];
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.weights.find(key);
+            if (it != shard.weights.end())
+                return it->second;
+        }
+
+        double weight = IdealPairedInfo(std::get<0>(key), std::get<1>(key), dist, additive);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.weights.emplace(key, weight);
+        return weight;
     }
 
     double IdealPairedInfo(size_t len1, size_t len2, int dist, bool additive = false) const {
@@ -109,21 +158,33 @@ private:
     const int d_min_;
     const int d_max_;
     size_t read_size_;
+    int max_gap_;
 
     using InsertSizeMap = adt::flat_map<int, double>;
     InsertSizeMap insert_size_distrib_;
     std::vector<double> not_total_weights_right_;
     std::vector<double> not_total_weights_left_;
 
-    struct PairHash {
-        size_t operator()(std::pair<size_t, size_t> pair) const {
-            return phmap::HashState().combine(0, pair.first, pair.second);
+    // Lengths of the edges and the distance between them
+    typedef std::tuple<size_t, size_t, int> Key;
+
+    struct KeyHash {
+        size_t operator()(const Key &key) const {
+            return phmap::HashState().combine(0, std::get<0>(key), std::get<1>(key), std::get<2>(key));
         }
     };
 
-    mutable phmap::parallel_node_hash_map<std::pair<size_t, size_t>,
-                                          phmap::flat_hash_map<int, double>,
-                                          PairHash> pi_;
+    typedef phmap::flat_hash_map<Key, double, KeyHash> WeightMap;
+
+    struct Shard {
+        std::mutex mutex;
+        WeightMap weights;
+    };
+
+    bool concurrent_ = false;
+    mutable WeightMap weights_;
+    static constexpr size_t SHARDS = 16;
+    mutable std::array<Shard, SHARDS> pi_;
 protected:
     DECL_LOGGER("PathExtendPI");
 };
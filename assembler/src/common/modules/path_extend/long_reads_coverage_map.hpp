@@ -0,0 +1,183 @@
+//***************************************************************************
+//* Copyright (c) 2021 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#pragma once
+
+#include "pe_utils.hpp"
+#include "modules/alignment/long_read_storage.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace path_extend {
+
+/**
+ * @brief Path of a long read library as seen by the long read extension choosers and scaffolders:
+ *        either a path of PathStorage, taken forward or conjugated, or a trusted contig path.
+ *        Storage paths are light views over the storage arena and have no gaps.
+ */
+class LongReadPath {
+    typedef std::vector<EdgeId>::const_iterator EdgeIterator;
+
+    const Graph *g_;
+    const BidirectionalPath *path_;
+    EdgeIterator edges_;
+    size_t size_;
+    bool conjugate_;
+    double weight_;
+    size_t id_;
+
+public:
+    explicit LongReadPath(const BidirectionalPath &path)
+            : g_(&path.graph()), path_(&path), edges_(), size_(0),
+              conjugate_(false), weight_(0.), id_(path.GetId()) {}
+
+    LongReadPath(const Graph &g, adt::iterator_range<EdgeIterator> edges,
+                 bool conjugate, double weight, size_t id)
+            : g_(&g), path_(nullptr), edges_(edges.begin()), size_(edges.end() - edges.begin()),
+              conjugate_(conjugate), weight_(weight), id_(id) {}
+
+    size_t Size() const {
+        return path_ ? path_->Size() : size_;
+    }
+
+    EdgeId At(size_t index) const {
+        if (path_)
+            return path_->At(index);
+        return conjugate_ ? g_->conjugate(edges_[size_ - 1 - index]) : edges_[index];
+    }
+
+    EdgeId operator[](size_t index) const {
+        return At(index);
+    }
+
+    EdgeId Back() const {
+        return At(Size() - 1);
+    }
+
+    const Gap &GapAt(size_t index) const {
+        static const Gap no_gap;
+        return path_ ? path_->GapAt(index) : no_gap;
+    }
+
+    // Length from beginning of i-th edge to path end, see BidirectionalPath::LengthAt()
+    size_t LengthAt(size_t index) const {
+        if (path_)
+            return path_->LengthAt(index);
+        size_t length = 0;
+        for (size_t i = index; i < size_; ++i)
+            length += g_->length(At(i));
+        return length;
+    }
+
+    std::vector<size_t> FindAll(EdgeId e, size_t start = 0) const {
+        std::vector<size_t> result;
+        for (size_t i = start; i < Size(); ++i) {
+            if (At(i) == e)
+                result.push_back(i);
+        }
+        return result;
+    }
+
+    double GetWeight() const {
+        return path_ ? path_->GetWeight() : weight_;
+    }
+
+    size_t GetId() const {
+        return id_;
+    }
+
+    const Graph &graph() const {
+        return *g_;
+    }
+
+    void PrintDEBUG() const {
+        if (path_) {
+            path_->PrintDEBUG();
+            return;
+        }
+        DEBUG_EXPR(
+            std::stringstream ss;
+            for (size_t i = 0; i < size_; ++i)
+                ss << g_->int_id(At(i)) << " ";
+            DEBUG(ss.str());
+        );
+    }
+
+    DECL_LOGGER("LongReadPath");
+};
+
+/**
+ * @brief Per-edge index of the long read library paths, see GraphCoverageMap.
+ *        Read paths are served by the coverage index of their PathStorage, each stored
+ *        path together with its conjugate. Trusted contigs keep their gaps, so they are
+ *        indexed as BidirectionalPaths.
+ */
+class LongReadsCoverageMap {
+    typedef debruijn_graph::PathStorage<Graph> PathStorageT;
+
+    const Graph &g_;
+    const PathStorageT *storage_;
+    std::unique_ptr<GraphCoverageMap> path_cov_map_;
+    bool empty_;
+
+    LongReadPath StoragePath(size_t id, bool conjugate) const {
+        return LongReadPath(g_, storage_->path(id), conjugate, double(storage_->weight(id)), 2 * id + conjugate);
+    }
+
+public:
+    explicit LongReadsCoverageMap(const Graph &g)
+            : g_(g), storage_(nullptr), empty_(true) {}
+
+    /// The coverage index of the storage should be built
+    LongReadsCoverageMap(const Graph &g, const PathStorageT &storage)
+            : g_(g), storage_(&storage), empty_(true) {
+        VERIFY(storage.HasCoverageIndex());
+        for (EdgeId e : g_.edges()) {
+            if (storage.GetCoverage(e) > 0) {
+                empty_ = false;
+                break;
+            }
+        }
+    }
+
+    LongReadsCoverageMap(const Graph &g, const PathContainer &paths)
+            : g_(g), storage_(nullptr),
+              path_cov_map_(std::make_unique<GraphCoverageMap>(g, paths)),
+              empty_(path_cov_map_->size() == 0) {}
+
+    /// Paths going through the edge, ordered by their ids
+    std::vector<LongReadPath> GetCoveringPaths(EdgeId e) const {
+        std::vector<LongReadPath> result;
+        if (path_cov_map_) {
+            for (const BidirectionalPath *path : path_cov_map_->GetCoveringPaths(e))
+                result.emplace_back(*path);
+        } else if (storage_) {
+            // Stored paths through e and conjugates of the stored paths through conj(e)
+            auto forward = storage_->GetCoveringPaths(e);
+            auto backward = storage_->GetCoveringPaths(g_.conjugate(e));
+            result.reserve((forward.end() - forward.begin()) + (backward.end() - backward.begin()));
+            auto f = forward.begin(), b = backward.begin();
+            while (f != forward.end() || b != backward.end()) {
+                if (b == backward.end() || (f != forward.end() && *f <= *b))
+                    result.push_back(StoragePath(*f++, false));
+                else
+                    result.push_back(StoragePath(*b++, true));
+            }
+        }
+        return result;
+    }
+
+    bool empty() const {
+        return empty_;
+    }
+
+    const Graph &graph() const {
+        return g_;
+    }
+};
+
+} // namespace path_extend
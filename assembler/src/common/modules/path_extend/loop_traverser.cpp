@@ -7,7 +7,10 @@
 #include "loop_traverser.hpp"
 #include "pe_utils.hpp"
 #include "assembly_graph/core/graph.hpp"
-#include "assembly_graph/components/splitters.hpp"
+#include "assembly_graph/dijkstra/dijkstra_helper.hpp"
+#include "utils/parallel/openmp_wrapper.h"
+
+#include <parallel_hashmap/phmap.h>
 
 namespace path_extend {
 
@@ -184,14 +187,46 @@ size_t LoopTraverser::CommonEndSize(const SimpleBidirectionalPath& start_path, c
     return 0;
 }
 
+std::vector<std::vector<VertexId>> LoopTraverser::FindShortEdgeComponents() const {
+    //Same components and in the same order as LongEdgesExclusiveSplitter gives
+    std::vector<std::vector<VertexId>> components;
+    phmap::flat_hash_set<VertexId> visited;
+    for (VertexId v : g_) {
+        if (!visited.insert(v).second)
+            continue;
+
+        std::vector<VertexId> component{v};
+        for (size_t i = 0; i < component.size(); ++i) {
+            VertexId u = component[i];
+            for (EdgeId e : g_.OutgoingEdges(u))
+                if (g_.length(e) <= long_edge_limit_ && visited.insert(g_.EdgeEnd(e)).second)
+                    component.push_back(g_.EdgeEnd(e));
+            for (EdgeId e : g_.IncomingEdges(u))
+                if (g_.length(e) <= long_edge_limit_ && visited.insert(g_.EdgeStart(e)).second)
+                    component.push_back(g_.EdgeStart(e));
+        }
+        components.push_back(std::move(component));
+    }
+    return components;
+}
+
 size_t LoopTraverser::TraverseAllLoops() {
     DEBUG("TraverseAllLoops");
-    size_t traversed = 0;
-    auto splitter = omnigraph::LongEdgesExclusiveSplitter<Graph>(g_, long_edge_limit_);
-    while (splitter->HasNext()) {
-        omnigraph::GraphComponent<Graph> component = splitter->Next();
-        if (component.v_size() > component_size_limit_)
+    auto components = FindShortEdgeComponents();
+
+    //Component analysis depends on the graph only, so it is done in parallel,
+    //while the loops are traversed one by one in the original order
+    struct Loop {
+        EdgeId start, finish;
+        std::set<VertexId> component_set;
+    };
+    std::vector<Loop> loops(components.size());
+
+    #pragma omp parallel for schedule(guided)
+    for (size_t i = 0; i < components.size(); ++i) {
+        if (components[i].size() > component_size_limit_)
             continue;
+        auto component = omnigraph::GraphComponent<Graph>::FromVertices(g_, components[i]);
         if (ContainsLongEdges(component))
             continue;
         if (AnyTipsInComponent(component))
@@ -203,7 +238,15 @@ size_t LoopTraverser::TraverseAllLoops() {
         if (start == EdgeId() || finish == EdgeId())
             continue;
 
-        if (TraverseLoop(start, finish, component_set))
+        loops[i] = { start, finish, std::move(component_set) };
+    }
+
+    size_t traversed = 0;
+    for (const auto &loop : loops) {
+        if (loop.start == EdgeId())
+            continue;
+
+        if (TraverseLoop(loop.start, loop.finish, loop.component_set))
             ++traversed;
     }
     return traversed;
@@ -12,6 +12,7 @@
 #include "assembly_graph/components/graph_component.hpp"
 #include "assembly_graph/core/graph.hpp"
 #include <set>
+#include <vector>
 
 namespace path_extend {
 
@@ -39,6 +40,8 @@ class LoopTraverser {
     bool TraverseLoop(EdgeId start, EdgeId end, const std::set<VertexId> &component_set);
     bool ContainsLongEdges(const omnigraph::GraphComponent<debruijn_graph::Graph>& component) const;
     size_t CommonEndSize(const SimpleBidirectionalPath& start_path, const SimpleBidirectionalPath& end_path) const;
+    //Components of the graph connected by the edges not longer than long_edge_limit_
+    std::vector<std::vector<VertexId>> FindShortEdgeComponents() const;
 
 public:
     LoopTraverser(const debruijn_graph::Graph& g, GraphCoverageMap& coverage_map,
@@ -7,6 +7,8 @@
 #include "overlap_remover.hpp"
 #include "path_extender.hpp" // FIXME: Temporary
 
+#include "utils/parallel/openmp_wrapper.h"
+
 namespace path_extend {
 
 static void PopFront(BidirectionalPath &path, size_t cnt) {
@@ -153,10 +155,19 @@ std::vector<const BidirectionalPath*> OverlapFindingHelper::FindCandidatePaths(c
     return std::vector<const BidirectionalPath*>(candidates.begin(), candidates.end());
 }
 
+OverlapRemover::PathOverlaps OverlapRemover::FindOverlaps(const BidirectionalPath &path,
+                                                          bool end_start_only) const {
+    PathOverlaps overlaps;
+    for (const BidirectionalPath *candidate : helper_.FindCandidatePaths(path)) {
+        auto range_pair = helper_.FindOverlap(path, *candidate, end_start_only);
+        if (range_pair.first.size() > 0)
+            overlaps.emplace_back(candidate, range_pair);
+    }
+    return overlaps;
+}
+
 size_t OverlapRemover::AnalyzeOverlaps(const BidirectionalPath &path, const BidirectionalPath &other,
-                                       bool end_start_only, bool retain_one_copy) const {
-    VERIFY(!retain_one_copy || !end_start_only);
-    auto range_pair = helper_.FindOverlap(path, other, end_start_only);
+                                       const std::pair<Range, Range> &range_pair, bool retain_one_copy) const {
     size_t overlap = range_pair.first.size();
     auto other_range = range_pair.second;
 
@@ -164,7 +175,7 @@ size_t OverlapRemover::AnalyzeOverlaps(const BidirectionalPath &path, const Bidi
         return 0;
 
     //checking if region on the other path has not been already added
-    //TODO discuss if the logic is needed/correct. It complicates the procedure and prevents trivial parallelism.
+    //TODO discuss if the logic is needed/correct. It complicates the procedure and makes marking order dependent.
     if (retain_one_copy &&
         AlreadyAdded(other, other_range.start_pos, other_range.end_pos) &&
         /*forcing "cut_all" behavior on conjugate paths*/
@@ -193,11 +204,12 @@ size_t OverlapRemover::AnalyzeOverlaps(const BidirectionalPath &path, const Bidi
     return overlap;
 }
 
-void OverlapRemover::MarkStartOverlaps(const BidirectionalPath &path, bool end_start_only, bool retain_one_copy) {
+void OverlapRemover::MarkStartOverlaps(const BidirectionalPath &path, const PathOverlaps &overlaps,
+                                       bool retain_one_copy) {
     std::set<size_t> overlap_poss;
-    for (const BidirectionalPath *candidate : helper_.FindCandidatePaths(path)) {
-        size_t overlap = AnalyzeOverlaps(path, *candidate,
-                                         end_start_only, retain_one_copy);
+    for (const auto &entry : overlaps) {
+        size_t overlap = AnalyzeOverlaps(path, *entry.first,
+                                         entry.second, retain_one_copy);
         if (overlap > 0)
             overlap_poss.insert(overlap);
     }
@@ -208,7 +220,25 @@ void OverlapRemover::MarkStartOverlaps(const BidirectionalPath &path, bool end_s
 }
 
 void OverlapRemover::InnerMarkOverlaps(bool end_start_only, bool retain_one_copy) {
-    for (auto &path_pair : paths_) {
+    VERIFY(!retain_one_copy || !end_start_only);
+    std::vector<std::pair<const BidirectionalPath*, const BidirectionalPath*>> path_pairs;
+    for (const auto &entry : paths_)
+        path_pairs.emplace_back(entry.first.get(), entry.second.get());
+
+    //Overlaps are found in parallel, while the splits are marked sequentially
+    //in the container order, since retain_one_copy depends on the ones marked before
+    std::vector<std::pair<PathOverlaps, PathOverlaps>> overlaps(path_pairs.size());
+    #pragma omp parallel for schedule(guided)
+    for (size_t i = 0; i < path_pairs.size(); ++i) {
+        const auto &path_pair = path_pairs[i];
+        if (path_pair.first->Size() == 0 || path_pair.first->IsCycle())
+            continue;
+        overlaps[i].first = FindOverlaps(*path_pair.first, end_start_only);
+        overlaps[i].second = FindOverlaps(*path_pair.second, end_start_only);
+    }
+
+    for (size_t i = 0; i < path_pairs.size(); ++i) {
+        const auto &path_pair = path_pairs[i];
         //TODO think if this "optimization" is necessary
         if (path_pair.first->Size() == 0)
             continue;
@@ -219,8 +249,8 @@ void OverlapRemover::InnerMarkOverlaps(bool end_start_only, bool retain_one_copy
             if (overlapping > 0)
                 splits_[path_pair.first->GetId()].insert(overlapping);
         } else {
-            MarkStartOverlaps(*path_pair.first, end_start_only, retain_one_copy);
-            MarkStartOverlaps(*path_pair.second, end_start_only, retain_one_copy);
+            MarkStartOverlaps(*path_pair.first, overlaps[i].first, retain_one_copy);
+            MarkStartOverlaps(*path_pair.second, overlaps[i].second, retain_one_copy);
         }
     }
 }
@@ -269,10 +299,16 @@ void PathSplitter::Split() {
     std::vector<std::pair<BidirectionalPath*, BidirectionalPath*>> tmp_paths;
     for (const auto &entry : paths_)
         tmp_paths.emplace_back(entry.first.get(), entry.second.get());
-    for (auto & path_pair : tmp_paths) {
-        SplitPath(path_pair.first,
-                  GatherAllSplits(*path_pair.first, *path_pair.second));
-    }
+
+    //Splitting a path only changes the path itself and its conjugate,
+    //so the split positions could be gathered in advance
+    std::vector<std::set<size_t>> path_splits(tmp_paths.size());
+    #pragma omp parallel for schedule(guided)
+    for (size_t i = 0; i < tmp_paths.size(); ++i)
+        path_splits[i] = GatherAllSplits(*tmp_paths[i].first, *tmp_paths[i].second);
+
+    for (size_t i = 0; i < tmp_paths.size(); ++i)
+        SplitPath(tmp_paths[i].first, path_splits[i]);
 }
 
 }
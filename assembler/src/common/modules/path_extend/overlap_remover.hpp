@@ -75,6 +75,8 @@ private:
 };
 
 class OverlapRemover {
+    typedef std::vector<std::pair<const BidirectionalPath*, std::pair<Range, Range>>> PathOverlaps;
+
     const PathContainer &paths_;
     const OverlapFindingHelper helper_;
     SplitsStorage splits_;
@@ -93,10 +95,13 @@ class OverlapRemover {
         return false;
     }
 
+    //Non-empty overlaps with all candidate paths, do not depend on the splits marked
+    PathOverlaps FindOverlaps(const BidirectionalPath &path, bool end_start_only) const;
+
     //NB! This can only be launched over paths taken from path container!
     size_t AnalyzeOverlaps(const BidirectionalPath &path, const BidirectionalPath &other,
-                           bool end_start_only, bool retain_one_copy) const;
-    void MarkStartOverlaps(const BidirectionalPath &path, bool end_start_only, bool retain_one_copy);
+                           const std::pair<Range, Range> &range_pair, bool retain_one_copy) const;
+    void MarkStartOverlaps(const BidirectionalPath &path, const PathOverlaps &overlaps, bool retain_one_copy);
     void InnerMarkOverlaps(bool end_start_only, bool retain_one_copy);
 
 public:
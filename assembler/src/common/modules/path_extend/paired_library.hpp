@@ -9,10 +9,22 @@
 
 #include "pipeline/config_struct.hpp"
 #include "paired_info/paired_info.hpp"
+#include "paired_info/frozen_paired_index.hpp"
 #include "ideal_pair_info.hpp"
 
 #include "math/xmath.h"
 
+#include <parallel_hashmap/phmap.h>
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
 namespace path_extend {
 
 using debruijn_graph::Graph;
@@ -51,6 +63,11 @@ public:
         return ideal_pi_counter_.IdealPairedInfo(e1, e2, distance, additive);
     }
 
+    int MaxIdealGap() const { return ideal_pi_counter_.max_gap(); }
+
+    /// Has to be set before the library is shared by several threads
+    void SetConcurrent(bool concurrent) { ideal_pi_counter_.set_concurrent(concurrent); }
+
     size_t GetIS() const { return insert_size_; }
     size_t GetISMin() const { return is_min_; }
     size_t GetISMax() const { return is_max_; }
@@ -58,6 +75,9 @@ public:
     double GetIsVar() const { return is_var_; }
     bool IsMp() const { return is_mate_pairs_; }
     virtual size_t size() const = 0;
+
+    /// Logs the statistics of the histogram lookups done so far
+    virtual void ReportStats() const {}
 protected:
     const Graph& g_;
     size_t k_;
@@ -71,9 +91,137 @@ protected:
     DECL_LOGGER("PathExtendPI");
 };
 
+// Flat copies of the histograms queried so far. Path extension asks for the
+// same edge pairs over and over: for every candidate, by every weight
+// counter and by every seed going through the region. Sharded, so it could
+// be shared between threads; every shard keeps its least recently used
+// pairs within its part of the memory limit.
+class PairedHistogramCache {
+public:
+    typedef std::vector<Point> Points;
+
+    // Keeps the points alive while they are iterated over, even if the pair
+    // is evicted by another thread meanwhile
+    class PointsRef {
+        std::shared_ptr<const Points> points_;
+    public:
+        explicit PointsRef(std::shared_ptr<const Points> points)
+                : points_(std::move(points)) {}
+
+        Points::const_iterator begin() const { return points_->begin(); }
+        Points::const_iterator end() const { return points_->end(); }
+    };
+
+    static constexpr size_t DEFAULT_MAX_BYTES = size_t(256) << 20;
+
+    explicit PairedHistogramCache(size_t max_bytes = DEFAULT_MAX_BYTES)
+            : shard_max_bytes_(max_bytes / SHARDS), hits_(0), misses_(0), evictions_(0) {}
+
+    /// Returns the points of the pair, calling fill(points) on the first query
+    template<class Fill>
+    PointsRef Get(EdgeId e1, EdgeId e2, Fill fill) const {
+        EdgePair key(e1, e2);
+        Shard &shard = shards_[PairHash()(key) % SHARDS];
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.map.find(key);
+            if (it != shard.map.end()) {
+                hits_ += 1;
+                shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+                return PointsRef(it->second->points);
+            }
+        }
+
+        auto points = std::make_shared<Points>();
+        fill(*points);
+        misses_ += 1;
+
+        size_t bytes = EntryBytes(*points);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.map.find(key);
+        if (it != shard.map.end())
+            return PointsRef(it->second->points);
+
+        while (!shard.lru.empty() && shard.bytes + bytes > shard_max_bytes_) {
+            const Entry &last = shard.lru.back();
+            shard.bytes -= EntryBytes(*last.points);
+            shard.map.erase(last.key);
+            shard.lru.pop_back();
+            evictions_ += 1;
+        }
+        shard.lru.push_front(Entry{key, points});
+        shard.map.emplace(key, shard.lru.begin());
+        shard.bytes += bytes;
+        return PointsRef(std::move(points));
+    }
+
+    size_t hits() const { return hits_; }
+    size_t misses() const { return misses_; }
+    size_t evictions() const { return evictions_; }
+
+private:
+    typedef std::pair<EdgeId, EdgeId> EdgePair;
+
+    struct PairHash {
+        size_t operator()(const EdgePair &pair) const {
+            return phmap::HashState().combine(0, pair.first.int_id(), pair.second.int_id());
+        }
+    };
+
+    struct Entry {
+        EdgePair key;
+        std::shared_ptr<const Points> points;
+    };
+
+    // Rough estimate of the memory taken by the entry including the list
+    // node and the hash map node
+    static size_t EntryBytes(const Points &points) {
+        return sizeof(Points) + points.capacity() * sizeof(Point) + 4 * sizeof(void*) + sizeof(Entry);
+    }
+
+    // Most recently used pairs are at the front of the list
+    struct Shard {
+        std::mutex mutex;
+        std::list<Entry> lru;
+        std::unordered_map<EdgePair, std::list<Entry>::iterator, PairHash> map;
+        size_t bytes = 0;
+    };
+
+    static constexpr size_t SHARDS = 64;
+    size_t shard_max_bytes_;
+    mutable std::array<Shard, SHARDS> shards_;
+    mutable std::atomic<size_t> hits_;
+    mutable std::atomic<size_t> misses_;
+    mutable std::atomic<size_t> evictions_;
+};
+
+// Frozen indices keep the points of a pair contiguous already, so the
+// histograms are read directly instead of being copied into the cache
+template<class Index>
+struct CachesHistograms : std::true_type {};
+
+template<class G, class Traits>
+struct CachesHistograms<omnigraph::de::FrozenPairedIndex<G, Traits>> : std::false_type {};
+
 template<class Index>
 class PairedInfoLibraryWithIndex : public PairedInfoLibrary {
     const Index& index_;
+    PairedHistogramCache cache_;
+
+    PairedHistogramCache::PointsRef GetPoints(EdgeId e1, EdgeId e2, std::true_type) const {
+        return cache_.Get(e1, e2, [&](PairedHistogramCache::Points &points) {
+            for (auto point : index_.Get(e1, e2))
+                points.emplace_back(point.d, point.weight, point.variance());
+        });
+    }
+
+    auto GetPoints(EdgeId e1, EdgeId e2, std::false_type) const {
+        return index_.Get(e1, e2);
+    }
+
+    decltype(auto) GetPoints(EdgeId e1, EdgeId e2) const {
+        return GetPoints(e1, e2, CachesHistograms<std::decay_t<Index>>());
+    }
 
 public:
     PairedInfoLibraryWithIndex(const Graph& g, size_t read_length, size_t is, size_t is_min, size_t is_max, double is_div,
@@ -81,6 +229,14 @@ public:
                                const std::map<int, size_t>& is_distribution)
         : PairedInfoLibrary(g, read_length, is, is_min, is_max, is_div, is_mp, is_distribution),
           index_(index) {}
+
+    void ReportStats() const override {
+        if (cache_.hits() || cache_.misses())
+            DEBUG("Paired histogram cache: " << cache_.misses() << " pairs fetched, "
+                  << cache_.hits() << " queries answered from cache, "
+                  << cache_.evictions() << " pairs evicted");
+    }
+
     size_t size() const override {
         return index_.size();
     }
@@ -112,7 +268,7 @@ public:
         if (e1 == e2)
             return;
 
-        for (auto point : index_.Get(e1, e2)) {
+        for (auto point : GetPoints(e1, e2)) {
             int pairedDistance = omnigraph::de::rounded_d(point);
             dist.push_back(pairedDistance);
             w.push_back(point.weight);
@@ -123,7 +279,7 @@ public:
                            bool from_interval = false) const override {
         double weight = 0.0;
 
-        for (auto point : index_.Get(e1, e2)) {
+        for (auto point : GetPoints(e1, e2)) {
             int pairedDistance = omnigraph::de::rounded_d(point);
             int distanceDev = (int) point.variance();  //max((int) pointIter->var, (int) is_variation_);
             //Can be modified according to distance comparison
@@ -143,7 +299,7 @@ public:
 
     double CountPairedInfo(EdgeId e1, EdgeId e2, int dist_min, int dist_max) const override {
         double weight = 0.0;
-        for (const auto &point : index_.Get(e1, e2)) {
+        for (auto point : GetPoints(e1, e2)) {
             int dist = omnigraph::de::rounded_d(point);
             if (dist >= dist_min && dist <= dist_max)
                 weight += point.weight;
@@ -153,10 +309,24 @@ public:
 
 };
 
+// Library over a frozen index, which is kept alive while the library is used
 template<class Index>
-std::shared_ptr<PairedInfoLibrary> MakeNewLib(const Graph &g,
-                                              const debruijn_graph::config::dataset::Library &lib,
-                                              const Index &paired_index) {
+class FrozenPairedInfoLibrary : public PairedInfoLibraryWithIndex<const Index&> {
+    std::shared_ptr<const Index> frozen_index_;
+
+public:
+    FrozenPairedInfoLibrary(const Graph& g, size_t read_length, size_t is, size_t is_min, size_t is_max, double is_div,
+                            std::shared_ptr<const Index> index, bool is_mp,
+                            const std::map<int, size_t>& is_distribution)
+        : PairedInfoLibraryWithIndex<const Index&>(g, read_length, is, is_min, is_max, is_div,
+                                                   *index, is_mp, is_distribution),
+          frozen_index_(std::move(index)) {}
+};
+
+template<class Library, class IndexArg>
+std::shared_ptr<PairedInfoLibrary> MakeLibrary(const Graph &g,
+                                               const debruijn_graph::config::dataset::Library &lib,
+                                               IndexArg &&paired_index) {
     //why all those local variables? :)
     size_t read_length = lib.data().unmerged_read_length;
     size_t is = (size_t) lib.data().mean_insert_size;
@@ -164,15 +334,29 @@ std::shared_ptr<PairedInfoLibrary> MakeNewLib(const Graph &g,
     int is_max = (int) lib.data().insert_size_right_quantile;
     double var = lib.data().insert_size_deviation;
     bool is_mp = lib.type() == io::LibraryType::MatePairs || lib.type() == io::LibraryType::HQMatePairs;
-    return std::make_shared<PairedInfoLibraryWithIndex<decltype(paired_index)>>(g,
-                                                                                read_length,
-                                                                                is,
-                                                                                is_min > 0 ? size_t(is_min) : 0,
-                                                                                is_max > 0 ? size_t(is_max) : 0,
-                                                                                var,
-                                                                                paired_index,
-                                                                                is_mp,
-                                                                                lib.data().insert_size_distribution);
+    return std::make_shared<Library>(g,
+                                     read_length,
+                                     is,
+                                     is_min > 0 ? size_t(is_min) : 0,
+                                     is_max > 0 ? size_t(is_max) : 0,
+                                     var,
+                                     std::forward<IndexArg>(paired_index),
+                                     is_mp,
+                                     lib.data().insert_size_distribution);
+}
+
+template<class Index>
+std::shared_ptr<PairedInfoLibrary> MakeNewLib(const Graph &g,
+                                              const debruijn_graph::config::dataset::Library &lib,
+                                              const Index &paired_index) {
+    return MakeLibrary<PairedInfoLibraryWithIndex<decltype(paired_index)>>(g, lib, paired_index);
+}
+
+template<class G, class Traits>
+std::shared_ptr<PairedInfoLibrary> MakeNewLib(const Graph &g,
+                                              const debruijn_graph::config::dataset::Library &lib,
+                                              std::shared_ptr<const omnigraph::de::FrozenPairedIndex<G, Traits>> paired_index) {
+    return MakeLibrary<FrozenPairedInfoLibrary<omnigraph::de::FrozenPairedIndex<G, Traits>>>(g, lib, std::move(paired_index));
 }
 
 }  // path extend
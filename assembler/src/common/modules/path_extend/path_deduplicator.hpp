@@ -9,6 +9,9 @@
 #include "overlap_remover.hpp"
 #include "pe_utils.hpp"
 #include "assembly_graph/paths/bidirectional_path.hpp"
+#include "utils/parallel/openmp_wrapper.h"
+
+#include <algorithm>
 
 namespace path_extend {
 
@@ -17,8 +20,10 @@ class PathDeduplicator {
     const bool equal_only_;
     const OverlapFindingHelper helper_;
 
-    bool IsRedundant(const BidirectionalPath &path) const {
+    //Candidates which make the path redundant, while they are not cleared
+    std::vector<const BidirectionalPath*> FindCoveringPaths(const BidirectionalPath &path) const {
         TRACE("Checking if path redundant " << path.GetId());
+        std::vector<const BidirectionalPath*> covering;
         for (const BidirectionalPath *candidate : helper_.FindCandidatePaths(path)) {
             TRACE("Considering candidate " << candidate->GetId());
 //                VERIFY(candidate != path && candidate != path->GetConjPath());
@@ -27,9 +32,9 @@ class PathDeduplicator {
                 continue;
 
             if (equal_only_ ? helper_.IsEqual(path, *candidate) : helper_.IsSubpath(path, *candidate))
-                return true;
+                covering.push_back(candidate);
         }
-        return false;
+        return covering;
     }
 public:
     PathDeduplicator(const Graph &g,
@@ -44,11 +49,23 @@ public:
 
     //TODO use path container filtering?
     void Deduplicate() {
-        for (auto & path_pair : paths_) {
-            auto &path = path_pair.first;
-            if (IsRedundant(*path)) {
-                TRACE("Clearing path " << path->str());
-                path->Clear();
+        std::vector<BidirectionalPath*> paths;
+        for (auto & path_pair : paths_)
+            paths.push_back(path_pair.first.get());
+
+        //Cleared paths (together with their conjugates) just drop out of the
+        //candidates of the following ones, so the paths are compared in parallel
+        //and a path is redundant iff some of its covering paths survived so far
+        std::vector<std::vector<const BidirectionalPath*>> covering(paths.size());
+        #pragma omp parallel for schedule(guided)
+        for (size_t i = 0; i < paths.size(); ++i)
+            covering[i] = FindCoveringPaths(*paths[i]);
+
+        for (size_t i = 0; i < paths.size(); ++i) {
+            if (std::any_of(covering[i].begin(), covering[i].end(),
+                            [](const BidirectionalPath *p) { return !p->Empty(); })) {
+                TRACE("Clearing path " << paths[i]->str());
+                paths[i]->Clear();
             }
         }
     }
@@ -16,6 +16,7 @@
 #include "assembly_graph/graph_support/detail_coverage.hpp"
 #include "assembly_graph/graph_support/scaff_supplementary.hpp"
 
+#include <algorithm>
 #include <cmath>
 
 namespace path_extend {
@@ -417,6 +418,10 @@ public:
     virtual ~PathExtender() = default;
     virtual bool MakeGrowStep(BidirectionalPath& path, PathContainer* paths_storage = nullptr) = 0;
 
+    //Whether the extender may continue a path with an edge that is not adjacent to its end
+    //(and thus leave the connected component of the graph the path started in)
+    virtual bool MakesJumps() const { return false; }
+
 protected:
     const Graph &g_;
     DECL_LOGGER("PathExtender")
@@ -438,10 +443,21 @@ public:
               extenders_(pes) {}
 
     void GrowAll(PathContainer& paths, PathContainer& result);
+    //Grows a single seed unless it is already covered, new paths are appended to result
+    void GrowSeed(const BidirectionalPath& seed, PathContainer& result);
     void GrowPath(BidirectionalPath& path, PathContainer* paths_storage) {
         while (MakeGrowStep(path, paths_storage)) { }
     }
 
+    bool MakesJumps() const {
+        return std::any_of(extenders_.begin(), extenders_.end(),
+                           [](const std::shared_ptr<PathExtender> &pe) { return pe->MakesJumps(); });
+    }
+
+    const GraphCoverageMap& cover_map() const {
+        return cover_map_;
+    }
+
 private:
     const Graph &g_;
     GraphCoverageMap &cover_map_;
@@ -640,6 +656,8 @@ public:
         return MakeSimpleGrowStepForChooser(path, extension_chooser_);
     }
 
+    bool MakesJumps() const override { return true; }
+
     std::shared_ptr<ExtensionChooser> GetExtensionChooser() const {
         return extension_chooser_;
     }
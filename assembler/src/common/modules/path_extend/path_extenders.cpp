@@ -35,44 +35,46 @@ void CompositeExtender::GrowAllPaths(PathContainer& paths, PathContainer& result
         if (paths.size() > 10 && i % (paths.size() / 10 + 1) == 0) {
             INFO("Processed " << i << " paths from " << paths.size() << " (" << i * 100 / paths.size() << "%)");
         }
-        //In 2015 modes do not use a seed already used in paths.
-        //FIXME what is the logic here?
-        if (used_storage_.UniqueCheckEnabled()) {
-            bool was_used = false;
-            const BidirectionalPath &p = paths.Get(i);
-            for (size_t ind =0; ind < p.Size(); ind++) {
-                EdgeId eid = p.At(ind);
-                auto path_id = p.GetId();
-                if (used_storage_.IsUsedAndUnique(eid, path_id)) {
-                    DEBUG("Used edge " << g_.int_id(eid));
-                    was_used = true;
-                    break;
-                } else {
-                    used_storage_.insert(eid, path_id);
-                }
-            }
-            if (was_used) {
-                DEBUG("skipping already used seed");
-                continue;
+        GrowSeed(paths.Get(i), result);
+    }
+}
+
+void CompositeExtender::GrowSeed(const BidirectionalPath& seed, PathContainer& result) {
+    //In 2015 modes do not use a seed already used in paths.
+    //FIXME what is the logic here?
+    if (used_storage_.UniqueCheckEnabled()) {
+        bool was_used = false;
+        for (size_t ind =0; ind < seed.Size(); ind++) {
+            EdgeId eid = seed.At(ind);
+            auto path_id = seed.GetId();
+            if (used_storage_.IsUsedAndUnique(eid, path_id)) {
+                DEBUG("Used edge " << g_.int_id(eid));
+                was_used = true;
+                break;
+            } else {
+                used_storage_.insert(eid, path_id);
             }
         }
-
-        if (!cover_map_.IsCovered(paths.Get(i))) {
-            BidirectionalPath &path = CreatePath(result, cover_map_,
-                                                 paths.Get(i));
-
-            size_t count_trying = 0;
-            size_t current_path_len = 0;
-            do {
-                current_path_len = path.Length();
-                count_trying++;
-                GrowPath(path, &result);
-                GrowPath(*path.GetConjPath(), &result);
-            } while (count_trying < 10 && (path.Length() != current_path_len));
-                DEBUG("result path " << path.GetId());
-                path.PrintDEBUG();
+        if (was_used) {
+            DEBUG("skipping already used seed");
+            return;
         }
     }
+
+    if (!cover_map_.IsCovered(seed)) {
+        BidirectionalPath &path = CreatePath(result, cover_map_, seed);
+
+        size_t count_trying = 0;
+        size_t current_path_len = 0;
+        do {
+            current_path_len = path.Length();
+            count_trying++;
+            GrowPath(path, &result);
+            GrowPath(*path.GetConjPath(), &result);
+        } while (count_trying < 10 && (path.Length() != current_path_len));
+        DEBUG("result path " << path.GetId());
+        path.PrintDEBUG();
+    }
 }
 
 bool LoopDetectingPathExtender::TryUseEdge(BidirectionalPath &path, EdgeId e, const Gap &gap) {
@@ -182,6 +182,7 @@ void load(pe_config::ParamSetT& p, boost::property_tree::ptree const& pt, bool c
     load(p.scaffolder_options, pt, "scaffolder", complete);
     load(p.coordinated_coverage, pt, "coordinated_coverage", complete);
     load(p.use_coordinated_coverage, pt, "use_coordinated_coverage", complete);
+    load(p.parallel_components, pt, "parallel_components", complete);
     load(p.scaffolding2015, pt, "scaffolding2015", complete);
     load(p.scaffold_graph_params, pt, "scaffold_graph", complete);
 
@@ -134,6 +134,9 @@ struct pe_config {
 
         bool use_coordinated_coverage;
 
+        // Grow the seeds of different connected components in parallel when no extender can jump between them
+        bool parallel_components;
+
         struct CoordinatedCoverageT {
             size_t max_edge_length_in_repeat;
             double delta;
@@ -9,6 +9,9 @@
 #include "path_deduplicator.hpp"
 #include "path_extender.hpp"
 
+#include "assembly_graph/components/connected_component.hpp"
+#include "utils/parallel/openmp_wrapper.h"
+
 namespace path_extend {
 
 using namespace debruijn_graph;
@@ -53,6 +56,64 @@ PathContainer PathExtendResolver::ExtendSeeds(PathContainer &seeds, CompositeExt
     return paths;
 }
 
+PathContainer PathExtendResolver::ExtendSeeds(PathContainer &seeds, const ConnectedComponentCounter &components,
+                                              const std::vector<std::unique_ptr<CompositeExtender>> &extenders,
+                                              GraphCoverageMap &cover_map) const {
+    VERIFY(!extenders.empty() && components.IsFilled());
+    //Seeds of a component are grown by a single thread in their original order
+    std::vector<std::vector<size_t>> component_seeds(components.component_total_len_.size());
+    for (size_t i = 0; i < seeds.size(); ++i) {
+        const BidirectionalPath &seed = seeds.Get(i);
+        if (!seed.Empty())
+            component_seeds[components.GetComponent(seed.Front())].push_back(i);
+    }
+
+    //Paths [begin, end) of the thread container were created while growing the seed
+    struct GrownSeed {
+        size_t seed, thread, begin, end;
+    };
+
+    size_t nthreads = extenders.size();
+    std::vector<PathContainer> results(nthreads);
+    std::vector<std::vector<GrownSeed>> grown(nthreads);
+    INFO("Growing seeds of " << component_seeds.size() << " connected components in " << nthreads << " threads");
+    //Components are numbered by decreasing total length, so the largest ones are taken first
+    #pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for (size_t c = 0; c < component_seeds.size(); ++c) {
+        size_t thread = omp_get_thread_num();
+        auto &result = results[thread];
+        for (size_t i : component_seeds[c]) {
+            size_t begin = result.size();
+            extenders[thread]->GrowSeed(seeds.Get(i), result);
+            if (result.size() != begin)
+                grown[thread].push_back({ i, thread, begin, result.size() });
+        }
+    }
+
+    std::vector<GrownSeed> order;
+    for (const auto &thread_grown : grown)
+        order.insert(order.end(), thread_grown.begin(), thread_grown.end());
+    std::sort(order.begin(), order.end(),
+              [](const GrownSeed &a, const GrownSeed &b) { return a.seed < b.seed; });
+
+    PathContainer paths;
+    for (const auto &entry : order) {
+        const auto &thread_cover_map = extenders[entry.thread]->cover_map();
+        for (size_t j = entry.begin; j < entry.end; ++j) {
+            auto ppair = paths.Acquire(results[entry.thread], j);
+            //Ids are compared to choose the canonical path of a pair, renumbering
+            //keeps their order the same as if the paths were grown sequentially
+            ppair.first.Renumber();
+            ppair.second.Renumber();
+            ppair.first.Unsubscribe(thread_cover_map);
+            ppair.second.Unsubscribe(thread_cover_map);
+            cover_map.Subscribe(ppair);
+        }
+    }
+    paths.FilterEmptyPaths();
+    return paths;
+}
+
 //Paths should be deduplicated first!
 void PathExtendResolver::RemoveOverlaps(PathContainer &paths, GraphCoverageMap &coverage_map,
                                         size_t min_edge_len, size_t max_path_diff,
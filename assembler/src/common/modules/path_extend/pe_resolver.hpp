@@ -10,6 +10,13 @@
 #include "assembly_graph/paths/bidirectional_path.hpp"
 #include "assembly_graph/paths/bidirectional_path_container.hpp"
 
+#include <memory>
+#include <vector>
+
+namespace debruijn_graph {
+class ConnectedComponentCounter;
+}
+
 namespace path_extend {
 
 class CompositeExtender;
@@ -28,6 +35,13 @@ public:
     
     PathContainer MakeSimpleSeeds() const;
     PathContainer ExtendSeeds(PathContainer &seeds, CompositeExtender &composite_extender) const;
+    //Grows the seeds of different connected components in parallel, i-th thread uses the i-th extender.
+    //Only valid if the extenders never leave the component of a seed, the resulting paths
+    //(subscribed to the coverage map) are the same and in the same order as the ones of the sequential run.
+    //The paths are renumbered in this order, so their ids do not depend on the number of threads.
+    PathContainer ExtendSeeds(PathContainer &seeds, const debruijn_graph::ConnectedComponentCounter &components,
+                              const std::vector<std::unique_ptr<CompositeExtender>> &extenders,
+                              GraphCoverageMap &cover_map) const;
 
     //Paths should be deduplicated first!
     void RemoveOverlaps(PathContainer &paths, GraphCoverageMap &coverage_map,
@@ -12,8 +12,43 @@ using namespace debruijn_graph;
 using namespace std;
 using namespace omnigraph::de;
 
+shared_ptr<PairedInfoLibrary> ExtendersGenerator::MakeFrozenLib(size_t lib_index, const string &indices) const {
+    auto &paired_lib = paired_libs_[make_pair(indices, lib_index)];
+    if (!paired_lib) {
+        auto frozen = make_shared<const FrozenPairedInfoIndexT<Graph>>(gp_.get<PairedInfoIndicesT<Graph>>(indices)[lib_index]);
+        paired_lib = MakeNewLib(graph_, dataset_info_.reads[lib_index], std::move(frozen));
+        frozen_indices_.emplace(indices, lib_index);
+    }
+    return paired_lib;
+}
+
+shared_ptr<PairedInfoLibrary> ExtendersGenerator::MakeUnclusteredLib(size_t lib_index) const {
+    auto &paired_lib = paired_libs_[make_pair("unclustered_indices", lib_index)];
+    if (!paired_lib)
+        paired_lib = MakeNewLib(graph_, dataset_info_.reads[lib_index],
+                                gp_.get<UnclusteredPairedInfoIndicesT<Graph>>()[lib_index]);
+    return paired_lib;
+}
+
+void ExtendersGenerator::ReleaseFrozenIndices(GraphPack &gp) const {
+    for (const auto &frozen : frozen_indices_) {
+        INFO("Releasing " << frozen.first << " of lib #" << frozen.second << ", its frozen copy is used instead");
+        gp.get_mutable<PairedInfoIndicesT<Graph>>(frozen.first)[frozen.second].clear();
+    }
+}
+
+void ExtendersGenerator::ReportPairedLibStats() const {
+    for (const auto &paired_lib : paired_libs_)
+        paired_lib.second->ReportStats();
+}
+
+void ExtendersGenerator::SetConcurrentLibs(bool concurrent) const {
+    for (const auto &paired_lib : paired_libs_)
+        paired_lib.second->SetConcurrent(concurrent);
+}
+
 shared_ptr<ExtensionChooser> ExtendersGenerator::MakeLongReadsExtensionChooser(size_t lib_index,
-                                                                               const GraphCoverageMap &read_paths_cov_map) const {
+                                                                               const LongReadsCoverageMap &read_paths_cov_map) const {
     auto long_reads_config = support_.GetLongReadsConfig(dataset_info_.reads[lib_index].type());
 
     if (dataset_info_.reads[lib_index].type() == io::LibraryType::TrustedContigs) {
@@ -36,7 +71,7 @@ shared_ptr<ExtensionChooser> ExtendersGenerator::MakeLongReadsExtensionChooser(s
 }
 
 shared_ptr<SimpleExtender> ExtendersGenerator::MakeLongReadsExtender(size_t lib_index,
-                                                                     const GraphCoverageMap &read_paths_cov_map) const {
+                                                                     const LongReadsCoverageMap &read_paths_cov_map) const {
     const auto &lib = dataset_info_.reads[lib_index];
     //TODO params
     size_t resolvable_repeat_length_bound = 10000ul;
@@ -58,10 +93,7 @@ shared_ptr<SimpleExtender> ExtendersGenerator::MakeLongReadsExtender(size_t lib_
 
 shared_ptr<SimpleExtender> ExtendersGenerator::MakeLongEdgePEExtender(size_t lib_index,
                                                                       bool investigate_loops) const {
-    const auto &clustered_indices = gp_.get<PairedInfoIndicesT<Graph>>("clustered_indices");
-
-    const auto &lib = dataset_info_.reads[lib_index];
-    auto paired_lib = MakeNewLib(graph_, lib, clustered_indices[lib_index]);
+    auto paired_lib = MakeFrozenLib(lib_index, "clustered_indices");
     //INFO("Threshold for lib #" << lib_index << ": " << paired_lib->GetSingleThreshold());
 
     shared_ptr<WeightCounter> wc =
@@ -111,10 +143,8 @@ shared_ptr<GapAnalyzer> ExtendersGenerator::MakeGapAnalyzer(double is_variation)
 
 shared_ptr<PathExtender> ExtendersGenerator::MakeScaffoldingExtender(size_t lib_index) const {
 
-    const auto &lib = dataset_info_.reads[lib_index];
     const auto &pset = params_.pset;
-    const auto &scaffolding_indices = gp_.get<PairedInfoIndicesT<Graph>>("scaffolding_indices");
-    shared_ptr<PairedInfoLibrary> paired_lib = MakeNewLib(graph_, lib, scaffolding_indices[lib_index]);
+    shared_ptr<PairedInfoLibrary> paired_lib = MakeFrozenLib(lib_index, "scaffolding_indices");
 
     shared_ptr<WeightCounter> counter = make_shared<ReadCountWeightCounter>(graph_, paired_lib);
 
@@ -132,10 +162,8 @@ shared_ptr<PathExtender> ExtendersGenerator::MakeScaffoldingExtender(size_t lib_
 
 shared_ptr<PathExtender> ExtendersGenerator::MakeRNAScaffoldingExtender(size_t lib_index) const {
 
-    const auto &lib = dataset_info_.reads[lib_index];
     const auto &pset = params_.pset;
-    const auto &paired_indices = gp_.get<UnclusteredPairedInfoIndicesT<Graph>>();
-    shared_ptr<PairedInfoLibrary> paired_lib = MakeNewLib(graph_, lib, paired_indices[lib_index]);
+    shared_ptr<PairedInfoLibrary> paired_lib = MakeUnclusteredLib(lib_index);
 
     shared_ptr<WeightCounter> counter = make_shared<ReadCountWeightCounter>(graph_, paired_lib);
 
@@ -163,7 +191,7 @@ shared_ptr<PathExtender> ExtendersGenerator::MakeRNAScaffoldingExtender(size_t l
 }
 
 std::shared_ptr<ExtensionChooser> ExtendersGenerator::MakeLongReadsRNAExtensionChooser(size_t lib_index,
-                                                                                  const GraphCoverageMap &read_paths_cov_map) const {
+                                                                                  const LongReadsCoverageMap &read_paths_cov_map) const {
     auto long_reads_config = support_.GetLongReadsConfig(dataset_info_.reads[lib_index].type());
     INFO("Creating long read rna chooser")
     return std::make_shared<LongReadsRNAExtensionChooser>(graph_, read_paths_cov_map,
@@ -173,7 +201,7 @@ std::shared_ptr<ExtensionChooser> ExtendersGenerator::MakeLongReadsRNAExtensionC
 
 
 std::shared_ptr<SimpleExtender> ExtendersGenerator::MakeLongReadsRNAExtender(size_t lib_index,
-                                                                        const GraphCoverageMap& read_paths_cov_map) const {
+                                                                        const LongReadsCoverageMap& read_paths_cov_map) const {
     const auto& lib = dataset_info_.reads[lib_index];
     //TODO params
     size_t resolvable_repeat_length_bound = 10000ul;
@@ -197,7 +225,6 @@ std::shared_ptr<SimpleExtender> ExtendersGenerator::MakeLongReadsRNAExtender(siz
 shared_ptr<PathExtender> ExtendersGenerator::MakeMatePairScaffoldingExtender(size_t lib_index,
                                                                              const ScaffoldingUniqueEdgeStorage &storage) const {
 
-    const auto &lib = dataset_info_.reads[lib_index];
     const auto &pset = params_.pset;
     const auto &paired_indices = gp_.get<UnclusteredPairedInfoIndicesT<Graph>>();
     const auto &clustered_indices = gp_.get<PairedInfoIndicesT<Graph>>("clustered_indices");
@@ -208,10 +235,10 @@ shared_ptr<PathExtender> ExtendersGenerator::MakeMatePairScaffoldingExtender(siz
     //FIXME: DimaA
     if (paired_indices[lib_index].size() > clustered_indices[lib_index].size()) {
         INFO("Paired unclustered indices not empty, using them");
-        paired_lib = MakeNewLib(graph_, lib, paired_indices[lib_index]);
+        paired_lib = MakeUnclusteredLib(lib_index);
     } else if (clustered_indices[lib_index].size()) {
         INFO("clustered indices not empty, using them");
-        paired_lib = MakeNewLib(graph_, lib, clustered_indices[lib_index]);
+        paired_lib = MakeFrozenLib(lib_index, "clustered_indices");
     } else {
         ERROR("All paired indices are empty!");
     }
@@ -242,8 +269,7 @@ shared_ptr<PathExtender> ExtendersGenerator::MakeMatePairScaffoldingExtender(siz
 
 shared_ptr<SimpleExtender> ExtendersGenerator::MakeCoordCoverageExtender(size_t lib_index) const {
     const auto& lib = dataset_info_.reads[lib_index];
-    const auto &clustered_indices = gp_.get<PairedInfoIndicesT<Graph>>("clustered_indices");
-    auto paired_lib = MakeNewLib(graph_, lib, clustered_indices[lib_index]);
+    auto paired_lib = MakeFrozenLib(lib_index, "clustered_indices");
 
     auto provider = make_shared<CoverageAwareIdealInfoProvider>(graph_, paired_lib, lib.data().unmerged_read_length);
 
@@ -274,8 +300,7 @@ shared_ptr<SimpleExtender> ExtendersGenerator::MakeCoordCoverageExtender(size_t
 shared_ptr<SimpleExtender> ExtendersGenerator::MakeRNAExtender(size_t lib_index, bool investigate_loops) const {
 
     const auto &lib = dataset_info_.reads[lib_index];
-    const auto &clustered_indices = gp_.get<PairedInfoIndicesT<Graph>>("clustered_indices");
-    auto paired_lib = MakeNewLib(graph_, lib, clustered_indices[lib_index]);
+    auto paired_lib = MakeFrozenLib(lib_index, "clustered_indices");
 //    INFO("Threshold for lib #" << lib_index << ": " << paired_lib->GetSingleThreshold());
 
     auto cip = make_shared<CoverageAwareIdealInfoProvider>(graph_, paired_lib, lib.data().unmerged_read_length);
@@ -320,8 +345,7 @@ shared_ptr<SimpleExtender> ExtendersGenerator::MakeSimpleCoverageExtender(size_t
 
 shared_ptr<SimpleExtender> ExtendersGenerator::MakePEExtender(size_t lib_index, bool investigate_loops) const {
     const auto &lib = dataset_info_.reads[lib_index];
-    const auto &clustered_indices = gp_.get<PairedInfoIndicesT<Graph>>("clustered_indices");
-    shared_ptr<PairedInfoLibrary> paired_lib = MakeNewLib(graph_, lib, clustered_indices[lib_index]);
+    shared_ptr<PairedInfoLibrary> paired_lib = MakeFrozenLib(lib_index, "clustered_indices");
     VERIFY_MSG(!paired_lib->IsMp(), "Tried to create PE extender for MP library");
     auto opts = params_.pset.extension_options;
 //    INFO("Threshold for lib #" << lib_index << ": " << paired_lib->GetSingleThreshold());
@@ -10,6 +10,9 @@
 #include "modules/path_extend/gap_analyzer.hpp"
 #include "launch_support.hpp"
 
+#include <map>
+#include <set>
+
 namespace path_extend {
 
 using namespace debruijn_graph;
@@ -84,6 +87,11 @@ class ExtendersGenerator {
 
     const PELaunchSupport &support_;
 
+    // Paired libraries (read-only) shared by the extenders, keyed by the name of the indices and the library index
+    mutable std::map<std::pair<std::string, size_t>, std::shared_ptr<PairedInfoLibrary>> paired_libs_;
+    // Indices of the graph pack the libraries use frozen copies of
+    mutable std::set<std::pair<std::string, size_t>> frozen_indices_;
+
 public:
     ExtendersGenerator(const config::dataset &dataset_info,
                        const PathExtendParamsContainer &params,
@@ -101,6 +109,22 @@ public:
         used_unique_storage_(used_unique_storage),
         support_(support) { }
 
+    //Makes the extenders bound to another coverage map and used edges storage,
+    //paired libraries are shared with the original generator
+    ExtendersGenerator(const ExtendersGenerator &other,
+                       const GraphCoverageMap &cover_map,
+                       UsedUniqueStorage &used_unique_storage) :
+        dataset_info_(other.dataset_info_),
+        params_(other.params_),
+        gp_(other.gp_),
+        graph_(other.graph_),
+        cover_map_(cover_map),
+        unique_data_(other.unique_data_),
+        used_unique_storage_(used_unique_storage),
+        support_(other.support_),
+        paired_libs_(other.paired_libs_),
+        frozen_indices_(other.frozen_indices_) { }
+
     Extenders MakePBScaffoldingExtenders() const;
 
     Extenders MakeBasicExtenders() const;
@@ -111,17 +135,29 @@ public:
 
     Extenders MakePEExtenders() const;
 
+    //Clears the paired indices of the graph pack replaced by the frozen copies
+    void ReleaseFrozenIndices(GraphPack &gp) const;
+
+    void ReportPairedLibStats() const;
+
+    //Switches the shared paired libraries to (or from) the mode safe for the extenders of several threads
+    void SetConcurrentLibs(bool concurrent) const;
+
 private:
 
+    std::shared_ptr<PairedInfoLibrary> MakeFrozenLib(size_t lib_index, const std::string &indices) const;
+
+    std::shared_ptr<PairedInfoLibrary> MakeUnclusteredLib(size_t lib_index) const;
+
     std::shared_ptr<SimpleExtender> MakePEExtender(size_t lib_index, bool investigate_loops) const;
 
     Extenders MakeMPExtenders(const ScaffoldingUniqueEdgeStorage &storage) const;
 
     std::shared_ptr<ExtensionChooser> MakeLongReadsExtensionChooser(size_t lib_index,
-                                                                    const GraphCoverageMap &read_paths_cov_map) const;
+                                                                    const LongReadsCoverageMap &read_paths_cov_map) const;
 
     std::shared_ptr<SimpleExtender> MakeLongReadsExtender(size_t lib_index,
-                                                          const GraphCoverageMap &read_paths_cov_map) const;
+                                                          const LongReadsCoverageMap &read_paths_cov_map) const;
 
     std::shared_ptr<SimpleExtender> MakeLongEdgePEExtender(size_t lib_index,
                                                       bool investigate_loops) const;
@@ -141,9 +177,9 @@ private:
 
     std::shared_ptr<SimpleExtender> MakeSimpleCoverageExtender(size_t lib_index) const;
 
-    std::shared_ptr<ExtensionChooser> MakeLongReadsRNAExtensionChooser(size_t lib_index, const GraphCoverageMap& read_paths_cov_map) const;
+    std::shared_ptr<ExtensionChooser> MakeLongReadsRNAExtensionChooser(size_t lib_index, const LongReadsCoverageMap& read_paths_cov_map) const;
 
-    std::shared_ptr<SimpleExtender> MakeLongReadsRNAExtender(size_t lib_index, const GraphCoverageMap& read_paths_cov_map) const;
+    std::shared_ptr<SimpleExtender> MakeLongReadsRNAExtender(size_t lib_index, const LongReadsCoverageMap& read_paths_cov_map) const;
 
     void PrintExtenders(const std::vector<std::shared_ptr<PathExtender>> &extenders) const;
 
@@ -53,7 +53,8 @@ struct PathExtendParamsContainer {
         uneven_depth(uneven_depth_),
         avoid_rc_connections(avoid_rc_connections_),
         use_scaffolder(use_scaffolder_),
-        traverse_loops(true)
+        traverse_loops(true),
+        release_paired_indices(false)
     {
         if (!(use_scaffolder && pset.scaffolder_options.enabled)) {
             traverse_loops = false;
@@ -86,6 +87,8 @@ struct PathExtendParamsContainer {
     bool avoid_rc_connections;
     bool use_scaffolder;
     bool traverse_loops;
+    //The paired indices are not needed after the launch, so the frozen copies could replace them
+    bool release_paired_indices;
 
     //todo move to config
     size_t min_edge_len;
@@ -6,6 +6,7 @@
 
 #include "launcher.hpp"
 
+#include "assembly_graph/components/connected_component.hpp"
 #include "assembly_graph/core/basic_graph_stats.hpp"
 #include "assembly_graph/graph_support/coverage_uniformity_analyzer.hpp"
 #include "assembly_graph/graph_support/scaff_supplementary.hpp"
@@ -18,6 +19,7 @@
 #include "modules/path_extend/scaffolder2015/scaffold_graph_visualizer.hpp"
 #include "modules/path_extend/scaffolder2015/scaffold_graph_constructor.hpp"
 #include "modules/path_extend/scaffolder2015/path_polisher.hpp"
+#include "utils/parallel/openmp_wrapper.h"
 
 #include <unordered_set>
 
@@ -347,21 +349,15 @@ void PathExtendLauncher::FillPathContainer(size_t lib_index, size_t size_thresho
 
         DebugOutputPaths(unique_data_.long_reads_paths_[lib_index], "trusted_contigs");
         trusted_paths.clear();
+        DEBUG("Long reads paths " << unique_data_.long_reads_paths_[lib_index].size());
+        unique_data_.long_reads_cov_map_.emplace_back(graph_, unique_data_.long_reads_paths_[lib_index]);
     } else {
-        std::vector<PathInfo<Graph>> paths;
-        gp_.get_mutable<LongReadContainer<Graph>>()[lib_index].SaveAllPaths(paths);
-        for (const auto &path: paths) {
-            const auto &edges = path.path();
-            if (edges.size() <= size_threshold)
-                continue;
-
-            auto new_paths = unique_data_.long_reads_paths_[lib_index].CreatePair(graph_, std::move(edges));
-            new_paths.first.SetWeight((float) path.weight());
-            new_paths.second.SetWeight((float) path.weight());
-        }
+        // Read paths are queried right from the storage arena, paths not longer than size_threshold are skipped
+        auto &read_paths = gp_.get_mutable<LongReadContainer<Graph>>()[lib_index];
+        read_paths.BuildCoverageIndex(size_threshold + 1);
+        DEBUG("Long reads paths " << read_paths.size());
+        unique_data_.long_reads_cov_map_.emplace_back(graph_, read_paths);
     }
-    DEBUG("Long reads paths " << unique_data_.long_reads_paths_[lib_index].size());
-    unique_data_.long_reads_cov_map_[lib_index].AddPaths(unique_data_.long_reads_paths_[lib_index]);
 }
 
 
@@ -370,9 +366,10 @@ void PathExtendLauncher::FillLongReadsCoverageMaps() {
     for (size_t lib_index = 0; lib_index < dataset_info_.reads.lib_count(); lib_index++) {
         DEBUG("lib_index" << lib_index);
         unique_data_.long_reads_paths_.push_back(PathContainer());
-        unique_data_.long_reads_cov_map_.push_back(GraphCoverageMap(graph_));
         if (support_.IsForSingleReadExtender(dataset_info_.reads[lib_index])) {
             FillPathContainer(lib_index);
+        } else {
+            unique_data_.long_reads_cov_map_.emplace_back(graph_);
         }
     }
 }
@@ -413,13 +410,10 @@ Extenders PathExtendLauncher::ConstructPBExtenders(const ExtendersGenerator &gen
 }
 
 
-Extenders PathExtendLauncher::ConstructExtenders(const GraphCoverageMap &cover_map,
-                                                 UsedUniqueStorage &used_unique_storage) {
+Extenders PathExtendLauncher::ConstructExtenders(const ExtendersGenerator &generator) {
     INFO("Creating main extenders, unique edge length = " << unique_data_.min_unique_length_);
     if (!config::PipelineHelper::IsPlasmidPipeline(params_.mode) &&  (support_.SingleReadsMapped() || support_.HasLongReads()))
         FillLongReadsCoverageMaps();
-    ExtendersGenerator generator(dataset_info_, params_, gp_, cover_map,
-                                 unique_data_, used_unique_storage, support_);
     Extenders extenders = generator.MakeBasicExtenders();
     DEBUG("Total number of basic extenders is " << extenders.size());
 
@@ -448,6 +442,40 @@ Extenders PathExtendLauncher::ConstructExtenders(const GraphCoverageMap &cover_m
     return extenders;
 }
 
+PathContainer PathExtendLauncher::ExtendSeedsByComponents(PathContainer &seeds, const Extenders &extenders,
+                                                          const ExtendersGenerator &generator,
+                                                          GraphCoverageMap &cover_map,
+                                                          const PathExtendResolver &resolver) const {
+    //Extenders keep the state of the paths being grown, so every thread needs its own ones
+    size_t nthreads = omp_get_max_threads();
+    INFO("Creating extenders for " << nthreads << " threads");
+    std::vector<std::unique_ptr<GraphCoverageMap>> cover_maps;
+    std::vector<std::unique_ptr<UsedUniqueStorage>> used_storages;
+    std::vector<std::unique_ptr<CompositeExtender>> composite_extenders;
+    for (size_t i = 0; i < nthreads; ++i) {
+        cover_maps.push_back(std::make_unique<GraphCoverageMap>(graph_));
+        used_storages.push_back(std::make_unique<UsedUniqueStorage>(unique_data_.main_unique_storage_, graph_));
+        ExtendersGenerator thread_generator(generator, *cover_maps.back(), *used_storages.back());
+        //Mate-pair extenders are scaffolding ones and never get here
+        Extenders thread_extenders = thread_generator.MakeBasicExtenders();
+        if (params_.pset.use_coordinated_coverage)
+            utils::push_back_all(thread_extenders, thread_generator.MakeCoverageExtenders());
+        VERIFY_MSG(thread_extenders.size() == extenders.size(), "Thread extenders differ from the main ones");
+        composite_extenders.push_back(std::make_unique<CompositeExtender>(graph_, *cover_maps.back(),
+                                                                          *used_storages.back(),
+                                                                          thread_extenders));
+    }
+
+    //Local counter, the one of the graph pack affects the contig names once filled
+    ConnectedComponentCounter components(graph_);
+    components.CalculateComponents();
+    //The libraries of the thread extenders are the ones of the main generator
+    generator.SetConcurrentLibs(true);
+    auto paths = resolver.ExtendSeeds(seeds, components, composite_extenders, cover_map);
+    generator.SetConcurrentLibs(false);
+    return paths;
+}
+
 void PathExtendLauncher::PolishPaths(const PathContainer &paths, PathContainer &result,
                                      const GraphCoverageMap& /* cover_map */) const {
     //Fixes distances for paths gaps and tries to fill them in
@@ -628,12 +656,26 @@ void PathExtendLauncher::Launch() {
 
     GraphCoverageMap cover_map(graph_);
     UsedUniqueStorage used_unique_storage(unique_data_.main_unique_storage_, graph_);
-    Extenders extenders = ConstructExtenders(cover_map, used_unique_storage);
+    ExtendersGenerator generator(dataset_info_, params_, gp_, cover_map,
+                                 unique_data_, used_unique_storage, support_);
+    Extenders extenders = ConstructExtenders(generator);
+    if (params_.release_paired_indices)
+        generator.ReleaseFrozenIndices(gp_);
     CompositeExtender composite_extender(graph_, cover_map,
                                          used_unique_storage,
                                          extenders);
 
-    auto paths = resolver.ExtendSeeds(seeds, composite_extender);
+    //Without jumps the paths never leave the connected component of their seed,
+    //so the components could be processed independently
+    bool by_components = params_.pset.parallel_components && omp_get_max_threads() > 1;
+    if (by_components && composite_extender.MakesJumps()) {
+        INFO("Extenders may jump between connected components, seeds are grown sequentially");
+        by_components = false;
+    }
+    auto paths = by_components ?
+                 ExtendSeedsByComponents(seeds, extenders, generator, cover_map, resolver) :
+                 resolver.ExtendSeeds(seeds, composite_extender);
+    generator.ReportPairedLibStats();
     DebugOutputPaths(paths, "raw_paths");
 
     RemoveOverlapsAndArtifacts(paths, cover_map, resolver);
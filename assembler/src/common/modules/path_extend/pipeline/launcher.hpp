@@ -54,6 +54,7 @@ class PathExtendLauncher {
 
     void FillPBUniqueEdgeStorages();
 
+    // Appends the coverage map of the library to unique_data_.long_reads_cov_map_
     void FillPathContainer(size_t lib_index, size_t size_threshold = 1);
 
     void FillLongReadsCoverageMaps();
@@ -70,7 +71,12 @@ class PathExtendLauncher {
 
     void PolishPaths(const PathContainer &paths, PathContainer &result, const GraphCoverageMap &cover_map) const;
 
-    Extenders ConstructExtenders(const GraphCoverageMap &cover_map, UsedUniqueStorage &used_unique_storage);
+    Extenders ConstructExtenders(const ExtendersGenerator &generator);
+
+    PathContainer ExtendSeedsByComponents(PathContainer &seeds, const Extenders &extenders,
+                                          const ExtendersGenerator &generator,
+                                          GraphCoverageMap &cover_map,
+                                          const PathExtendResolver &resolver) const;
 
     Extenders ConstructMPExtenders(const ExtendersGenerator &generator);
 
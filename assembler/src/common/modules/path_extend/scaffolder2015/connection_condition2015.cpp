@@ -1,5 +1,5 @@
 #include "connection_condition2015.hpp"
-#include "assembly_graph/dijkstra/dijkstra_helper.hpp"
+#include "utils/parallel/openmp_wrapper.h"
 
 namespace path_extend {
 
@@ -55,7 +55,7 @@ double PairedLibConnectionCondition::GetWeight(debruijn_graph::EdgeId e1, debrui
 
 LongReadsLibConnectionCondition::LongReadsLibConnectionCondition(const debruijn_graph::Graph &graph,
                                                                  size_t lib_index,
-                                                                 size_t min_read_count, const GraphCoverageMap& cov_map):
+                                                                 size_t min_read_count, const LongReadsCoverageMap& cov_map):
         graph_(graph),
         lib_index_(lib_index),
         min_read_count_(min_read_count),
@@ -65,7 +65,7 @@ Connections LongReadsLibConnectionCondition::ConnectedWith(debruijn_graph::EdgeI
     return {};
 };
 
-bool LongReadsLibConnectionCondition::CheckPath(const BidirectionalPath &path, EdgeId e1, EdgeId e2) const {
+bool LongReadsLibConnectionCondition::CheckPath(const LongReadPath &path, EdgeId e1, EdgeId e2) const {
     auto pos1 = path.FindAll(e1);
     if (pos1.size() != 1) return false;
     auto pos2 = path.FindAll(e2);
@@ -87,18 +87,18 @@ Connections LongReadsLibConnectionCondition::ConnectedWith(debruijn_graph::EdgeI
     Connections res;
     auto cov_paths = cov_map_.GetCoveringPaths(e);
     DEBUG("Got cov paths " << cov_paths.size());
-    for (const BidirectionalPath *path : cov_paths) {
-        auto pos1 = path->FindAll(e);
+    for (const LongReadPath &path : cov_paths) {
+        auto pos1 = path.FindAll(e);
         if (pos1.size() != 1) {
             DEBUG("***not unique " << graph_.int_id(e) << " len " << graph_.length(e) << "***");
             continue;
         }
         size_t pos = pos1[0];
         pos++;
-        while (pos < path->Size()){
-            if (storage.IsUnique(path->At(pos))) {
-                if (CheckPath(*path, path->At(pos1[0]), path->At(pos))) {
-                    res[path->At(pos)] += path->GetWeight();
+        while (pos < path.Size()){
+            if (storage.IsUnique(path.At(pos))) {
+                if (CheckPath(path, path.At(pos1[0]), path.At(pos))) {
+                    res[path.At(pos)] += path.GetWeight();
                 }
                 break;
             }
@@ -121,11 +121,11 @@ Connections LongReadsLibConnectionCondition::ConnectedWith(debruijn_graph::EdgeI
 int LongReadsLibConnectionCondition::GetMedianGap(debruijn_graph::EdgeId e1, debruijn_graph::EdgeId e2) const {
     auto cov_paths = cov_map_.GetCoveringPaths(e1);
     std::vector<std::pair<int, double>> h;
-    for (const BidirectionalPath *path : cov_paths) {
-        if (CheckPath(*path, e1, e2)) {
-            auto pos1 = path->FindAll(e1);
-            auto pos2 = path->FindAll(e2);
-            h.emplace_back(path->LengthAt(pos1[0] + 1) - path->LengthAt(pos2[0]), path->GetWeight());
+    for (const LongReadPath &path : cov_paths) {
+        if (CheckPath(path, e1, e2)) {
+            auto pos1 = path.FindAll(e1);
+            auto pos2 = path.FindAll(e2);
+            h.emplace_back(path.LengthAt(pos1[0] + 1) - path.LengthAt(pos2[0]), path.GetWeight());
         }
     }
     std::sort(h.begin(), h.end());
@@ -227,31 +227,46 @@ AssemblyGraphConnectionCondition::AssemblyGraphConnectionCondition(const debruij
                                                                    size_t max_connection_length,
                                                                    const ScaffoldingUniqueEdgeStorage &unique_edges) :
         g_(g), max_connection_length_(max_connection_length),
-        interesting_edge_set_(unique_edges.unique_edges()), stored_distances_() {
+        interesting_edge_set_(unique_edges.unique_edges()), stored_distances_(),
+        dijkstras_(omp_get_max_threads()) {
+}
+
+AssemblyGraphConnectionCondition::BoundedDijkstra &AssemblyGraphConnectionCondition::ThreadDijkstra() const {
+    size_t thread = omp_get_thread_num();
+    VERIFY(thread < dijkstras_.size());
+    auto &dijkstra = dijkstras_[thread];
+    if (!dijkstra)
+        dijkstra = std::make_unique<BoundedDijkstra>(
+                omnigraph::DijkstraHelper<debruijn_graph::Graph>::CreateBoundedDijkstra(g_, max_connection_length_));
+    return *dijkstra;
 }
 
 Connections AssemblyGraphConnectionCondition::ConnectedWith(debruijn_graph::EdgeId e) const {
     VERIFY_MSG(interesting_edge_set_.find(e) != interesting_edge_set_.end(),
                " edge "<< e.int_id() << " not applicable for connection condition");
-    if (stored_distances_.find(e) != stored_distances_.end()) {
-        return stored_distances_[e];
+    {
+        std::lock_guard<std::mutex> lock(stored_distances_mutex_);
+        auto it = stored_distances_.find(e);
+        if (it != stored_distances_.end())
+            return it->second;
     }
-    stored_distances_.emplace(e, Connections());
+    Connections connections;
     for (auto connected: g_.OutgoingEdges(g_.EdgeEnd(e))) {
         if (interesting_edge_set_.find(connected) != interesting_edge_set_.end()) {
-            stored_distances_[e].emplace(connected, 1);
+            connections.emplace(connected, 1);
         }
     }
-    auto dijkstra = omnigraph::DijkstraHelper<debruijn_graph::Graph>::CreateBoundedDijkstra(g_, max_connection_length_);
+    auto &dijkstra = ThreadDijkstra();
     dijkstra.Run(g_.EdgeEnd(e));
     for (auto v: dijkstra.ReachedVertices()) {
         for (auto connected: g_.OutgoingEdges(v)) {
             if (interesting_edge_set_.find(connected) != interesting_edge_set_.end() && dijkstra.GetDistance(v) < max_connection_length_) {
-                stored_distances_[e].emplace(connected, 1);
+                connections.emplace(connected, 1);
             }
         }
     }
-    return stored_distances_[e];
+    std::lock_guard<std::mutex> lock(stored_distances_mutex_);
+    return stored_distances_.emplace(e, std::move(connections)).first->second;
 }
 void AssemblyGraphConnectionCondition::AddInterestingEdges(func::TypedPredicate<typename Graph::EdgeId> edge_condition) {
     for (EdgeId e : g_.edges()) {
@@ -3,10 +3,15 @@
 #include "assembly_graph/graph_support/scaff_supplementary.hpp"
 #include "modules/path_extend/paired_library.hpp"
 #include "modules/path_extend/pe_utils.hpp"
+#include "modules/path_extend/long_reads_coverage_map.hpp"
 #include "modules/alignment/long_read_storage.hpp"
+#include "assembly_graph/dijkstra/dijkstra_helper.hpp"
 #include "utils/logger/logger.hpp"
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <vector>
 
 namespace path_extend {
 
@@ -82,16 +87,16 @@ protected:
     size_t lib_index_;
 //Minimal number of reads to call connection sound
     size_t min_read_count_;
-    const GraphCoverageMap& cov_map_;
+    const LongReadsCoverageMap& cov_map_;
 
-    bool CheckPath(const BidirectionalPath &path, EdgeId e1, EdgeId e2) const;
+    bool CheckPath(const LongReadPath &path, EdgeId e1, EdgeId e2) const;
 
 public:
 //Only paired info with gap between e1 and e2 between -left_dist_delta_ and right_dist_delta_ taken in account
 
     LongReadsLibConnectionCondition(const Graph &graph,
                                  size_t lib_index,
-                                 size_t min_read_count, const GraphCoverageMap& cov_map);
+                                 size_t min_read_count, const LongReadsCoverageMap& cov_map);
     size_t GetLibIndex() const override;
     Connections ConnectedWith(EdgeId e) const override;
     Connections ConnectedWith(EdgeId e, const ScaffoldingUniqueEdgeStorage &storage) const override;
@@ -125,15 +130,21 @@ public:
 };
 
 /*  Condition used to find connected in graph edges.
-*
+*   Thread-safe, every thread reuses its own dijkstra.
 */
 class AssemblyGraphConnectionCondition : public ConnectionCondition {
+    typedef omnigraph::DijkstraHelper<Graph>::BoundedDijkstra BoundedDijkstra;
+
+    BoundedDijkstra &ThreadDijkstra() const;
+
 protected:
     const Graph &g_;
 //Maximal gap to the connection.
     size_t max_connection_length_;
     EdgeSet interesting_edge_set_;
     mutable std::map<EdgeId, Connections> stored_distances_;
+    mutable std::mutex stored_distances_mutex_;
+    mutable std::vector<std::unique_ptr<BoundedDijkstra>> dijkstras_;
 public:
     AssemblyGraphConnectionCondition(const Graph &g, size_t max_connection_length,
                                      const ScaffoldingUniqueEdgeStorage &unique_edges);
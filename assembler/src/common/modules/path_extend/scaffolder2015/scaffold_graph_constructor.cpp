@@ -4,6 +4,8 @@
 
 #include "scaffold_graph_constructor.hpp"
 
+#include "utils/parallel/openmp_wrapper.h"
+
 namespace path_extend {
 
 namespace scaffold_graph {
@@ -39,14 +41,26 @@ void BaseScaffoldGraphConstructor::ConstructFromConditions(ConnectionConditions
 
 void BaseScaffoldGraphConstructor::ConstructFromSingleCondition(const std::shared_ptr<ConnectionCondition> condition,
                                                                 bool use_terminal_vertices_only) {
-    for (const auto& v : graph_->vertices()) {
+    std::vector<ScaffoldGraph::ScaffoldVertex> vertices(graph_->vertices().begin(), graph_->vertices().end());
+
+    //Connections are found in parallel, while the edges are added sequentially in the vertex order,
+    //since the terminal vertices depend on the edges added before
+    std::vector<Connections> connections(vertices.size());
+    #pragma omp parallel for schedule(guided)
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        if (use_terminal_vertices_only && graph_->OutgoingEdgeCount(vertices[i]) > 0)
+            continue;
+        connections[i] = condition->ConnectedWith(vertices[i]);
+    }
+
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const auto &v = vertices[i];
         TRACE("Vertex " << graph_->int_id(v));
 
         if (use_terminal_vertices_only && graph_->OutgoingEdgeCount(v) > 0)
             continue;
 
-        auto connected_with = condition->ConnectedWith(v);
-        for (const auto& pair : connected_with) {
+        for (const auto& pair : connections[i]) {
             EdgeId connected = pair.first;
             double w = pair.second;
             TRACE("Connected with " << graph_->int_id(connected));
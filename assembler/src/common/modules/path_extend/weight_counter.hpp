@@ -114,8 +114,12 @@ public:
                                                      EdgeId candidate, int gap) const override {
         std::vector<EdgeWithPairedInfo> covered;
         for (int i = (int) path.Size() - 1; i >= 0; --i) {
-            double w = lib_->IdealPairedInfo(path[i], candidate,
-                                            (int) path.LengthAt(i) + gap);
+            int dist = (int) path.LengthAt(i) + gap;
+            // The gap to the candidate only grows towards the path start,
+            // so only the last insert size worth of the path is looked at
+            if (dist > 0 && dist - (int) path.g().length(path[i]) > lib_->MaxIdealGap())
+                break;
+            double w = lib_->IdealPairedInfo(path[i], candidate, dist);
             //FIXME think if we need extremely low ideal weights
             if (math::gr(w, 0.)) {
                 covered.push_back(EdgeWithPairedInfo(i, w));
@@ -0,0 +1,249 @@
+//***************************************************************************
+//* Copyright (c) 2021 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#pragma once
+
+#include "paired_info.hpp"
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace omnigraph {
+
+namespace de {
+
+/**
+ * @brief Read-only copy of a paired index in the compressed sparse row layout:
+ *        - offsets of the first edges (indexed by edge id) into the entries;
+ *        - entries sorted by the second edge, each one referring a range of points;
+ *        - all the points packed into a single array.
+ *        Conjugate pairs share their points, just like in the original index.
+ *        Provides the read-only part of the PairedIndex interface, so it could be
+ *        used wherever the index is only queried (e.g. PairedInfoLibraryWithIndex).
+ */
+template<typename G, typename Traits>
+class FrozenPairedIndex {
+    typedef typename Traits::Gapped InnerPoint;
+
+public:
+    typedef G Graph;
+    typedef typename Graph::EdgeId EdgeId;
+    typedef typename Traits::Expanded Point;
+
+    /**
+     * @brief Proxy set of points between two edges, see PairedIndex::HistProxy.
+     */
+    class HistProxy {
+    public:
+        class Iterator: public boost::iterator_facade<Iterator, Point, boost::random_access_traversal_tag, Point> {
+        public:
+            Iterator(const InnerPoint *ptr, DEDistance offset)
+                    : ptr_(ptr), offset_(offset) {}
+
+        private:
+            friend class boost::iterator_core_access;
+
+            Point dereference() const { return Traits::Expand(*ptr_, offset_); }
+            void increment() { ++ptr_; }
+            void decrement() { --ptr_; }
+            void advance(ptrdiff_t n) { ptr_ += n; }
+            ptrdiff_t distance_to(const Iterator &other) const { return other.ptr_ - ptr_; }
+            bool equal(const Iterator &other) const { return ptr_ == other.ptr_; }
+
+            const InnerPoint *ptr_;
+            DEDistance offset_;
+        };
+
+        HistProxy(const InnerPoint *begin = nullptr, const InnerPoint *end = nullptr, DEDistance offset = 0)
+                : begin_(begin), end_(end), offset_(offset) {}
+
+        Iterator begin() const { return Iterator(begin_, offset_); }
+        Iterator end() const { return Iterator(end_, offset_); }
+
+        Point min() const {
+            VERIFY(!empty());
+            return *begin();
+        }
+
+        Point max() const {
+            VERIFY(!empty());
+            return *--end();
+        }
+
+        Histogram<Point> Unwrap() const {
+            return Histogram<Point>(begin(), end());
+        }
+
+        size_t size() const { return end_ - begin_; }
+        bool empty() const { return begin_ == end_; }
+
+    private:
+        const InnerPoint *begin_, *end_;
+        DEDistance offset_;
+    };
+
+    typedef std::pair<EdgeId, HistProxy> EdgeHist;
+
+private:
+    struct Entry {
+        EdgeId e2;
+        size_t begin, end;
+    };
+
+public:
+    /**
+     * @brief Proxy map of the neighbourhood of an edge, see PairedIndex::EdgeProxy.
+     */
+    class EdgeProxy {
+    public:
+        class Iterator: public boost::iterator_facade<Iterator, EdgeHist, boost::forward_traversal_tag, EdgeHist> {
+        public:
+            Iterator(const FrozenPairedIndex &index, const Entry *entry, DEDistance offset)
+                    : index_(&index), entry_(entry), offset_(offset) {}
+
+        private:
+            friend class boost::iterator_core_access;
+
+            EdgeHist dereference() const {
+                return std::make_pair(entry_->e2, index_->MakeProxy(*entry_, offset_));
+            }
+            void increment() { ++entry_; }
+            bool equal(const Iterator &other) const { return entry_ == other.entry_; }
+
+            const FrozenPairedIndex *index_;
+            const Entry *entry_;
+            DEDistance offset_;
+        };
+
+        EdgeProxy(const FrozenPairedIndex &index, EdgeId e, const Entry *begin, const Entry *end)
+                : index_(index), e_(e), begin_(begin), end_(end) {}
+
+        Iterator begin() const { return Iterator(index_, begin_, index_.CalcOffset(e_)); }
+        Iterator end() const { return Iterator(index_, end_, index_.CalcOffset(e_)); }
+
+        HistProxy operator[](EdgeId e2) const { return index_.Get(e_, e2); }
+
+        bool empty() const { return begin_ == end_; }
+
+    private:
+        const FrozenPairedIndex &index_;
+        EdgeId e_;
+        const Entry *begin_, *end_;
+    };
+
+    /**
+     * @brief Freezes the current state of the index.
+     */
+    template<template<typename, typename> class Container>
+    explicit FrozenPairedIndex(const PairedIndex<G, Traits, Container> &index)
+            : graph_(index.graph()), size_(index.size()) {
+        size_t max_id = 0, nentries = 0;
+        for (auto it = index.data_begin(); it != index.data_end(); ++it) {
+            max_id = std::max<size_t>(max_id, it->first.int_id());
+            nentries += it->second.size();
+        }
+
+        offsets_.reserve(max_id + 2);
+        entries_.reserve(nentries);
+        for (auto it = index.data_begin(); it != index.data_end(); ++it) {
+            EdgeId e1 = it->first;
+            // Storage is ordered, so the entries are appended in the order of ids
+            VERIFY(offsets_.size() <= e1.int_id());
+            offsets_.resize(e1.int_id() + 1, entries_.size());
+            for (const auto &entry : it->second) {
+                // The histogram of a pair is owned by the smaller of it and its
+                // conjugate one and viewed by the other, so the owner is already here
+                const Entry *owner = entry.second.owning() ? nullptr :
+                                     Find(graph_.conjugate(entry.first), graph_.conjugate(e1));
+                if (owner) {
+                    entries_.push_back({ entry.first, owner->begin, owner->end });
+                } else {
+                    size_t begin = points_.size();
+                    points_.insert(points_.end(), entry.second->begin(), entry.second->end());
+                    entries_.push_back({ entry.first, begin, points_.size() });
+                }
+            }
+        }
+        offsets_.resize(max_id + 2, entries_.size());
+        points_.shrink_to_fit();
+    }
+
+    /**
+     * @brief Returns a histogram proxy for all points between two edges.
+     */
+    HistProxy Get(EdgeId e1, EdgeId e2) const {
+        const Entry *entry = Find(e1, e2);
+        if (!entry)
+            return HistProxy();
+        return MakeProxy(*entry, CalcOffset(e1));
+    }
+
+    /**
+     * @brief Returns a whole proxy map to the neighbourhood of some edge.
+     */
+    EdgeProxy Get(EdgeId e) const {
+        const Entry *begin, *end;
+        std::tie(begin, end) = Range(e);
+        return EdgeProxy(*this, e, begin, end);
+    }
+
+    bool contains(EdgeId e1, EdgeId e2) const {
+        return !Get(e1, e2).empty();
+    }
+
+    /**
+     * @brief Returns the physical index size (total count of all histograms).
+     */
+    size_t size() const { return size_; }
+
+    const Graph &graph() const { return graph_; }
+
+private:
+    std::pair<const Entry*, const Entry*> Range(EdgeId e) const {
+        size_t id = e.int_id();
+        if (id >= offsets_.size())
+            return { nullptr, nullptr };
+        // The last row is still open while the index is being frozen
+        size_t end = id + 1 < offsets_.size() ? offsets_[id + 1] : entries_.size();
+        return { entries_.data() + offsets_[id], entries_.data() + end };
+    }
+
+    const Entry *Find(EdgeId e1, EdgeId e2) const {
+        const Entry *begin, *end;
+        std::tie(begin, end) = Range(e1);
+        const Entry *entry = std::lower_bound(begin, end, e2,
+                                              [](const Entry &a, EdgeId b) { return a.e2 < b; });
+        return entry != end && entry->e2 == e2 ? entry : nullptr;
+    }
+
+    HistProxy MakeProxy(const Entry &entry, DEDistance offset) const {
+        return HistProxy(points_.data() + entry.begin, points_.data() + entry.end, offset);
+    }
+
+    DEDistance CalcOffset(EdgeId e) const {
+        return DEDistance(graph_.length(e));
+    }
+
+    const Graph &graph_;
+    size_t size_;
+    // Entries of e1 are [offsets_[e1], offsets_[e1 + 1])
+    std::vector<size_t> offsets_;
+    std::vector<Entry> entries_;
+    std::vector<InnerPoint> points_;
+};
+
+template<typename Graph>
+using FrozenPairedInfoIndexT = FrozenPairedIndex<Graph, PointTraits>;
+
+template<typename Graph>
+using FrozenUnclusteredPairedInfoIndexT = FrozenPairedIndex<Graph, RawPointTraits>;
+
+}
+
+}
@@ -87,7 +87,8 @@ enum class output_broken_scaffolds: char {
 enum class Checkpoints : char {
     None = 0,
     Last,
-    All
+    All,
+    Incremental
 };
 
 std::vector<std::string> SingleReadResolveModeNames();
@@ -10,6 +10,7 @@
 #include "assembly_graph/graph_support/detail_coverage.hpp"
 #include "assembly_graph/graph_support/genomic_quality.hpp"
 #include "assembly_graph/handlers/edges_position_handler.hpp"
+#include "assembly_graph/handlers/graph_journal.hpp"
 #include "assembly_graph/paths/bidirectional_path_container.hpp"
 #include "common/modules/alignment/rna/ss_coverage.hpp"
 #include "modules/alignment/edge_index.hpp"
@@ -43,6 +44,8 @@ GraphPack::GraphPack(size_t k, const std::string &workdir, size_t lib_count,
     emplace<EdgesPositionHandler<Graph>>(g, max_mapping_gap + k, max_gap_diff);
     emplace<ConnectedComponentCounter>(g);
     emplace_with_key<path_extend::PathContainer>("exSPAnder paths");
+    // Attached only when incremental checkpoints are enabled
+    emplace<omnigraph::GraphJournal<Graph>>(g).Detach();
     if (detach_indices)
         DetachAll();
 }
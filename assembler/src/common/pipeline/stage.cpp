@@ -7,6 +7,7 @@
 
 #include "io/dataset_support/read_converter.hpp"
 #include "io/binary/graph_pack.hpp"
+#include "io/binary/graph_delta.hpp"
 
 #include "pipeline/stage.hpp"
 
@@ -21,6 +22,13 @@ namespace spades {
 
 constexpr char BASE_NAME[] = "graph_pack";
 
+using GraphJournal = omnigraph::GraphJournal<debruijn_graph::Graph>;
+
+static bool IsFullSave(const std::string &basename) {
+    return fs::FileExists(basename + ".toc") &&
+           !io::binary::GraphDeltaIO<debruijn_graph::Graph>::Exists(basename);
+}
+
 void AssemblyStage::load(debruijn_graph::GraphPack& gp,
                          const std::string &load_from,
                          const char* prefix) {
@@ -36,7 +44,7 @@ void AssemblyStage::load(debruijn_graph::GraphPack& gp,
 
 }
 
-void AssemblyStage::save(const debruijn_graph::GraphPack& gp,
+bool AssemblyStage::save(const debruijn_graph::GraphPack& gp,
                          const std::string &save_to,
                          const char* prefix) const {
     if (!prefix) prefix = id_;
@@ -46,8 +54,43 @@ void AssemblyStage::save(const debruijn_graph::GraphPack& gp,
     fs::make_dir(dir);
 
     auto p = fs::append_path(dir, BASE_NAME);
-    io::binary::FullPackIO().Save(p, gp);
+    const auto &journal = gp.get<GraphJournal>();
+    bool full = !(journal.IsAttached() && journal.has_base() && journal.base_name() != prefix);
+    if (full)
+        io::binary::FullPackIO().Save(p, gp);
+    else
+        io::binary::IncrementalPackIO(journal).Save(p, gp);
     debruijn_graph::config::write_lib_data(p);
+    return full;
+}
+
+void AssemblyStage::checkpoint(debruijn_graph::GraphPack &gp,
+                               const std::string &save_to,
+                               const char *prefix) const {
+    if (!prefix) prefix = id_;
+    auto &journal = gp.get_mutable<GraphJournal>();
+    if (!journal.IsAttached()) {
+        save(gp, save_to, prefix);
+        return;
+    }
+
+    // A fresh full save becomes the base for the following incremental ones.
+    // Note that some stages do not save anything at all
+    if (save(gp, save_to, prefix))
+        journal.Rebase(prefix);
+}
+
+void AssemblyStage::rebase(debruijn_graph::GraphPack &gp,
+                           const SavesPolicy &policy,
+                           const char *prefix) const {
+    if (!prefix) prefix = id_;
+    auto &journal = gp.get_mutable<GraphJournal>();
+    // Only the saves in the same directory could serve as the base
+    if (!journal.IsAttached() || policy.LoadPath() != policy.SavesPath())
+        return;
+
+    if (IsFullSave(fs::append_path(fs::append_path(policy.LoadPath(), prefix), BASE_NAME)))
+        journal.Rebase(prefix);
 }
 
 class StageIdComparator {
@@ -108,9 +151,11 @@ void CompositeStageBase::run(debruijn_graph::GraphPack& gp,
             composite_id += prev_phase->id();
             TIME_TRACE_SCOPE("load phase", composite_id);
             prev_phase->load(gp, parent_->saves_policy().LoadPath(), composite_id.c_str());
+            prev_phase->rebase(gp, parent_->saves_policy(), composite_id.c_str());
         }
     }
 
+    std::string prev_saves;
     for (auto et = phases_.end(); start_phase != et; ++start_phase) {
         PhaseBase *phase = start_phase->get();
 
@@ -126,9 +171,10 @@ void CompositeStageBase::run(debruijn_graph::GraphPack& gp,
             composite_id += phase->id();
 
             TIME_TRACE_SCOPE("save phase", composite_id);
-            phase->save(gp, parent_->saves_policy().SavesPath(), composite_id.c_str());
-            //TODO: currently no phases are writing saves.
-            //When they will, erase the previous saves when SavesPolicy::Last
+            phase->checkpoint(gp, parent_->saves_policy().SavesPath(), composite_id.c_str());
+            if (!prev_saves.empty() && parent_->saves_policy().EnabledCheckpoints() == SavesPolicy::Checkpoints::Last)
+                fs::remove_if_exists(fs::append_path(parent_->saves_policy().SavesPath(), prev_saves));
+            prev_saves = composite_id;
         }
     }
 
@@ -142,6 +188,12 @@ void AssemblyStage::prepare(debruijn_graph::GraphPack& g,
 
 void StageManager::run(debruijn_graph::GraphPack& g,
                        const char* start_from) {
+    if (saves_policy_.EnabledCheckpoints() == SavesPolicy::Checkpoints::Incremental) {
+        auto &journal = g.get_mutable<GraphJournal>();
+        if (!journal.IsAttached())
+            journal.Attach();
+    }
+
     auto start_stage = stages_.begin();
     if (start_from) {
         if (strcmp(start_from, "last") == 0) {
@@ -170,6 +222,7 @@ void StageManager::run(debruijn_graph::GraphPack& g,
             while (start_stage != stages_.begin()) {
                 try {
                     (*std::prev(start_stage))->load(g, saves_policy_.LoadPath());
+                    (*std::prev(start_stage))->rebase(g, saves_policy_);
                     break;
                 } catch (const std::ios_base::failure& fail) {
                     INFO("Rolling back the loading to the previous stage (from '" << start_stage->get()->name() << "' to '" << std::prev(start_stage)->get()->name() << "'), because: " << fail.what());
@@ -193,7 +246,7 @@ void StageManager::run(debruijn_graph::GraphPack& g,
             auto prev_saves = saves_policy_.GetLastCheckpoint();
             {
                 TIME_TRACE_SCOPE("save", saves_policy_.SavesPath());
-                stage->save(g, saves_policy_.SavesPath());
+                stage->checkpoint(g, saves_policy_.SavesPath());
             }
             saves_policy_.UpdateCheckpoint(stage->id());
             if (!prev_saves.empty() && saves_policy_.EnabledCheckpoints() == SavesPolicy::Checkpoints::Last) {
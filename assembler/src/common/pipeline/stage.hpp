@@ -20,6 +20,7 @@
 namespace spades {
 
 class StageManager;
+class SavesPolicy;
 
 class AssemblyStage {
 public:
@@ -35,8 +36,14 @@ public:
 
     /// @throw std::ios_base::failure if load_from does not contain all required files
     virtual void load(debruijn_graph::GraphPack &, const std::string &load_from, const char *prefix = nullptr);
-    virtual void save(const debruijn_graph::GraphPack &, const std::string &save_to,
+    /// @return true if the whole graph pack was saved, so the save could be the base of incremental ones
+    virtual bool save(const debruijn_graph::GraphPack &, const std::string &save_to,
                       const char *prefix = nullptr) const;
+    /// Saves the stage and keeps the graph journal in sync with the saves in incremental mode
+    void checkpoint(debruijn_graph::GraphPack &, const std::string &save_to,
+                    const char *prefix = nullptr) const;
+    /// Makes the loaded save the base for the following incremental ones, if possible
+    void rebase(debruijn_graph::GraphPack &, const SavesPolicy &policy, const char *prefix = nullptr) const;
     void prepare(debruijn_graph::GraphPack &, const char *stage_name, const char *started_from = nullptr);
     virtual void run(debruijn_graph::GraphPack &, const char *started_from = nullptr) = 0;
 
@@ -264,6 +264,7 @@ public:
     Seq end(size_t k) const;
 
     inline std::string str() const;
+    inline void AppendStr(std::string &out) const;
 
     inline std::string err() const;
 
@@ -289,6 +290,14 @@ public:
 public:
     inline bool BinRead(std::istream &file);
     inline bool BinWrite(std::ostream &file) const;
+
+    // Dense 2-bit packing without a header: 4 nucleotides per byte, the first
+    // one in the lowest bits, i.e. the byte image of the nucleotide buffer
+    static size_t PackedSize(size_t size) {
+        return (size + 3) >> 2;
+    }
+    inline static Sequence PackedRead(const uint8_t *data, size_t size);
+    inline void PackedWrite(std::string &out) const;
 };
 
 inline std::ostream &operator<<(std::ostream &os, const Sequence &s);
@@ -375,13 +384,48 @@ Sequence Sequence::operator+(const Sequence &s) const {
 }
 
 std::string Sequence::str() const {
-    std::string res(size_, '-');
-    for (size_t i = 0; i < size_; ++i) {
-        res[i] = nucl(this->operator[](i));
-    }
+    std::string res;
+    AppendStr(res);
     return res;
 }
 
+void Sequence::AppendStr(std::string &out) const {
+    // Every byte of the buffer expands into 4 nucleotides at once, in direct
+    // or reverse-complement order. The unaligned ends go one by one.
+    struct NuclTable {
+        char fwd[256][4], rc[256][4];
+        NuclTable() {
+            for (unsigned b = 0; b < 256; ++b) {
+                for (unsigned j = 0; j < 4; ++j) {
+                    fwd[b][j] = nucl((b >> (2 * j)) & 3);
+                    rc[b][j] = nucl(complement((b >> (2 * (3 - j))) & 3));
+                }
+            }
+        }
+    };
+    static const NuclTable table;
+
+    size_t pos = out.size();
+    out.resize(pos + size_);
+    char *res = &out[pos];
+    const uint8_t *bytes = reinterpret_cast<const uint8_t*>(data_->data());
+
+    size_t i = 0;
+    if (!rtl_) {
+        for (; i < size_ && ((from_ + i) & 3); ++i)
+            res[i] = nucl(this->operator[](i));
+        for (; i + 4 <= size_; i += 4)
+            memcpy(res + i, table.fwd[bytes[(from_ + i) >> 2]], 4);
+    } else {
+        for (; i < size_ && ((from_ + size_ - 1 - i) & 3) != 3; ++i)
+            res[i] = nucl(this->operator[](i));
+        for (; i + 4 <= size_; i += 4)
+            memcpy(res + i, table.rc[bytes[(from_ + size_ - 1 - i) >> 2]], 4);
+    }
+    for (; i < size_; ++i)
+        res[i] = nucl(this->operator[](i));
+}
+
 std::string Sequence::err() const {
     std::ostringstream oss;
     oss << "{ *data=" << data_->data() <<
@@ -441,6 +485,27 @@ bool Sequence::BinWrite(std::ostream &file) const {
     return !file.fail();
 }
 
+Sequence Sequence::PackedRead(const uint8_t *data, size_t size) {
+    Sequence res(size, 0);
+    ST *words = res.data_->data();
+    size_t bytes = PackedSize(size);
+    memset(words, 0, DataSize(size) * sizeof(ST));
+    memcpy(words, data, bytes);
+    if (size & 3) // Drop whatever follows the last nucleotide
+        reinterpret_cast<uint8_t*>(words)[bytes - 1] &= uint8_t((1 << ((size & 3) << 1)) - 1);
+
+    return res;
+}
+
+void Sequence::PackedWrite(std::string &out) const {
+    if (from_ != 0 || rtl_) {
+        Sequence clear(this->str());
+        return clear.PackedWrite(out);
+    }
+
+    out.append(reinterpret_cast<const char*>(data_->data()), PackedSize(size_));
+}
+
 /**
  * @class SequenceBuilder
  * @section DESCRIPTION
@@ -22,6 +22,8 @@
 #include "utils/filesystem/temporary.hpp"
 #include "utils/ph_map/coverage_hash_map_builder.hpp"
 
+#include <fstream>
+
 
 namespace debruijn_graph {
 
@@ -34,14 +36,83 @@ struct ConstructionStorage {
     utils::DeBruijnExtensionIndex<> ext_index;
 
     std::unique_ptr<qf::cqf> cqf;
+    // The CQF does not change after counting, so it is serialized once and
+    // hard-linked from the last save into the following ones
+    mutable std::string cqf_file;
     std::unique_ptr<kmers::KMerDiskStorage<RtSeq>> kmers;
     std::unique_ptr<CoverageMap> coverage_map;
     config::debruijn_config::construction params;
     io::ReadStreamList<io::SingleReadSeq> read_streams;
     io::ReadStreamList<io::SingleReadSeq> contigs_streams;
     fs::TmpDir workdir;
+
+    // Replaces the input streams with the ones skipping low-covered reads
+    void FilterReadStreams() {
+        unsigned kplusone = ext_index.k() + 1;
+        rolling_hash::SymmetricCyclicHash<rolling_hash::NDNASeqHash> hasher(kplusone);
+        read_streams = io::CovFilteringWrap(std::move(read_streams), kplusone, hasher, *cqf, params.read_cov_threshold);
+    }
+
+    // Phase checkpoints: everything built so far (besides the graph itself)
+    // is saved into the directory. All the large parts are stored in a raw
+    // form, the k+1-mer buckets and the CQF are even hard-linked when possible.
+    void save(const std::string &dir, bool with_ext_index) const {
+        if (cqf) {
+            std::string fname = fs::append_path(dir, "cqf");
+            if (!cqf_file.empty() && fs::is_regular_file(cqf_file))
+                fs::link_or_copy(cqf_file, fname);
+            else
+                cqf->serialize(fname);
+            cqf_file = fname;
+        }
+        if (kmers)
+            kmers->save(fs::append_path(dir, "kpomers"));
+        if (with_ext_index) {
+            std::ofstream os(fs::append_path(dir, "ext_index"), std::ios::binary);
+            ext_index.BinWrite(os, fs::append_path(dir, "ext_index.kmers"));
+            VERIFY_MSG(os.good(), "Cannot write extension index to " << dir);
+        }
+    }
+
+    /// @throw std::ios_base::failure if dir does not contain all required files
+    void load(const std::string &dir, bool with_kmers, bool with_ext_index) {
+        std::string fname = fs::append_path(dir, "cqf");
+        if (params.read_cov_threshold) {
+            if (!fs::is_regular_file(fname))
+                throw std::ios_base::failure("Missing k-mer multiplicity filter in " + dir);
+            cqf.reset(new qf::cqf(fname));
+            cqf_file = fname;
+            FilterReadStreams();
+        }
+
+        if (with_kmers)
+            kmers.reset(new kmers::KMerDiskStorage<RtSeq>(
+                kmers::KMerDiskStorage<RtSeq>::load(workdir, fs::append_path(dir, "kpomers"))));
+
+        if (with_ext_index) {
+            std::ifstream is(fs::append_path(dir, "ext_index"), std::ios::binary);
+            if (!is.good())
+                throw std::ios_base::failure("Missing extension index in " + dir);
+            ext_index.BinRead(is, fs::append_path(dir, "ext_index.kmers"), workdir);
+        }
+    }
 };
 
+// Phase checkpoints are saved into a fresh directory, same as stage ones
+static std::string PhaseSaveDir(const std::string &save_to, const char *prefix) {
+    auto dir = fs::append_path(save_to, prefix);
+    INFO("Saving current state to " << dir);
+    fs::remove_if_exists(dir);
+    fs::make_dir(dir);
+    return dir;
+}
+
+static std::string PhaseLoadDir(const std::string &load_from, const char *prefix) {
+    auto dir = fs::append_path(load_from, prefix);
+    INFO("Loading current state from " << dir);
+    return dir;
+}
+
 bool add_trusted_contigs(io::DataSet<config::LibraryData> &libraries,
                        io::ReadStreamList<io::SingleReadSeq> &trusted_list) {
     std::vector<size_t> trusted_contigs;
@@ -192,24 +263,26 @@ class CoverageFilter: public Construction::Phase {
 
         // Create main CQF using # of slots derived from estimated # of k-mers
         storage().cqf.reset(new qf::cqf(kmers));
+        storage().cqf_file.clear();
 
         INFO("Building k-mer coverage histogram");
         FillCoverageHistogram(*storage().cqf, kplusone, hasher, read_streams, rthr, KmerFilter());
 
         // Replace input streams with wrapper ones
-        storage().read_streams = io::CovFilteringWrap(std::move(read_streams), kplusone, hasher, *storage().cqf, rthr);
+        storage().FilterReadStreams();
     }
 
     void load(debruijn_graph::GraphPack&,
-              const std::string &,
-              const char*) override {
-        VERIFY_MSG(false, "implement me");
+              const std::string &load_from,
+              const char* prefix) override {
+        storage().load(PhaseLoadDir(load_from, prefix), false, false);
     }
 
-    void save(const debruijn_graph::GraphPack&,
-              const std::string &,
-              const char*) const override {
-        // VERIFY_MSG(false, "implement me");
+    bool save(const debruijn_graph::GraphPack&,
+              const std::string &save_to,
+              const char* prefix) const override {
+        storage().save(PhaseSaveDir(save_to, prefix), false);
+        return false;
     }
 
 };
@@ -239,23 +312,28 @@ public:
         using Splitter =  utils::DeBruijnReadKMerSplitter<io::SingleReadSeq,
                                                           utils::StoringTypeFilter<storing_type>>;
 
-        kmers::KMerDiskCounter<RtSeq>
-                counter(storage().workdir,
-                        Splitter(storage().workdir, index.k() + 1, merge_streams, buffer_size));
+        Splitter splitter(storage().workdir, index.k() + 1, merge_streams, buffer_size);
+        // Count k+1-mer multiplicities along the way, so coverage could be
+        // filled without another pass over the reads. Trusted contigs must not
+        // contribute to the coverage, so in their presence we cannot do this.
+        splitter.set_count_multiplicities(contigs_streams.size() == 0);
+
+        kmers::KMerDiskCounter<RtSeq> counter(storage().workdir, std::move(splitter));
         auto kmers = counter.Count(10 * nthreads, nthreads);
         storage().kmers.reset(new kmers::KMerDiskStorage<RtSeq>(std::move(kmers)));
     }
 
     void load(debruijn_graph::GraphPack&,
-              const std::string &,
-              const char*) override {
-        VERIFY_MSG(false, "implement me");
+              const std::string &load_from,
+              const char* prefix) override {
+        storage().load(PhaseLoadDir(load_from, prefix), true, false);
     }
 
-    void save(const debruijn_graph::GraphPack&,
-              const std::string &,
-              const char*) const override {
-        // VERIFY_MSG(false, "implement me");
+    bool save(const debruijn_graph::GraphPack&,
+              const std::string &save_to,
+              const char* prefix) const override {
+        storage().save(PhaseSaveDir(save_to, prefix), false);
+        return false;
     }
 };
 
@@ -276,15 +354,16 @@ public:
     }
 
     void load(debruijn_graph::GraphPack&,
-              const std::string &,
-              const char*) override {
-        VERIFY_MSG(false, "implement me");
+              const std::string &load_from,
+              const char* prefix) override {
+        storage().load(PhaseLoadDir(load_from, prefix), true, true);
     }
 
-    void save(const debruijn_graph::GraphPack&,
-              const std::string &,
-              const char*) const override {
-        // VERIFY_MSG(false, "implement me");
+    bool save(const debruijn_graph::GraphPack&,
+              const std::string &save_to,
+              const char* prefix) const override {
+        storage().save(PhaseSaveDir(save_to, prefix), true);
+        return false;
     }
 };
 
@@ -305,15 +384,16 @@ public:
     }
 
     void load(debruijn_graph::GraphPack&,
-              const std::string &,
-              const char*) override {
-        VERIFY_MSG(false, "implement me");
+              const std::string &load_from,
+              const char* prefix) override {
+        storage().load(PhaseLoadDir(load_from, prefix), true, true);
     }
 
-    void save(const debruijn_graph::GraphPack&,
-              const std::string &,
-              const char*) const override {
-        // VERIFY_MSG(false, "implement me");
+    bool save(const debruijn_graph::GraphPack&,
+              const std::string &save_to,
+              const char* prefix) const override {
+        storage().save(PhaseSaveDir(save_to, prefix), true);
+        return false;
     }
 };
 
@@ -331,15 +411,16 @@ public:
     }
 
     void load(debruijn_graph::GraphPack&,
-              const std::string &,
-              const char*) override {
-        VERIFY_MSG(false, "implement me");
+              const std::string &load_from,
+              const char* prefix) override {
+        storage().load(PhaseLoadDir(load_from, prefix), true, true);
     }
 
-    void save(const debruijn_graph::GraphPack&,
-              const std::string &,
-              const char*) const override {
-        // VERIFY_MSG(false, "implement me");
+    bool save(const debruijn_graph::GraphPack&,
+              const std::string &save_to,
+              const char* prefix) const override {
+        storage().save(PhaseSaveDir(save_to, prefix), true);
+        return false;
     }
 };
 
@@ -357,17 +438,20 @@ public:
         DeBruijnGraphExtentionConstructor<Graph>(gp.get_mutable<Graph>(), storage().ext_index).ConstructGraph(storage().params.keep_perfect_loops);
     }
 
-    void load(debruijn_graph::GraphPack&,
-              const std::string &,
-              const char*) override {
-        VERIFY_MSG(false, "implement me");
+    // The extension index is not needed anymore, the graph is saved instead
+    void load(debruijn_graph::GraphPack &gp,
+              const std::string &load_from,
+              const char* prefix) override {
+        Construction::Phase::load(gp, load_from, prefix);
+        storage().load(PhaseLoadDir(load_from, prefix), true, false);
     }
 
-    void save(const debruijn_graph::GraphPack&,
-              const std::string &,
-              const char*) const override {
-        //FIXME why commented here and others
-        // VERIFY_MSG(false, "implement me");
+    bool save(const debruijn_graph::GraphPack &gp,
+              const std::string &save_to,
+              const char* prefix) const override {
+        bool full = Construction::Phase::save(gp, save_to, prefix);
+        storage().save(fs::append_path(save_to, prefix), false);
+        return full;
     }
 };
 
@@ -391,10 +475,11 @@ public:
         VERIFY_MSG(false, "implement me");
     }
 
-    void save(const debruijn_graph::GraphPack&,
+    bool save(const debruijn_graph::GraphPack&,
               const std::string &,
               const char*) const override {
         // VERIFY_MSG(false, "implement me");
+        return false;
     }
 };
 
@@ -450,17 +535,17 @@ public:
         gp.get_mutable<GenomicInfo>().set_cov_histogram(hist);
     }
 
+    // This is the last phase: the coverage map is consumed here and the
+    // stage itself saves the graph pack right after
     void load(debruijn_graph::GraphPack&,
               const std::string &,
               const char*) override {
-        VERIFY_MSG(false, "implement me");
+        VERIFY_MSG(false, "There is no construction phase after " << id());
     }
 
-    void save(const debruijn_graph::GraphPack&,
+    bool save(const debruijn_graph::GraphPack&,
               const std::string &,
-              const char*) const override {
-        // VERIFY_MSG(false, "implement me");
-    }
+              const char*) const override { return false; }
 
 };
 
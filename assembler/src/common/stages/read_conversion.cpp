@@ -23,13 +23,14 @@ void ReadConversion::load(debruijn_graph::GraphPack &,
     debruijn_graph::config::load_lib_data(p);
 }
 
-void ReadConversion::save(const debruijn_graph::GraphPack &,
+bool ReadConversion::save(const debruijn_graph::GraphPack &,
                          const std::string &save_to,
                          const char* prefix) const {
     std::string p = fs::append_path(save_to, prefix == NULL ? id() : prefix);
     INFO("Saving current state to " << p);
 
     debruijn_graph::config::write_lib_data(p);
+    return false;
 }
 
 } // namespace spades
@@ -17,7 +17,7 @@ public:
 
     void run(debruijn_graph::GraphPack &, const char *) override;
     void load(debruijn_graph::GraphPack &, const std::string &load_from, const char *prefix = nullptr) override;
-    void save(const debruijn_graph::GraphPack &, const std::string &save_to, const char *prefix = nullptr) const override;
+    bool save(const debruijn_graph::GraphPack &, const std::string &save_to, const char *prefix = nullptr) const override;
 };
 
 }
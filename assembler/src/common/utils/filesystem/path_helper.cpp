@@ -12,6 +12,7 @@
 #include <boost/tokenizer.hpp>
 #include <boost/algorithm/string.hpp>
 
+#include <fstream>
 #include <string>
 #include <vector>
 
@@ -155,6 +156,20 @@ void remove_if_exists(std::string const& path) {
     }
 }
 
+void link_or_copy(std::string const& from, std::string const& to) {
+    remove_if_exists(to);
+    if (link(from.c_str(), to.c_str()) == 0)
+        return;
+
+    std::ifstream is(from, std::ios::binary);
+    std::ofstream os(to, std::ios::binary);
+    VERIFY_MSG(is.good() && os.good(), "Cannot copy " << from << " to " << to);
+    // Streaming an empty buffer sets failbit
+    if (filesize(from))
+        os << is.rdbuf();
+    VERIFY_MSG(os.good(), "Cannot copy " << from << " to " << to);
+}
+
 //TODO do we need to screen anything but whitespaces?
 std::string screen_whitespaces(std::string const &path) {
     std::string to_search = " ";
@@ -43,6 +43,9 @@ bool check_existence(std::string const &path);
 
 void remove_if_exists(std::string const &path);
 
+//hard-links the file to the new place if possible, copies it otherwise
+void link_or_copy(std::string const &from, std::string const &to);
+
 std::string screen_whitespaces(std::string const &path);
 
 /**
@@ -123,8 +123,15 @@ class KMerDiskStorage {
     return res;
   }
 
+  fs::DependentTmpFile create_counts(size_t idx) {
+    fs::DependentTmpFile res = kmer_prefix_->CreateDep(std::to_string(idx) + ".cnt");
+    counts_.at(idx) = res;
+    return res;
+  }
+
   void resize(size_t n) {
     buckets_.resize(n);
+    counts_.resize(n);
   }
 
   unsigned k() const { return k_; }
@@ -163,8 +170,63 @@ class KMerDiskStorage {
   }
 
   size_t num_buckets() const { return buckets_.size(); }
+
+  // Multiplicities of the k-mers of the bucket (in the same order), available
+  // only if the splitter was asked to count them
+  bool has_counts() const {
+    return !counts_.empty() && std::all_of(counts_.begin(), counts_.end(),
+                                           [](const fs::DependentTmpFile &f) { return bool(f); });
+  }
+
+  MMappedRecordReader<uint32_t> bucket_counts(size_t i) const {
+    VERIFY_MSG(counts_.at(i), "k-mer multiplicities were not counted");
+    return MMappedRecordReader<uint32_t>(*counts_[i], /* unlink */ false);
+  }
   KMerSegmentPolicy segment_policy() const { return segment_policy_; }
 
+  // The buckets (and multiplicities) are stored as is into <prefix>.<i> and
+  // <prefix>.<i>.cnt files, hard-linked when possible, so they could be
+  // mmapped right away after loading.
+  void save(const std::string &prefix) const {
+    VERIFY_MSG(!all_kmers_, "Merged k-mers cannot be saved");
+    bool counts = has_counts();
+    {
+      std::ofstream os(prefix + ".info");
+      os << k_ << ' ' << buckets_.size() << ' ' << segment_policy_.num_segments() << ' ' << counts << '\n';
+      VERIFY_MSG(os.good(), "Cannot write " << prefix << ".info");
+    }
+
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+      std::string fname = prefix + "." + std::to_string(i);
+      fs::link_or_copy(*buckets_[i], fname);
+      if (counts)
+        fs::link_or_copy(*counts_[i], fname + ".cnt");
+    }
+  }
+
+  /// @throw std::ios_base::failure if the saved storage is incomplete
+  static KMerDiskStorage load(fs::TmpDir work_dir, const std::string &prefix) {
+    std::ifstream is(prefix + ".info");
+    unsigned k = 0;
+    size_t buckets = 0, segments = 0;
+    bool counts = false;
+    if (!(is >> k >> buckets >> segments >> counts))
+      throw std::ios_base::failure("Cannot read k-mer storage from " + prefix);
+
+    KMerDiskStorage res(work_dir, k, KMerSegmentPolicy(segments));
+    res.resize(buckets);
+    for (size_t i = 0; i < buckets; ++i) {
+      std::string fname = prefix + "." + std::to_string(i);
+      if (!fs::is_regular_file(fname) || (counts && !fs::is_regular_file(fname + ".cnt")))
+        throw std::ios_base::failure("Missing k-mer bucket " + fname);
+      fs::link_or_copy(fname, *res.create(i));
+      if (counts)
+        fs::link_or_copy(fname + ".cnt", *res.create_counts(i));
+    }
+
+    return res;
+  }
+
   void merge() {
     INFO("Merging final buckets.");
     TIME_TRACE_SCOPE("KMerDiskStorage::MergeFinal");
@@ -177,6 +239,7 @@ class KMerDiskStorage {
       entry.reset();
     }
     buckets_.clear();
+    counts_.clear();
     ofs.close();
   }
 
@@ -187,6 +250,7 @@ class KMerDiskStorage {
   fs::TmpFile all_kmers_;
   unsigned k_;
   Buckets buckets_;
+  Buckets counts_;
   KMerSegmentPolicy segment_policy_;
 };
 
@@ -253,7 +317,8 @@ public:
         TIME_TRACE_SCOPE("KMerDiskCounter::Count");
 #       pragma omp parallel for shared(raw_kmers) num_threads(num_threads) schedule(dynamic) reduction(+:kmers)
         for (size_t i = 0; i < raw_kmers.size(); ++i) {
-          kmers += MergeKMers(*raw_kmers[i], *res.create(i));
+          kmers += MergeKMers(*raw_kmers[i], *res.create(i),
+                              splitter_->count_multiplicities() ? res.create_counts(i)->file() : "");
           raw_kmers[i].reset();
         }
     }
@@ -278,8 +343,22 @@ private:
   std::unique_ptr<kmers::KMerSplitter<Seq>> splitter_;
   fs::TmpDir work_dir_;
 
-  size_t MergeKMers(const std::string &ifname, const std::string &ofname) {
+  static void WriteCounts(const std::string &cfname, const std::vector<uint32_t> &counts) {
+    FILE *g = fopen(cfname.c_str(), "ab");
+    if (!g)
+      FATAL_ERROR("Cannot open temporary file " << cfname << " for writing");
+    size_t res = fwrite(counts.data(), sizeof(counts[0]), counts.size(), g);
+    if (res != counts.size())
+      FATAL_ERROR("I/O error! Incomplete write! Reason: " << strerror(errno) << ". Error code: " << errno);
+    fclose(g);
+  }
+
+  // Merges the raw k-mers into the sorted set of unique ones. If cfname is
+  // not empty, the multiplicities of the unique k-mers are written there.
+  size_t MergeKMers(const std::string &ifname, const std::string &ofname,
+                    const std::string &cfname) {
     MMappedRecordArrayReader<typename Seq::DataType> ins(ifname, Seq::GetDataSize(this->k()), /* unlink */ true);
+    bool count = !cfname.empty();
 
     std::string IdxFileName = ifname + ".idx";
     if (FILE *f = fopen(IdxFileName.c_str(), "rb")) {
@@ -298,43 +377,62 @@ private:
         beg = end;
       }
 
+      // Multiplicities of the raw k-mers, if any
+      MMappedRecordReader<uint32_t> raw_counts;
+      if (count)
+        raw_counts = MMappedRecordReader<uint32_t>(ifname + ".cnt", /* unlink */ true, -1ULL);
+
       // Construct tree on top entries of runs
       adt::loser_tree<decltype(beg),
               adt::array_less<typename Seq::DataType>> tree(ranges);
 
       if (tree.empty()) {
-        FILE *g = fopen(ofname.c_str(), "ab");
-        if (!g)
-          FATAL_ERROR("Cannot open temporary file " << ofname << " for writing");
-        fclose(g);
+        for (const std::string &fname : { ofname, cfname }) {
+          if (fname.empty())
+            continue;
+          FILE *g = fopen(fname.c_str(), "ab");
+          if (!g)
+            FATAL_ERROR("Cannot open temporary file " << fname << " for writing");
+          fclose(g);
+        }
         return 0;
       }
 
       // Write it down!
       adt::KMerVector<Seq> buf(this->k(), 1024*1024);
+      std::vector<uint32_t> counts;
+      auto top_count = [&]() { return raw_counts[tree.top_iterator() - ins.begin()]; };
+      auto skip_equal = [&]() {
+        while (!tree.empty() &&
+               adt::array_equal_to<typename Seq::DataType>()(buf.back(), tree.top())) {
+          if (count)
+            counts.back() += top_count();
+          tree.replay();
+        }
+      };
+
       size_t total = 0;
       while (!tree.empty()) {
           buf.clear();
-          buf.push_back(tree.pop());
-          size_t cnt = 1;
+          counts.clear();
+          size_t cnt = 0;
 
           while (cnt < buf.capacity()) {
-            while (!tree.empty() &&
-                   adt::array_equal_to<typename Seq::DataType>()(buf.back(), tree.top()))
-              tree.replay();
+            if (cnt)
+              skip_equal();
 
             if (tree.empty())
               break;
 
             buf.push_back(tree.top());
+            if (count)
+              counts.push_back(top_count());
             tree.replay();
             cnt += 1;
           }
 
           // Handle the last value
-          while (!tree.empty() &&
-                 adt::array_equal_to<typename Seq::DataType>()(buf.back(), tree.top()))
-            tree.replay();
+          skip_equal();
 
           total += buf.size();
 
@@ -345,6 +443,9 @@ private:
           if (res != buf.size())
             FATAL_ERROR("I/O error! Incomplete write! Reason: " << strerror(errno) << ". Error code: " << errno);
           fclose(g);
+
+          if (count)
+            WriteCounts(cfname, counts);
       }
 
       return total;
@@ -352,6 +453,18 @@ private:
       // Sort the stuff
       libcxx::sort(ins.begin(), ins.end(), adt::array_less<typename Seq::DataType>());
 
+      // Raw k-mers without runs index were not counted by the splitter, so
+      // each of them is a single occurrence
+      std::vector<uint32_t> counts;
+      if (count) {
+        auto eq = adt::array_equal_to<typename Seq::DataType>();
+        for (auto it = ins.begin(), end = ins.end(); it != end; ++it) {
+          if (it == ins.begin() || !eq(*std::prev(it), *it))
+            counts.push_back(0);
+          counts.back() += 1;
+        }
+      }
+
       // FIXME: Use something like parallel version of unique_copy but with explicit
       // resizing.
       auto it = std::unique(ins.begin(), ins.end(), adt::array_equal_to<typename Seq::DataType>());
@@ -360,6 +473,9 @@ private:
       os.resize(it - ins.begin());
       std::copy(ins.begin(), it, os.begin());
 
+      if (count)
+        WriteCounts(cfname, counts);
+
       return it - ins.begin();
     }
   }
@@ -16,6 +16,7 @@
 
 #include <libcxx/sort.hpp>
 #include <string>
+#include <vector>
 #include <cstdio>
 
 namespace kmers {
@@ -43,10 +44,17 @@ public:
     unsigned K() const { return K_; }
     KMerBuckets bucket_policy() const { return bucket_; }
 
+    // When set, the splitter also records how many times each k-mer was seen
+    // (in <raw file>.cnt, one uint32_t per stored k-mer). Only the sorting
+    // splitters support this.
+    void set_count_multiplicities(bool count) { count_multiplicities_ = count; }
+    bool count_multiplicities() const { return count_multiplicities_; }
+
 protected:
     fs::TmpDir work_dir_;
     unsigned K_;
     KMerBuckets bucket_;
+    bool count_multiplicities_ = false;
 
     DECL_LOGGER("K-mer Splitting");
 };
@@ -108,6 +116,28 @@ protected:
         return out;
     }
 
+    // Same as std::unique, but also records the length of every run of equal k-mers
+    static typename SeqKMerVector::iterator UniqueCount(SeqKMerVector &kmers, std::vector<uint32_t> &counts) {
+        typename adt::KMerVector<Seq>::equal_to eq;
+        counts.clear();
+
+        auto out = kmers.begin();
+        for (auto in = kmers.begin(), end = kmers.end(); in != end; ) {
+            auto next = in + 1;
+            uint32_t cnt = 1;
+            for (; next != end && eq(*next, *in); ++next)
+                cnt += 1;
+
+            if (out != in)
+                *out = *in;
+            ++out;
+            counts.push_back(cnt);
+            in = next;
+        }
+
+        return out;
+    }
+
     bool push_back_internal(const Seq &seq, unsigned thread_id) {
         VERIFY(thread_id < kmer_buffers_.size());
         KMerBuffer &entry = kmer_buffers_[thread_id];
@@ -135,7 +165,10 @@ protected:
                     SortBuffer.push_back(buffer[j]);
             }
             libcxx::sort(SortBuffer.begin(), SortBuffer.end(), typename adt::KMerVector<Seq>::less2_fast());
-            auto it = std::unique(SortBuffer.begin(), SortBuffer.end(), typename adt::KMerVector<Seq>::equal_to());
+            std::vector<uint32_t> counts;
+            auto it = (this->count_multiplicities_ ?
+                       UniqueCount(SortBuffer, counts) :
+                       std::unique(SortBuffer.begin(), SortBuffer.end(), typename adt::KMerVector<Seq>::equal_to()));
 
 #     pragma omp critical
             {
@@ -150,6 +183,17 @@ protected:
                     FATAL_ERROR("I/O error! Incomplete write! Reason: " << strerror(errno) << ". Error code: " << errno);
                 fclose(f);
 
+                // Write multiplicities
+                if (this->count_multiplicities_) {
+                    f = fopen((ostreams[k]->file() + ".cnt").c_str(), "ab");
+                    if (!f)
+                        FATAL_ERROR("Cannot open temporary file " << ostreams[k]->file() << " for writing");
+                    res = fwrite(counts.data(), sizeof(counts[0]), cnt, f);
+                    if (res != cnt)
+                        FATAL_ERROR("I/O error! Incomplete write! Reason: " << strerror(errno) << ". Error code: " << errno);
+                    fclose(f);
+                }
+
                 // Write index
                 f = fopen((ostreams[k]->file() + ".idx").c_str(), "ab");
                 if (!f)
@@ -37,6 +37,28 @@ struct CoverageHashMapBuilder : public utils::PerfectHashMapBuilder {
         }
     }
 
+    // The k-mers are unique across the buckets, so no synchronization is
+    // necessary here. Segmented indices also map every bucket to a contiguous
+    // range of values, so the writes are mostly sequential.
+    template<class Index, class KMerStorage>
+    void FillCoverageFromCounts(Index &index, const KMerStorage &storage,
+                                unsigned nthreads) const {
+        typedef typename Index::KeyType Kmer;
+        unsigned k = index.k();
+
+#       pragma omp parallel for num_threads(nthreads) schedule(dynamic)
+        for (size_t i = 0; i < storage.num_buckets(); ++i) {
+            auto counts = storage.bucket_counts(i);
+            VERIFY(counts.size() == storage.bucket_size(i));
+
+            size_t j = 0;
+            for (auto kmer : storage.bucket(i)) {
+                typename Index::KeyWithHash kwh = index.ConstructKWH(Kmer(k, kmer.first));
+                index.get_raw_value_reference(kwh) = counts[j++];
+            }
+        }
+    }
+
     template<class Index, class KMerStorage, class Streams>
     void BuildIndex(Index &index,
                     const KMerStorage& storage,
@@ -44,6 +66,12 @@ struct CoverageHashMapBuilder : public utils::PerfectHashMapBuilder {
         unsigned nthreads = (unsigned)streams.size();
 
         utils::PerfectHashMapBuilder::BuildIndex(index, storage, nthreads);
+        if (storage.has_counts()) {
+            INFO("Collecting k-mer coverage information from k-mer multiplicities");
+            FillCoverageFromCounts(index, storage, nthreads);
+            return;
+        }
+
         INFO("Collecting k-mer coverage information from reads, this takes a while.");
 
         streams.reset();
@@ -192,6 +192,22 @@ public:
         return io::make_raw_kmer_iterator<KMer>(*this->kmers_, base::k(), parts);
     }
 
+    // The k-mers are not written into the stream, but kept in a separate
+    // (hard-linked if possible) file
+    template<class Writer>
+    void BinWrite(Writer &writer, const std::string &kmers_file) const {
+        VERIFY(kmers_ && "Index should be built");
+        base::BinWriteRaw(writer);
+        fs::link_or_copy(*kmers_, kmers_file);
+    }
+
+    template<class Reader>
+    void BinRead(Reader &reader, const std::string &kmers_file, fs::TmpDir workdir) {
+        base::BinReadRaw(reader);
+        kmers_ = workdir->tmp_file("kmers");
+        fs::link_or_copy(kmers_file, *kmers_);
+    }
+
     friend struct KeyIteratingIndexBuilder;
 };
 
@@ -147,6 +147,27 @@ public:
         KeyBase::BinRead(reader);
     }
 
+    // Same as above, but the values are dumped as a single block, which is
+    // much faster for huge maps of trivially copyable values
+    template<class Writer>
+    void BinWriteRaw(Writer &writer) const {
+        static_assert(std::is_trivially_copyable<V>::value, "Values must be trivially copyable");
+        size_t sz = data_.size();
+        writer.write((const char*)&sz, sizeof(sz));
+        writer.write((const char*)data_.data(), sz * sizeof(V));
+        KeyBase::BinWrite(writer);
+    }
+
+    template<class Reader>
+    void BinReadRaw(Reader &reader) {
+        static_assert(std::is_trivially_copyable<V>::value, "Values must be trivially copyable");
+        size_t sz = 0;
+        reader.read((char*)&sz, sizeof(sz));
+        data_.resize(sz);
+        reader.read((char*)data_.data(), sz * sizeof(V));
+        KeyBase::BinRead(reader);
+    }
+
     size_t size() const {
         return data_.size();
     }
@@ -0,0 +1,181 @@
+//***************************************************************************
+//* Copyright (c) 2021 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#include "checkpoint.hpp"
+
+#include "hammer_tools.hpp"
+#include "kmer_data.hpp"
+
+#include "utils/filesystem/path_helper.hpp"
+#include "utils/logger/logger.hpp"
+#include "utils/verify.hpp"
+
+#define XXH_INLINE_ALL
+#include "xxh/xxhash.h"
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+namespace hammer {
+
+static const char *PhaseNames[] = { "none", "count", "cluster", "subcluster", "expand", "correct" };
+
+std::ostream &operator<<(std::ostream &os, Phase phase) {
+  return os << PhaseNames[static_cast<unsigned>(phase)];
+}
+
+static uint64_t FileChecksum(const std::string &fname) {
+  std::ifstream is(fname, std::ios::binary);
+  VERIFY_MSG(is.good(), "Cannot open checkpoint file " << fname);
+
+  std::unique_ptr<XXH64_state_t, XXH_errorcode(*)(XXH64_state_t*)> state(XXH64_createState(), XXH64_freeState);
+  XXH64_reset(state.get(), 0);
+
+  std::vector<char> buf(1 << 20);
+  while (is) {
+    is.read(buf.data(), buf.size());
+    XXH64_update(state.get(), buf.data(), is.gcount());
+  }
+
+  return XXH64_digest(state.get());
+}
+
+// The working directory is kept between the runs to be continued, so it is
+// not necessarily prepared by the caller
+Checkpoint::Checkpoint(const std::string &workdir, bool enabled)
+    : workdir_(workdir), enabled_(enabled) {
+  if (enabled_)
+    fs::make_dirs(workdir_);
+}
+
+std::string Checkpoint::manifest() const {
+  return getFilename(workdir_, "checkpoint");
+}
+
+bool Checkpoint::Restore() {
+  // With checkpoints disabled the snapshots of the previous run could be
+  // stale (they are not updated by this run), so they are never trusted
+  if (!enabled_) {
+    WARN("Checkpoints are disabled (general_checkpoints), cannot continue the previous run");
+    return false;
+  }
+
+  std::ifstream is(manifest());
+  if (!is.good())
+    return false;
+
+  unsigned phase = 0;
+  is >> iteration_ >> phase
+     >> kmers_ >> kmers_checksum_
+     >> clusters_ >> clusters_checksum_
+     >> dataset_ >> dataset_checksum_
+     >> changed_reads_;
+  VERIFY_MSG(!is.fail() && phase <= static_cast<unsigned>(Phase::Correct),
+             "Malformed checkpoint manifest " << manifest());
+  phase_ = static_cast<Phase>(phase);
+
+  return true;
+}
+
+void Checkpoint::Commit(int iteration, Phase phase) {
+  iteration_ = iteration;
+  phase_ = phase;
+
+  // Write the new manifest aside and atomically move it over the old one, so
+  // the manifest always refers to the complete set of snapshots
+  std::string fname = manifest(), tmp = fname + ".tmp";
+  {
+    std::ofstream os(tmp);
+    os << iteration_ << ' ' << static_cast<unsigned>(phase_) << '\n'
+       << kmers_ << ' ' << kmers_checksum_ << '\n'
+       << clusters_ << ' ' << clusters_checksum_ << '\n'
+       << dataset_ << ' ' << dataset_checksum_ << '\n'
+       << changed_reads_ << '\n';
+    VERIFY_MSG(os.good(), "Failed to write checkpoint manifest " << tmp);
+  }
+  VERIFY_MSG(std::rename(tmp.c_str(), fname.c_str()) == 0,
+             "Failed to update checkpoint manifest " << fname);
+
+  INFO("Checkpoint saved: iteration " << iteration_ << ", phase " << phase_);
+}
+
+void Checkpoint::Verify(const std::string &fname, uint64_t checksum) const {
+  VERIFY_MSG(FileChecksum(fname) == checksum,
+             "Checkpoint file " << fname << " is corrupted, cannot continue");
+}
+
+void Checkpoint::SaveKMerData(int iteration, Phase phase, KMerData &data) {
+  if (!enabled_)
+    return;
+
+  std::ostringstream suffix;
+  suffix << "checkpoint." << phase;
+  std::string fname = getFilename(workdir_, (unsigned)iteration, suffix.str());
+  {
+    std::ofstream os(fname, std::ios::binary);
+    data.binary_write(os);
+    VERIFY_MSG(os.good(), "Failed to write checkpoint file " << fname);
+  }
+
+  std::string prev = kmers_;
+  kmers_ = fs::filename(fname);
+  kmers_checksum_ = FileChecksum(fname);
+  Commit(iteration, phase);
+
+  // The previous snapshot is superseded now
+  if (prev != "-" && prev != kmers_)
+    fs::remove_if_exists(getFilename(workdir_, prev));
+}
+
+void Checkpoint::LoadKMerData(KMerData &data) const {
+  std::string fname = getFilename(workdir_, kmers_);
+  Verify(fname, kmers_checksum_);
+
+  INFO("Restoring K-mer index from " << fname);
+  std::ifstream is(fname, std::ios::binary);
+  data.binary_read(is, fname);
+}
+
+void Checkpoint::SaveClusters(int iteration, const std::string &fname) {
+  if (!enabled_)
+    return;
+
+  clusters_ = fs::filename(fname);
+  clusters_checksum_ = FileChecksum(fname);
+  Commit(iteration, Phase::Cluster);
+}
+
+void Checkpoint::VerifyClusters(const std::string &fname) const {
+  VERIFY_MSG(fs::filename(fname) == clusters_,
+             "Checkpoint refers to the clusters " << clusters_ << " instead of " << fname);
+  Verify(fname, clusters_checksum_);
+}
+
+void Checkpoint::SaveCorrected(int iteration, const io::DataSet<> &dataset, size_t changed_reads) {
+  if (!enabled_)
+    return;
+
+  std::string fname = getFilename(workdir_, (unsigned)iteration, "checkpoint.yaml");
+  io::DataSet<>(dataset).save(fname);
+
+  dataset_ = fs::filename(fname);
+  dataset_checksum_ = FileChecksum(fname);
+  changed_reads_ = changed_reads;
+  Commit(iteration, Phase::Correct);
+}
+
+void Checkpoint::LoadCorrected(io::DataSet<> &dataset) const {
+  std::string fname = getFilename(workdir_, dataset_);
+  Verify(fname, dataset_checksum_);
+
+  INFO("Restoring corrected dataset description from " << fname);
+  dataset.load(fname);
+}
+
+}  // namespace hammer
@@ -0,0 +1,86 @@
+//***************************************************************************
+//* Copyright (c) 2021 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#pragma once
+
+#include "pipeline/library.hpp"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+class KMerData;
+
+namespace hammer {
+
+// Phases of a single BayesHammer iteration, in the order they are run
+enum class Phase : unsigned {
+  None = 0,
+  Count,
+  Cluster,
+  Subcluster,
+  Expand,
+  Correct
+};
+
+std::ostream &operator<<(std::ostream &os, Phase phase);
+
+// Keeps track of the last completed phase of BayesHammer run inside the
+// working directory, so an interrupted run could be continued instead of
+// restarting from k-mer counting. The state is described by a small manifest
+// which is replaced atomically after the snapshot of the phase is written;
+// all the snapshot files are verified by their checksums on restore.
+class Checkpoint {
+ public:
+  Checkpoint(const std::string &workdir, bool enabled);
+
+  bool enabled() const { return enabled_; }
+
+  // Loads the manifest left by the previous run. Returns false if there is
+  // nothing to continue from or checkpoints are disabled.
+  bool Restore();
+
+  int iteration() const { return iteration_; }
+  Phase phase() const { return phase_; }
+  bool completed(int iteration, Phase phase) const {
+    return iteration < iteration_ || (iteration == iteration_ && phase <= phase_);
+  }
+
+  // K-mer data is snapshotted after counting, subclustering and expansion.
+  // Snapshots use the stream format of KMerData::binary_write, so they are
+  // read back in full rather than memory-mapped
+  void SaveKMerData(int iteration, Phase phase, KMerData &data);
+  void LoadKMerData(KMerData &data) const;
+
+  // Clusters are already on disk after clustering, we only record their checksum
+  void SaveClusters(int iteration, const std::string &fname);
+  void VerifyClusters(const std::string &fname) const;
+
+  void SaveCorrected(int iteration, const io::DataSet<> &dataset, size_t changed_reads);
+  void LoadCorrected(io::DataSet<> &dataset) const;
+  size_t changed_reads() const { return changed_reads_; }
+
+ private:
+  std::string manifest() const;
+  void Commit(int iteration, Phase phase);
+  void Verify(const std::string &fname, uint64_t checksum) const;
+
+  std::string workdir_;
+  bool enabled_;
+
+  int iteration_ = -1;
+  Phase phase_ = Phase::None;
+
+  std::string kmers_ = "-";
+  uint64_t kmers_checksum_ = 0;
+  std::string clusters_ = "-";
+  uint64_t clusters_checksum_ = 0;
+  std::string dataset_ = "-";
+  uint64_t dataset_checksum_ = 0;
+  size_t changed_reads_ = 0;
+};
+
+}  // namespace hammer
@@ -34,6 +34,7 @@ void load(hammer_config& cfg, boost::property_tree::ptree const& pt) {
   load(cfg.general_tau, pt, "general_tau");
   load(cfg.general_max_iterations, pt, "general_max_iterations");
   load(cfg.general_debug, pt, "general_debug");
+  load(cfg.general_checkpoints, pt, "general_checkpoints");
 
   load(cfg.count_do, pt, "count_do");
   load(cfg.count_numfiles, pt, "count_numfiles");
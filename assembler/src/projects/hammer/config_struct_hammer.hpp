@@ -42,6 +42,7 @@ struct hammer_config {
   int general_tau;
   unsigned general_max_iterations;
   bool general_debug;
+  bool general_checkpoints;
 
   bool count_do;
   unsigned count_numfiles;
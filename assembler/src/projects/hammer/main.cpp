@@ -11,6 +11,7 @@
 #include "globals.hpp"
 #include "kmer_data.hpp"
 #include "expander.hpp"
+#include "checkpoint.hpp"
 
 #include "adt/concurrent_dsu.hpp"
 #include "utils/segfault_handler.hpp"
@@ -72,6 +73,7 @@ int main(int argc, char * argv[]) {
 
     std::string config_file = CONFIG_FILENAME;
     if (argc > 1) config_file = argv[1];
+    bool continue_run = (argc > 2 && std::string(argv[2]) == "--continue");
     START_BANNER("BayesHammer");
     INFO("Loading config from " << config_file.c_str());
     cfg::create_instance(config_file);
@@ -114,8 +116,24 @@ int main(int argc, char * argv[]) {
 
     int max_iterations = cfg::get().general_max_iterations;
 
+    hammer::Checkpoint checkpoint(cfg::get().input_working_dir, cfg::get().general_checkpoints);
+    int first_iteration = 0;
+    bool finished = false;
+    if (continue_run) {
+      if (checkpoint.Restore()) {
+        INFO("Continuing from iteration " << checkpoint.iteration() << " after phase " << checkpoint.phase());
+        first_iteration = checkpoint.iteration();
+        if (checkpoint.phase() == hammer::Phase::Correct) {
+          checkpoint.LoadCorrected(cfg::get_writable().dataset);
+          first_iteration += 1;
+          finished = checkpoint.changed_reads() < 1;
+        }
+      } else
+        INFO("Nothing to continue from, starting from scratch");
+    }
+
     // now we can begin the iterations
-    for (Globals::iteration_no = 0; Globals::iteration_no < max_iterations; ++Globals::iteration_no) {
+    for (Globals::iteration_no = first_iteration; !finished && Globals::iteration_no < max_iterations; ++Globals::iteration_no) {
       std::cout << "\n     === ITERATION " << Globals::iteration_no << " begins ===" << std::endl;
       bool do_everything = cfg::get().general_do_everything_after_first_iteration && (Globals::iteration_no > 0);
 
@@ -123,8 +141,12 @@ int main(int argc, char * argv[]) {
       Globals::kmer_data = new KMerData;
 
       // count k-mers
-      if (cfg::get().count_do || do_everything) {
+      if (checkpoint.completed(Globals::iteration_no, hammer::Phase::Count)) {
+        // the latest snapshot already includes the results of all completed phases
+        checkpoint.LoadKMerData(*Globals::kmer_data);
+      } else if (cfg::get().count_do || do_everything) {
         KMerDataCounter(cfg::get().count_numfiles).BuildKMerIndex(*Globals::kmer_data);
+        checkpoint.SaveKMerData(Globals::iteration_no, hammer::Phase::Count, *Globals::kmer_data);
 
         if (cfg::get().general_debug) {
           INFO("Debug mode on. Dumping K-mer index");
@@ -142,7 +164,11 @@ int main(int argc, char * argv[]) {
 
       // Cluster the Hamming graph
       std::vector<std::vector<size_t> > classes;
-      if (cfg::get().hamming_do || do_everything) {
+      if (checkpoint.completed(Globals::iteration_no, hammer::Phase::Cluster)) {
+        if (!checkpoint.completed(Globals::iteration_no, hammer::Phase::Subcluster))
+          checkpoint.VerifyClusters(hammer::getFilename(cfg::get().input_working_dir, Globals::iteration_no, "kmers.hamming"));
+        INFO("Clustering restored from checkpoint");
+      } else if (cfg::get().hamming_do || do_everything) {
         dsu::ConcurrentDSU uf(Globals::kmer_data->size());
         std::string ham_prefix = hammer::getFilename(cfg::get().input_working_dir, Globals::iteration_no, "kmers.hamcls");
         INFO("Clustering Hamming graph.");
@@ -165,9 +191,13 @@ int main(int argc, char * argv[]) {
         }
 #endif
         INFO("Clustering done. Total clusters: " << num_classes);
+        checkpoint.SaveClusters(Globals::iteration_no,
+                                hammer::getFilename(cfg::get().input_working_dir, Globals::iteration_no, "kmers.hamming"));
       }
 
-      if (cfg::get().bayes_do || do_everything) {
+      if (checkpoint.completed(Globals::iteration_no, hammer::Phase::Subcluster)) {
+        INFO("Subclustering restored from checkpoint");
+      } else if (cfg::get().bayes_do || do_everything) {
         KMerDataCounter(cfg::get().count_numfiles).FillKMerData(*Globals::kmer_data);
 
         INFO("Subclustering Hamming graph");
@@ -176,6 +206,7 @@ int main(int argc, char * argv[]) {
                            cfg::get().input_working_dir, cfg::get().general_debug);
         kmc.process(hammer::getFilename(cfg::get().input_working_dir, Globals::iteration_no, "kmers.hamming"));
         INFO("Finished clustering.");
+        checkpoint.SaveKMerData(Globals::iteration_no, hammer::Phase::Subcluster, *Globals::kmer_data);
 
         if (cfg::get().general_debug) {
           INFO("Debug mode on. Dumping K-mer index");
@@ -192,7 +223,9 @@ int main(int argc, char * argv[]) {
       }
 
       // expand the set of solid k-mers
-      if (cfg::get().expand_do || do_everything) {
+      if (checkpoint.completed(Globals::iteration_no, hammer::Phase::Expand)) {
+        INFO("Solid k-mers restored from checkpoint");
+      } else if (cfg::get().expand_do || do_everything) {
         unsigned expand_nthreads = std::min(cfg::get().general_max_nthreads, cfg::get().expand_nthreads);
         INFO("Starting solid k-mers expansion in " << expand_nthreads << " threads.");
         for (unsigned expand_iter_no = 0; expand_iter_no < cfg::get().expand_max_iterations; ++expand_iter_no) {
@@ -220,6 +253,7 @@ int main(int argc, char * argv[]) {
             break;
         }
         INFO("Solid k-mers finalized");
+        checkpoint.SaveKMerData(Globals::iteration_no, hammer::Phase::Expand, *Globals::kmer_data);
 
         if (cfg::get().general_debug) {
           INFO("Debug mode on. Dumping K-mer index");
@@ -239,6 +273,7 @@ int main(int argc, char * argv[]) {
       // reconstruct and output the reads
       if (cfg::get().correct_do || do_everything) {
         totalReads = hammer::CorrectAllReads();
+        checkpoint.SaveCorrected(Globals::iteration_no, cfg::get().dataset, totalReads);
       }
 
       // prepare the reads for next iteration
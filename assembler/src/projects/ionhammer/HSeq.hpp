@@ -16,6 +16,7 @@
 #include <vector>
 
 #include <cstdint>
+#include <cstring>
 
 #define XXH_INLINE_ALL
 #include "xxh/xxhash.h"
@@ -45,6 +46,7 @@ union HomopolymerRun {
 
   std::string str() const { return std::string(len, ::nucl(nucl)); }
 };
+static_assert(sizeof(HomopolymerRun) == 1, "HomopolymerRun must be a single byte");
 
 namespace iontorrent {
 // Container shall have push_back method
@@ -78,6 +80,16 @@ class HSeq {
  private:
   StorageType data_;
 
+  // Runs are single bytes, so shifting the whole k-mer by one run is a
+  // single overlapping block move
+  void ShiftLeft() {
+    std::memmove(data_.data(), data_.data() + 1, (N - 1) * sizeof(HomopolymerRun));
+  }
+
+  void ShiftRight() {
+    std::memmove(data_.data() + 1, data_.data(), (N - 1) * sizeof(HomopolymerRun));
+  }
+
  public:
   HSeq() {}
 
@@ -143,7 +155,7 @@ class HSeq {
     }
 
     // Hard case - have to shift the stuff
-    for (size_t i = 0; i < N - 1; ++i) res[i] = res[i + 1];
+    res.ShiftLeft();
     res[N - 1].nucl = nucl;
     res[N - 1].len = 1;
 
@@ -160,7 +172,7 @@ class HSeq {
     }
 
     // Hard case - have to shift the stuff
-    for (size_t i = 0; i < N - 1; ++i) res[i] = res[i + 1];
+    res.ShiftLeft();
     res[N - 1] = run;
 
     return res;
@@ -177,7 +189,7 @@ class HSeq {
     }
 
     // Hard case - have to shift the stuff
-    for (size_t i = 0; i < N - 1; ++i) data_[i] = data_[i + 1];
+    ShiftLeft();
     data_[N - 1].nucl = nucl & 3;
     data_[N - 1].len = 1;
 
@@ -193,7 +205,7 @@ class HSeq {
     }
 
     // Hard case - have to shift the stuff
-    for (size_t i = 0; i < N - 1; ++i) data_[i] = data_[i + 1];
+    ShiftLeft();
     data_[N - 1] = run;
     return *this;
   }
@@ -208,7 +220,7 @@ class HSeq {
     }
 
     // Hard case - have to shift the stuff
-    for (size_t i = 0; i < N - 1; ++i) res[i + 1] = res[i];
+    res.ShiftRight();
     res[0].nucl = run.nucl;
     res[0].len = run.len;
 
@@ -227,7 +239,7 @@ class HSeq {
     }
 
     // Hard case - have to shift the stuff
-    for (size_t i = 0; i < N - 1; ++i) res[i + 1] = res[i];
+    res.ShiftRight();
     res[0].nucl = nucl;
     res[0].len = 1;
 
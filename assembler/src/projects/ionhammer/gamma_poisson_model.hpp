@@ -76,7 +76,10 @@ class GammaMixture {
 
 class PoissonGammaDistribution {
  private:
-  const GammaDistribution& prior_;
+  GammaDistribution prior_;
+  // count-independent terms of the log-likelihood, computed once
+  double log_norm_;
+  double log_rate_plus_one_;
   static std::array<double, 100000> log_gamma_integer_cache_;
 
  private:
@@ -89,29 +92,21 @@ class PoissonGammaDistribution {
   }
 
  public:
-  PoissonGammaDistribution(const GammaDistribution& prior) : prior_(prior) {}
+  PoissonGammaDistribution(const GammaDistribution& prior)
+      : prior_(prior),
+        log_norm_(prior.GetShape() * log(prior.GetRate()) - prior.LogGammaAtShape()),
+        log_rate_plus_one_(log(prior.GetRate() + 1)) {}
 
   inline double PartialLogLikelihood(size_t count) const {
     const double a = prior_.GetShape();
-    const double b = prior_.GetRate();
 
-    double ll = 0.0;
-    ll += a * log(b) - (a + (double)count) * log(b + 1);
-    ll +=
-        boost::math::lgamma(prior_.GetShape() + (double)count) - prior_.LogGammaAtShape();
+    double ll = log_norm_ - (a + (double)count) * log_rate_plus_one_;
+    ll += boost::math::lgamma(a + (double)count);
     return ll;
   }
 
   inline double LogLikelihood(size_t count) const {
-    const double a = prior_.GetShape();
-    const double b = prior_.GetRate();
-
-    double ll = 0.0;
-    ll += a * log(b) - (a + (double)count) * log(b + 1);
-    ll += boost::math::lgamma(prior_.GetShape() + ((double)count)) - IntLogGamma(count) -
-          prior_.LogGammaAtShape();
-
-    return ll;
+    return PartialLogLikelihood(count) - IntLogGamma(count);
   }
 
   inline double Quantile(double p) const {
@@ -15,7 +15,9 @@
 
 #include "utils/kmer_mph/kmer_splitter.hpp"
 #include "utils/kmer_mph/kmer_index_builder.hpp"
+#include "utils/memory_limit.hpp"
 
+#include <algorithm>
 #include <mutex>
 #include <random>
 
@@ -95,34 +97,72 @@ HammerKMerSplitter::RawKMers HammerKMerSplitter::Split(size_t num_files, unsigne
   return out;
 }
 
-static inline void Merge(KMerStat &lhs, const KMerStat &rhs) {
-  if (lhs.count == 0) lhs.kmer = rhs.kmer;
+// Single k-mer occurrence to be accumulated into KMerData
+struct KMerOccurrence {
+  size_t idx;
+  float qual;
+};
 
-  lhs.count += rhs.count;
-  lhs.qual += rhs.qual;
-}
+// Thread-local buffers of k-mer occurrences sharded by the k-mer index
+// range. Each thread only appends to its own buffers while reads are
+// processed, then every shard is reduced by a single thread, so no
+// per-k-mer locking is required.
+class KMerOccurrenceBuffers {
+  KMerData &data_;
+  size_t shard_size_;
+  size_t buffer_limit_;
+  std::vector<std::vector<std::vector<KMerOccurrence>>> buffers_;
+  std::vector<size_t> buffered_;
 
-static void PushKMer(KMerData &data, HKMer kmer, double qual) {
-  KMerStat &kmc = data[kmer];
-  kmc.lock();
-  Merge(kmc, KMerStat(1, kmer, (float)qual));
-  kmc.unlock();
-}
+ public:
+  KMerOccurrenceBuffers(KMerData &data, unsigned nthreads, size_t buffer_size)
+      : data_(data), buffers_(nthreads), buffered_(nthreads, 0) {
+    size_t num_shards = 4 * nthreads;
+    shard_size_ = (data.size() + num_shards - 1) / num_shards;
+    if (shard_size_ == 0) shard_size_ = 1;
+    buffer_limit_ = std::max(buffer_size / sizeof(KMerOccurrence), size_t(16384));
+
+    for (auto &thread_buffers : buffers_)
+      thread_buffers.resize(num_shards);
+  }
 
-static void PushKMerRC(KMerData &data, HKMer kmer, double qual) {
-  PushKMer(data, !kmer, qual);
-}
+  // Returns true if the buffers of the thread are full and should be reduced
+  bool push_back(size_t idx, double qual, unsigned thread_id) {
+    buffers_[thread_id][idx / shard_size_].push_back({idx, (float)qual});
+    return ++buffered_[thread_id] > buffer_limit_;
+  }
+
+  void Reduce() {
+    size_t num_shards = buffers_.front().size();
+#   pragma omp parallel for schedule(dynamic) num_threads(buffers_.size())
+    for (size_t shard = 0; shard < num_shards; ++shard) {
+      for (auto &thread_buffers : buffers_) {
+        auto &buffer = thread_buffers[shard];
+        for (const auto &occ : buffer) {
+          KMerStat &kmc = data_[occ.idx];
+          kmc.count += 1;
+          kmc.qual += occ.qual;
+        }
+        buffer.clear();
+      }
+    }
+
+    std::fill(buffered_.begin(), buffered_.end(), 0);
+  }
+};
 
 class KMerDataFiller {
-  KMerData &Data;
+  const KMerData &Data;
+  KMerOccurrenceBuffers &Buffers;
   mutable std::default_random_engine RandomEngine;
   mutable std::uniform_real_distribution<double> UniformRandGenerator;
   mutable std::mutex Lock;
   double SampleRate;
 
  public:
-  KMerDataFiller(KMerData &data, double sampleRate = 1.0)
+  KMerDataFiller(const KMerData &data, KMerOccurrenceBuffers &buffers, double sampleRate = 1.0)
       : Data(data),
+        Buffers(buffers),
         RandomEngine(42),
         UniformRandGenerator(0, 1),
         SampleRate(sampleRate) {}
@@ -134,6 +174,7 @@ class KMerDataFiller {
 
   bool operator()(std::unique_ptr<io::SingleRead> &&r) const {
     ValidHKMerGenerator<hammer::K> gen(*r);
+    unsigned thread_id = omp_get_thread_num();
 
     // tiny quality regularization
     const double decay = 0.9999;
@@ -145,6 +186,7 @@ class KMerDataFiller {
       return false;
     }
 
+    bool stop = false;
     while (gen.HasMore()) {
       const HKMer kmer = gen.kmer();
       const double p = gen.correct_probability();
@@ -156,32 +198,55 @@ class KMerDataFiller {
 
       prior *= decay;
       {
-        PushKMer(Data, kmer, log(1 - correct));
-
-        PushKMerRC(Data, kmer, log(1 - correct));
+        stop |= Buffers.push_back(Data.seq_idx(kmer), log(1 - correct), thread_id);
+        stop |= Buffers.push_back(Data.seq_idx(!kmer), log(1 - correct), thread_id);
       }
     }
-    // Do not stop
-    return false;
+
+    return stop;
   }
 };
 
 void KMerDataCounter::FillKMerData(KMerData &data) {
+  unsigned nthreads = cfg::get().max_nthreads;
   kmers::KMerDiskCounter<hammer::HKMer> counter(cfg::get().working_dir, HammerKMerSplitter(cfg::get().working_dir));
 
-  auto res = kmers::KMerIndexBuilder<HammerKMerIndex>(num_files_, cfg::get().max_nthreads).BuildIndex(data.index_, counter, false);
+  auto res = kmers::KMerIndexBuilder<HammerKMerIndex>(num_files_, nthreads).BuildIndex(data.index_, counter, false);
 
   // Now use the index to fill the kmer quality information.
   INFO("Collecting K-mer information, this takes a while.");
   data.data_.resize(res.total_kmers());
 
+  // Fill the k-mers themselves from the unique k-mer buckets, so the read
+  // pass only needs to accumulate counts and qualities.
+#   pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for (size_t i = 0; i < res.num_buckets(); ++i) {
+    for (auto kmer_data : res.bucket(i)) {
+      HKMer kmer(kmer_data.first, kmer_data.first + HKMer::DataSize);
+      data.data_[data.seq_idx(kmer)].kmer = kmer;
+    }
+  }
+
+  size_t buffer_size = cfg::get().count_split_buffer;
+  if (buffer_size == 0) {
+    buffer_size = 536870912ull;
+    size_t mem_limit = (size_t)((double)(utils::get_free_memory()) / (nthreads * 3));
+    buffer_size = std::min(buffer_size, mem_limit);
+  }
+  KMerOccurrenceBuffers buffers(data, nthreads, buffer_size);
+
   const auto &dataset = cfg::get().dataset;
   for (auto it = dataset.reads_begin(), et = dataset.reads_end(); it != et;
        ++it) {
     INFO("Processing " << *it);
     io::FileReadStream irs(*it, io::PhredOffset);
-    KMerDataFiller filler(data, cfg::get().sample_rate);
-    hammer::ReadProcessor(cfg::get().max_nthreads).Run(irs, filler);
+    KMerDataFiller filler(data, buffers, cfg::get().sample_rate);
+    hammer::ReadProcessor rp(nthreads);
+    while (!irs.eof()) {
+      rp.Run(irs, filler);
+      buffers.Reduce();
+      VERIFY_MSG(rp.read() == rp.processed(), "Queue unbalanced");
+    }
   }
 
   INFO("Collection done, postprocessing.");
@@ -27,18 +27,9 @@ struct KMerStat {
   float qual;
   float posterior_genomic_ll = -10000;
   bool dist_one_subcluster = false;
-  uint8_t lock_;
 
   KMerStat(int count = 0, HKMer kmer = HKMer(), float qual = 0.0)
-      : count(count), kmer(kmer), qual(qual), lock_(0) {}
-
-  void lock() {
-    while (__sync_val_compare_and_swap(&lock_, 0, 1) == 1) sched_yield();
-  }
-  void unlock() {
-    lock_ = 0;
-    __sync_synchronize();
-  }
+      : count(count), kmer(kmer), qual(qual) {}
 
   bool good() const {
     return posterior_genomic_ll > goodThreshold();  // log(0.5)
@@ -405,7 +405,7 @@ int main(int argc, char** argv) {
 
         SingleReadsCorrector read_corrector(kmerData, calcerFactory, &header,
                                             debug_pred, select_pred);
-        io::UnmappedBamStream irs(*I);
+        io::ParallelUnmappedBamStream irs(*I, cfg::get().max_nthreads);
         hammer::ReadProcessor(cfg::get().max_nthreads)
             .Run(irs, read_corrector, ors);
 
@@ -34,6 +34,7 @@ class NormalDistribution {
  private:
   double mean_;
   double sigma_sqr_;
+  double log_norm_;
 
  public:
   NormalDistribution(const NormalDistribution&) = default;
@@ -41,7 +42,7 @@ class NormalDistribution {
   NormalDistribution& operator=(const NormalDistribution&) = default;
 
   NormalDistribution(const double mean = 0, const double sigma = 1)
-      : mean_(mean), sigma_sqr_(sigma) {}
+      : mean_(mean), sigma_sqr_(sigma), log_norm_(log(2 * M_PI * sigma)) {}
 
   inline double GetMean() const { return mean_; }
 
@@ -49,14 +50,14 @@ class NormalDistribution {
 
   double LogLikelihood(double x) const {
     return -0.5 *
-           ((x - mean_) * (x - mean_) / sigma_sqr_ + log(2 * M_PI * sigma_sqr_));
+           ((x - mean_) * (x - mean_) / sigma_sqr_ + log_norm_);
   }
 
   double LogLikelihoodFromStats(const double sum,
                                 const double sum2,
                                 const double weight) const {
     return -0.5 * ((sum2 - 2 * sum * mean_ + weight * mean_ * mean_) / sigma_sqr_ +
-                   weight * log(2 * M_PI * sigma_sqr_));
+                   weight * log_norm_);
   }
 
   static NormalDistribution FromStats(const double sum,
@@ -62,6 +62,17 @@ class GammaPoissonLikelihoodCalcer {
   double correction_penalty_;
   double bad_kmer_penalty_;
   const KMerData& data_;
+  // Log-likelihoods of the clamped noise counts, filled on first use
+  size_t noise_count_ll_offset_;
+  mutable std::vector<double> noise_count_ll_;
+
+  inline double NoiseCountLogLikelihood(size_t cnt) const {
+    double& ll = noise_count_ll_[cnt - noise_count_ll_offset_];
+    if (std::isnan(ll)) {
+      ll = count_distribution_.LogLikelihood(cnt);
+    }
+    return ll;
+  }
 
  public:
   class PenaltyState {
@@ -137,6 +148,9 @@ class GammaPoissonLikelihoodCalcer {
 
     correction_penalty_ = cfg::get().correction_penalty;
     bad_kmer_penalty_ = cfg::get().bad_kmer_penalty;
+    noise_count_ll_offset_ = std::min(noise_quantiles_lower_, noise_quantile_upper_);
+    noise_count_ll_.assign(std::max(noise_quantiles_lower_, noise_quantile_upper_) - noise_count_ll_offset_ + 1,
+                           std::numeric_limits<double>::quiet_NaN());
     assert(lower_quantile_ < upper_quantile_);
   }
 
@@ -182,7 +196,7 @@ class GammaPoissonLikelihoodCalcer {
 
       // state.Likelihood += dist * log(Model.ErrorRate(event.FixedSize));
       state.likelihood_ += (double)state.hkmer_distance_to_read_ * correction_penalty_;
-      state.likelihood_ += count_distribution_.LogLikelihood(cnt);
+      state.likelihood_ += NoiseCountLogLikelihood(cnt);
     }
 
     if (!is_good) {
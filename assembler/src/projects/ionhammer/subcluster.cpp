@@ -247,11 +247,13 @@ void TGenomicHKMersEstimator::ProceedCluster(std::vector<size_t>& cluster) {
 
   for (size_t i = 0; i < posteriorQualities.size(); ++i) {
     const auto idx = centerCandidates[i];
-    data_[idx].lock();
-    const bool wasGood = data_[idx].good();
-    data_[idx].posterior_genomic_ll = (float)std::max(posteriorQualities[i], (double)data_[idx].posterior_genomic_ll);
-    data_[idx].dist_one_subcluster |= distOneGoodCenters[i];
-    data_[idx].unlock();
+    bool wasGood;
+    {
+      std::lock_guard<std::mutex> guard(locks_[idx % locks_.size()]);
+      wasGood = data_[idx].good();
+      data_[idx].posterior_genomic_ll = (float)std::max(posteriorQualities[i], (double)data_[idx].posterior_genomic_ll);
+      data_[idx].dist_one_subcluster |= distOneGoodCenters[i];
+    }
     if (!wasGood && data_[idx].good()) {
 #pragma omp atomic
       GoodKmers++;
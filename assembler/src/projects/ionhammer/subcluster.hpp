@@ -14,6 +14,8 @@
 #include "reference.h"
 
 #include <common/adt/concurrent_dsu.hpp>
+#include <array>
+#include <mutex>
 #include <vector>
 #include "gamma_poisson_model.hpp"
 #include "normal_quality_model.hpp"
@@ -32,6 +34,8 @@ class TGenomicHKMersEstimator {
   size_t GoodKmers = 0;
   size_t SkipKmers = 0;
   size_t ReasignedByConsenus = 0;
+  // Striped locks guarding the posterior updates of the center candidates
+  std::array<std::mutex, 1024> locks_;
 
  public:
   TGenomicHKMersEstimator(KMerData& data, const n_normal_model::NormalClusterModel& clusterModel,
@@ -8,7 +8,7 @@
 #ifndef HAMMER_VALIDHKMERGENERATOR_HPP_
 #define HAMMER_VALIDHKMERGENERATOR_HPP_
 
-#include <deque>
+#include <array>
 #include <string>
 #include <vector>
 
@@ -72,8 +72,7 @@ class ValidHKMerGenerator {
     has_more_ = true;
     first_ = true;
     last_ = false;
-    probs_.resize(0);
-    runlens_.resize(0);
+    runs_begin_ = runs_size_ = 0;
     length = 0;
 
     TrimBadQuality();
@@ -152,8 +151,11 @@ class ValidHKMerGenerator {
   bool has_more_;
   bool first_;
   bool last_;
-  std::deque<double> probs_;
-  std::deque<double> runlens_;
+  // Ring buffers with the stats of the last kK homopolymer runs
+  std::array<double, kK> probs_;
+  std::array<double, kK> runlens_;
+  size_t runs_begin_ = 0;
+  size_t runs_size_ = 0;
 
   // Disallow copy and assign
   ValidHKMerGenerator(const ValidHKMerGenerator &) = delete;
@@ -210,8 +212,7 @@ void ValidHKMerGenerator<kK>::Next() {
       len = 0;
       length = 0;
       correct_probability_ = 0.0;
-      probs_.resize(0);
-      runlens_.resize(0);
+      runs_begin_ = runs_size_ = 0;
       continue;
     }
     if (qual_) {
@@ -229,15 +230,17 @@ void ValidHKMerGenerator<kK>::Next() {
         correct_probability_ += cprob;
         length += (size_t)len;
 
-        if (probs_.size() == kK) {
-          correct_probability_ -= probs_[0];
-          length -= (size_t)runlens_[0];
-          probs_.pop_front();
-          runlens_.pop_front();
+        if (runs_size_ == kK) {
+          correct_probability_ -= probs_[runs_begin_];
+          length -= (size_t)runlens_[runs_begin_];
+          runs_begin_ = (runs_begin_ + 1) % kK;
+          runs_size_ -= 1;
         }
 
-        probs_.push_back(cprob);
-        runlens_.push_back(len);
+        size_t runs_end = (runs_begin_ + runs_size_) % kK;
+        probs_[runs_end] = cprob;
+        runlens_[runs_end] = len;
+        runs_size_ += 1;
         cprob = 0.0;
         len = 0;
       }
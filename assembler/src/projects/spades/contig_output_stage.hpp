@@ -29,7 +29,7 @@ public:
             : AssemblyStage("Contig Output", "contig_output"),
               outputs_(std::move(list)) {}
 
-    void save(const debruijn_graph::GraphPack &, const std::string &, const char *) const override { }
+    bool save(const debruijn_graph::GraphPack &, const std::string &, const char *) const override { return false; }
     void run(GraphPack &gp, const char *) override;
 
 private:
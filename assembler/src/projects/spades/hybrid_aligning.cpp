@@ -278,6 +278,7 @@ public:
             n += read_buffer.size();
             INFO("Processed " << n << " reads");
         }
+        galigner_.CollectStats(stats_);
     }
 
     const sensitive_aligner::StatsCounter& stats() const {
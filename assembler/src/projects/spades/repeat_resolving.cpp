@@ -13,7 +13,7 @@
 
 namespace debruijn_graph {
 
-static void PEResolving(GraphPack& gp) {
+static void PEResolving(GraphPack& gp, bool release_paired_indices) {
     path_extend::PathExtendParamsContainer params(cfg::get().ds,
                                                   cfg::get().pe_params,
                                                   cfg::get().ss,
@@ -22,6 +22,7 @@ static void PEResolving(GraphPack& gp) {
                                                   cfg::get().uneven_depth,
                                                   cfg::get().avoid_rc_connections,
                                                   cfg::get().use_scaffolder);
+    params.release_paired_indices = release_paired_indices;
     cfg::get_writable().pe_params.param_set.overlap_removal.enabled = false;
     path_extend::PathExtendLauncher exspander(cfg::get().ds, params, gp);
     exspander.Launch();
@@ -51,12 +52,12 @@ void RepeatResolution::load(GraphPack &gp, const std::string &load_from, const c
 }
 
 
-void RepeatResolution::save(const GraphPack &gp, const std::string &save_to, const char *prefix) const {
+bool RepeatResolution::save(const GraphPack &gp, const std::string &save_to, const char *prefix) const {
     // Do nothing in final mode, otherwise - produce saves
     if (!preliminary_)
-        return;
+        return false;
 
-    AssemblyStage::save(gp, save_to, prefix);
+    return AssemblyStage::save(gp, save_to, prefix);
 }
 
 void RepeatResolution::run(GraphPack &gp, const char*) {
@@ -85,7 +86,9 @@ void RepeatResolution::run(GraphPack &gp, const char*) {
     }
     if (cfg::get().rm == config::resolving_mode::path_extend) {
         INFO("Using Path-Extend repeat resolving");
-        PEResolving(gp);
+        // Preliminary indices are saved afterwards, metaplasmid pipeline resolves repeats
+        // several times, otherwise the paired indices are not used after repeat resolution
+        PEResolving(gp, !preliminary_ && cfg::get().mode != config::pipeline_type::metaextrachromosomal);
     } else {
         INFO("Unsupported repeat resolver");
     }
@@ -20,7 +20,7 @@ public:
               preliminary_(preliminary) { }
 
     void load(GraphPack &, const std::string &, const char *) override;
-    void save(const GraphPack &, const std::string &, const char *) const override;
+    bool save(const GraphPack &, const std::string &, const char *) const override;
     void run(GraphPack &gp, const char *) override;
 };
 
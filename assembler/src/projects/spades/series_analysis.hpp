@@ -11,7 +11,7 @@ public:
 
     void load(GraphPack &, const std::string &, const char *) override { }
 
-    void save(const GraphPack &, const std::string &, const char *) const override { }
+    bool save(const GraphPack &, const std::string &, const char *) const override { return false; }
 
     void run(GraphPack &gp, const char *) override;
 };
@@ -127,6 +127,9 @@ class LongReadsAligner {
             n += read_buffer.size();
             INFO("Processed " << n << " reads");
         }
+        StatsCounter stats;
+        galigner_.CollectStats(stats);
+        stats.ReportGapFillCache();
     }
 
   private:
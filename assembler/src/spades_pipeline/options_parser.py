@@ -558,9 +558,9 @@ def add_pipeline_args(pgroup_pipeline):
                                help=argparse.SUPPRESS,
                                action="store_false")
     pgroup_pipeline.add_argument("--checkpoints",
-                                 metavar="<last or all>",
+                                 metavar="<last, all or incremental>",
                                  dest="checkpoints",
-                                 help="save intermediate check-points ('last', 'all')",
+                                 help="save intermediate check-points ('last', 'all', 'incremental')",
                                  action="store")
     pgroup_pipeline.add_argument("--continue",
                                  dest="continue_mode",
@@ -80,6 +80,8 @@ K_MERS_PLASMID_LONG = [21, 33, 55, 77, 99, 127]
 
 ITERATIONS = 1
 TMP_DIR = "tmp"
+# written by the tools continuing their runs from their working dirs (BayesHammer)
+CHECKPOINT_MANIFEST = "checkpoint"
 
 READS_TYPES_USED_IN_CONSTRUCTION = ["paired-end", "single", "hq-mate-pairs"]
 READS_TYPES_USED_IN_RNA_SEQ = ["paired-end", "single", "trusted-contigs", "untrusted-contigs", "pacbio", "nanopore", "fl-rna"]
@@ -16,6 +16,7 @@ elif sys.version.startswith("3."):
     import pyyaml3 as pyyaml
 
 import commands_parser
+import options_storage
 from stages import stage
 
 #delete tmp files in ouput folder
@@ -31,7 +32,12 @@ class BeforeStartStage(stage.Stage):
         if (os.path.isfile(os.path.join(output_dir, "run_spades.yaml"))):
             previous_pipeline = pyyaml.load(open(os.path.join(output_dir, "run_spades.yaml")))
             for previous_stage in previous_pipeline:
-                self.tmp_files += previous_stage["del_after"]
+                for tmp_file in previous_stage["del_after"]:
+                    # the working dirs with a checkpoint are needed by the continued run
+                    if options_storage.args.continue_mode and \
+                            os.path.isfile(os.path.join(output_dir, tmp_file, options_storage.CHECKPOINT_MANIFEST)):
+                        continue
+                    self.tmp_files.append(tmp_file)
 
     def get_command(self, cfg):
         return [commands_parser.Command(STAGE=self.STAGE_NAME,
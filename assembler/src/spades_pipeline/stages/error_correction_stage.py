@@ -18,7 +18,7 @@ import options_storage
 from stages import stage
 import process_cfg
 import support
-from process_cfg import merge_configs
+from process_cfg import merge_configs, bool_to_str
 
 
 class ECRunningToolStage(stage.Stage):
@@ -40,6 +40,7 @@ class ECRunningToolStage(stage.Stage):
             subst_dict["count_filter_singletons"] = cfg.count_filter_singletons
         if "read_buffer_size" in cfg.__dict__:
             subst_dict["count_split_buffer"] = cfg.read_buffer_size
+        subst_dict["general_checkpoints"] = bool_to_str(self.use_checkpoints(cfg))
         process_cfg.substitute_params(filename, subst_dict, log)
 
     def prepare_config_ih(self, filename, cfg, ext_python_modules_home):
@@ -58,6 +59,10 @@ class ECRunningToolStage(stage.Stage):
             pyyaml.dump(data, f,
                         default_flow_style=False, default_style='"', width=float("inf"))
 
+    # Only BayesHammer could continue an interrupted run
+    def use_checkpoints(self, cfg):
+        return not cfg.iontorrent and cfg.__dict__.get("checkpoints", "none") != "none"
+
     def generate_config(self, cfg):
         dst_configs = os.path.join(cfg.output_dir, "configs")
         if os.path.isdir(dst_configs):
@@ -69,7 +74,15 @@ class ECRunningToolStage(stage.Stage):
             dir_util.copy_tree(os.path.join(self.tmp_configs_dir, "hammer"), dst_configs, preserve_times=False)
             cfg_file_name = os.path.join(dst_configs, "config.info")
 
-        cfg.tmp_dir = support.get_tmp_dir(prefix="hammer_")
+        if self.use_checkpoints(cfg):
+            # BayesHammer keeps its checkpoints in the working directory, so
+            # it should be found again by the continued run. BayesHammer
+            # creates the directory itself.
+            cfg.tmp_dir = os.path.join(options_storage.args.tmp_dir, "hammer")
+            if options_storage.args.restart_from == "ec" and os.path.isdir(cfg.tmp_dir):
+                shutil.rmtree(cfg.tmp_dir)
+        else:
+            cfg.tmp_dir = support.get_tmp_dir(prefix="hammer_")
         if cfg.iontorrent:
             self.prepare_config_ih(cfg_file_name, cfg, self.ext_python_modules_home)
         else:
@@ -87,9 +100,13 @@ class ECRunningToolStage(stage.Stage):
         else:
             binary_name = "spades-hammer"
 
+        args = [os.path.abspath(cfg_file_name)]
+        if self.use_checkpoints(cfg) and options_storage.args.continue_mode:
+            args.append("--continue")
+
         command = [commands_parser.Command(STAGE="Read error correction",
                                            path=os.path.join(self.bin_home, binary_name),
-                                           args=[os.path.abspath(cfg_file_name)],
+                                           args=args,
                                            config_dir=os.path.relpath(cfg.output_dir, options_storage.args.output_dir),
                                            short_name=self.short_name,
                                            del_after=[os.path.relpath(cfg.tmp_dir, options_storage.args.output_dir)],
@@ -0,0 +1,142 @@
+//***************************************************************************
+//* Copyright (c) 2021 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#include "adt/ring_buffer.hpp"
+
+#include <deque>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+template<class T>
+static std::vector<T> contents(const adt::ring_buffer<T> &buffer) {
+    return std::vector<T>(buffer.begin(), buffer.end());
+}
+
+template<class T>
+static std::vector<T> segments(const adt::ring_buffer<T> &buffer, size_t from, size_t to,
+                               size_t *count = nullptr) {
+    std::vector<T> result;
+    size_t segments = 0;
+    buffer.for_each_segment(from, to, [&](const T *ptr, size_t n, size_t index) {
+        EXPECT_EQ(index, from + result.size());
+        EXPECT_GT(n, 0);
+        result.insert(result.end(), ptr, ptr + n);
+        segments += 1;
+    });
+    if (count)
+        *count = segments;
+    return result;
+}
+
+TEST(RingBuffer, PushPopFrontWraparound) {
+    adt::ring_buffer<int> buffer;
+    buffer.push_back(1);
+    EXPECT_EQ(buffer.capacity(), 4);
+
+    // The head moves to the last slot of the storage and back
+    buffer.push_front(0);
+    buffer.push_front(-1);
+    EXPECT_EQ(buffer.capacity(), 4);
+    EXPECT_EQ(contents(buffer), std::vector<int>({-1, 0, 1}));
+    EXPECT_EQ(buffer.front(), -1);
+    EXPECT_EQ(buffer.back(), 1);
+    EXPECT_EQ(buffer[0], -1);
+    EXPECT_EQ(buffer.at(2), 1);
+    EXPECT_THROW(buffer.at(3), std::out_of_range);
+
+    buffer.pop_front();
+    buffer.pop_front();
+    EXPECT_EQ(contents(buffer), std::vector<int>({1}));
+
+    // Many rounds over the same storage with no reallocation
+    std::deque<int> expected(buffer.begin(), buffer.end());
+    for (int i = 0; i < 100; ++i) {
+        buffer.push_front(i);
+        expected.push_front(i);
+        buffer.push_front(-i);
+        expected.push_front(-i);
+        buffer.pop_back();
+        expected.pop_back();
+        buffer.pop_back();
+        expected.pop_back();
+        ASSERT_EQ(contents(buffer), std::vector<int>(expected.begin(), expected.end()));
+    }
+    EXPECT_EQ(buffer.capacity(), 4);
+
+    while (!buffer.empty())
+        buffer.pop_front();
+    EXPECT_EQ(buffer.size(), 0);
+    EXPECT_EQ(buffer.begin(), buffer.end());
+}
+
+TEST(RingBuffer, GrowWhileWrapped) {
+    adt::ring_buffer<int> buffer;
+    std::deque<int> expected;
+    buffer.push_back(2);
+    buffer.push_back(3);
+    buffer.push_front(1);
+    buffer.push_front(0);
+    expected = {0, 1, 2, 3};
+    // The head is in the middle of the full storage, the next push reallocates
+    EXPECT_EQ(buffer.capacity(), 4);
+    EXPECT_EQ(contents(buffer), std::vector<int>(expected.begin(), expected.end()));
+
+    for (int i = 4; i < 40; ++i) {
+        if (i % 3) {
+            buffer.push_back(i);
+            expected.push_back(i);
+        } else {
+            buffer.push_front(i);
+            expected.push_front(i);
+        }
+        ASSERT_EQ(contents(buffer), std::vector<int>(expected.begin(), expected.end()));
+    }
+    EXPECT_EQ(buffer.size(), 40);
+    EXPECT_EQ(buffer.capacity(), 64);
+
+    adt::ring_buffer<int> copy(buffer);
+    EXPECT_EQ(contents(copy), contents(buffer));
+
+    buffer.reserve(100);
+    EXPECT_EQ(buffer.capacity(), 128);
+    EXPECT_EQ(contents(buffer), std::vector<int>(expected.begin(), expected.end()));
+}
+
+TEST(RingBuffer, SegmentsAcrossSeam) {
+    adt::ring_buffer<int> buffer;
+    for (int i = 0; i < 6; ++i)
+        buffer.push_back(i);
+    EXPECT_EQ(buffer.capacity(), 8);
+
+    size_t count = 0;
+    EXPECT_EQ(segments(buffer, 0, buffer.size(), &count), contents(buffer));
+    EXPECT_EQ(count, 1);
+
+    // Elements now occupy the last three and the first three slots
+    for (int i = 0; i < 5; ++i)
+        buffer.pop_front();
+    for (int i = 6; i < 11; ++i)
+        buffer.push_back(i);
+    ASSERT_EQ(buffer.capacity(), 8);
+    ASSERT_EQ(contents(buffer), std::vector<int>({5, 6, 7, 8, 9, 10}));
+
+    EXPECT_EQ(segments(buffer, 0, 6, &count), contents(buffer));
+    EXPECT_EQ(count, 2);
+    EXPECT_EQ(segments(buffer, 1, 5, &count), std::vector<int>({6, 7, 8, 9}));
+    EXPECT_EQ(count, 2);
+    EXPECT_EQ(segments(buffer, 0, 3, &count), std::vector<int>({5, 6, 7}));
+    EXPECT_EQ(count, 1);
+    EXPECT_EQ(segments(buffer, 3, 6, &count), std::vector<int>({8, 9, 10}));
+    EXPECT_EQ(count, 1);
+    EXPECT_EQ(segments(buffer, 4, 4, &count), std::vector<int>());
+    EXPECT_EQ(count, 0);
+}
+
+GTEST_API_ int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -196,3 +196,176 @@ TEST(GraphAligner, DijkstraGrowEndsTest ) {
     int score = ends_filler.edit_distance();
     EXPECT_EQ(ideal_score, score);
 }
+
+static sensitive_aligner::GapFillerResult TestGapResult(int score, size_t path_len) {
+    sensitive_aligner::GapFillerResult res;
+    res.score = score;
+    res.full_intermediate_path.assign(path_len, EdgeId(score));
+    return res;
+}
+
+// The queue of the gap Dijkstra replaced a std::set of (score, state) pairs,
+// the states have to come out in exactly the same order under the updates
+// done by DijkstraGraphSequenceBase::Update, ties included
+TEST(GraphAligner, DijkstraStateQueue) {
+    using namespace sensitive_aligner;
+    srand(7);
+
+    // The new implementation: numbered states, their scores and the queue
+    std::unordered_map<QueueState, size_t> ids;
+    std::vector<QueueState> states;
+    std::vector<int> scores;
+    StateQueue queue;
+
+    // The previous one
+    std::unordered_map<QueueState, int> visited;
+    std::set<std::pair<int, QueueState>> reference;
+
+    auto pop = [&]() {
+        ASSERT_EQ(reference.size(), queue.size());
+        size_t id = queue.Pop(states);
+        EXPECT_EQ(reference.begin()->second, states[id]);
+        EXPECT_EQ(reference.begin()->first, scores[id]);
+        reference.erase(reference.begin());
+    };
+
+    size_t pops = 0;
+    for (size_t step = 0; step < 50000; ++step) {
+        if (rand() % 3 == 0 && !reference.empty()) {
+            pop();
+            ++pops;
+            continue;
+        }
+
+        // Few distinct states and scores, so there are many updates and ties
+        QueueState state(GraphState(EdgeId(1 + rand() % 5), rand() % 3, 3 + rand() % 3), rand() % 4);
+        int score = rand() % 30;
+        // IsBetter() might reject the state depending on the other ones
+        bool better = rand() % 5 != 0;
+
+        auto it = visited.find(state);
+        if (it != visited.end()) {
+            if (it->second >= score) {
+                reference.erase(std::make_pair(it->second, state));
+                if (better) {
+                    reference.emplace(score, state);
+                    it->second = score;
+                }
+            }
+        } else if (better) {
+            reference.emplace(score, state);
+            visited.emplace(state, score);
+        }
+
+        auto id_it = ids.find(state);
+        if (id_it != ids.end()) {
+            size_t id = id_it->second;
+            if (scores[id] >= score) {
+                queue.Remove(id);
+                if (better) {
+                    scores[id] = score;
+                    queue.Push(id, score, states);
+                }
+            }
+        } else if (better) {
+            ids.emplace(state, states.size());
+            states.push_back(state);
+            scores.push_back(score);
+            queue.Push(states.size() - 1, score, states);
+        }
+        ASSERT_EQ(reference.size(), queue.size());
+    }
+    while (!reference.empty())
+        pop();
+    EXPECT_TRUE(queue.empty());
+    EXPECT_GT(pops, 1000);
+}
+
+TEST(GraphAligner, GapFillerCacheHitMiss) {
+    using sensitive_aligner::GraphPosition;
+    sensitive_aligner::GapFillerCache cache;
+    GraphPosition start(EdgeId(1), 10), end(EdgeId(2), 20);
+    size_t fills = 0;
+    auto fill = [&](int score) {
+        return [&fills, score]() { fills += 1; return TestGapResult(score, 3); };
+    };
+
+    EXPECT_EQ(1, cache.Get("ACGT", start, end, 0, 100, fill(1)).score);
+    EXPECT_EQ(1, cache.Get("ACGT", start, end, 0, 100, fill(2)).score);
+    // Every part of the key matters
+    EXPECT_EQ(3, cache.Get("ACGA", start, end, 0, 100, fill(3)).score);
+    EXPECT_EQ(4, cache.Get("ACGT", start, GraphPosition(EdgeId(2), 21), 0, 100, fill(4)).score);
+    EXPECT_EQ(5, cache.Get("ACGT", start, end, 0, 101, fill(5)).score);
+    EXPECT_EQ(1, cache.Get(std::string("ACGT"), start, end, 0, 100, fill(6)).score);
+
+    EXPECT_EQ(4, fills);
+    EXPECT_EQ(2, cache.hits());
+    EXPECT_EQ(4, cache.misses());
+    EXPECT_EQ(0, cache.evictions());
+    EXPECT_EQ(4, cache.size());
+}
+
+// The same gap filled concurrently is kept once
+TEST(GraphAligner, GapFillerCacheDuplicateInsert) {
+    using sensitive_aligner::GraphPosition;
+    sensitive_aligner::GapFillerCache cache;
+    GraphPosition start(EdgeId(1), 10), end(EdgeId(2), 20);
+
+    auto res = cache.Get("ACGT", start, end, 0, 100, [&]() {
+            // Filled by someone else while this one is being computed
+            cache.Get("ACGT", start, end, 0, 100, []() { return TestGapResult(1, 3); });
+            return TestGapResult(2, 3);
+        });
+    EXPECT_EQ(2, res.score);
+    EXPECT_EQ(2, cache.misses());
+    EXPECT_EQ(1, cache.size());
+
+    size_t bytes = cache.bytes();
+    EXPECT_EQ(1, cache.Get("ACGT", start, end, 0, 100, []() { return TestGapResult(3, 3); }).score);
+    EXPECT_EQ(bytes, cache.bytes());
+}
+
+TEST(GraphAligner, GapFillerCacheEviction) {
+    using sensitive_aligner::GraphPosition;
+    GraphPosition start(EdgeId(1), 10), end(EdgeId(2), 20);
+    std::string seq(1000, 'A');
+
+    // Measure a single entry to size a single-shard cache to three of them
+    size_t entry_bytes;
+    {
+        sensitive_aligner::GapFillerCache cache;
+        cache.Get(seq, start, end, 0, 0, []() { return TestGapResult(0, 3); });
+        entry_bytes = cache.bytes();
+    }
+    sensitive_aligner::GapFillerCache cache(3 * entry_bytes + entry_bytes / 2, 1);
+    auto get = [&](int i) {
+        return cache.Get(seq, start, end, 0, i, [i]() { return TestGapResult(i, 3); });
+    };
+
+    for (int i = 0; i < 3; ++i)
+        get(i);
+    EXPECT_EQ(3, cache.size());
+    EXPECT_EQ(3 * entry_bytes, cache.bytes());
+    EXPECT_EQ(0, cache.evictions());
+
+    // 0 becomes the most recently used one, so 1 is evicted
+    get(0);
+    get(3);
+    EXPECT_EQ(1, cache.evictions());
+    EXPECT_EQ(3, cache.size());
+    EXPECT_EQ(3 * entry_bytes, cache.bytes());
+
+    size_t misses = cache.misses();
+    get(0); get(2); get(3);
+    EXPECT_EQ(misses, cache.misses());
+    get(1);
+    EXPECT_EQ(misses + 1, cache.misses());
+    EXPECT_EQ(2, cache.evictions());
+
+    // Too large to be kept at all
+    std::string large(4 * entry_bytes, 'C');
+    cache.Get(large, start, end, 0, 0, []() { return TestGapResult(0, 3); });
+    EXPECT_EQ(2, cache.evictions());
+    EXPECT_EQ(3, cache.size());
+    EXPECT_EQ(misses + 2, cache.misses());
+}
@@ -6,13 +6,32 @@
 
 #include "test_utils.hpp"
 #include "random_graph.hpp"
+#include "tmp_folder_fixture.hpp"
+#include "assembly_graph/core/construction_helper.hpp"
 #include "assembly_graph/handlers/id_track_handler.hpp"
 #include "io/binary/graph.hpp"
+#include "io/binary/graph_delta.hpp"
+#include "io/binary/graph_pack.hpp"
 #include "io/binary/kmer_mapper.hpp"
 #include "io/binary/paired_index.hpp"
+#include "io/graph/gfa_reader.hpp"
+#include "io/graph/gfa_writer.hpp"
+#include "io/reads/binary_converter.hpp"
+#include "io/reads/binary_streams.hpp"
+#include "io/reads/longest_valid_wrapper.hpp"
+#include "io/reads/vector_reader.hpp"
+#include "io/sam/bam_reader.hpp"
+#include "utils/filesystem/glob.hpp"
+#include "utils/parallel/openmp_wrapper.h"
+
+#include "gfa1/gfa.h"
+
+#include <bamtools/api/BamWriter.h>
 
 #include <gtest/gtest.h>
 
+#include <sys/stat.h>
+
 using namespace debruijn_graph;
 
 template<typename T>
@@ -109,3 +128,515 @@ TEST(Io, KmerMapper) {
 
     CompareContainers(kmer_mapper, new_mapper);
 }
+
+TEST(Io, GraphDelta) {
+    TmpFolderFixture fixture("tmp_delta");
+    std::string base = fs::append_path(fs::append_path(fixture.tmp_folder(), "base"), "test_save");
+    std::string delta = fs::append_path(fs::append_path(fixture.tmp_folder(), "delta"), "test_save");
+    fs::make_dirs(fs::parent_path(base));
+    fs::make_dirs(fs::parent_path(delta));
+
+    Graph graph(55);
+    RandomGraph<Graph>(graph, /*max_size*/100).Generate(/*iterations*/1000);
+    Save(base, graph);
+    std::ofstream(base + ".toc") << "test_save.grp\n";
+
+    omnigraph::GraphJournal<Graph> journal(graph);
+    journal.Rebase("base");
+
+    // Pairs are deleted via the conjugate ids
+    auto v1 = *graph.SmartVertexBegin(), v2 = graph.conjugate(v1);
+    EdgeId removed = *graph.SmartEdgeBegin();
+    graph.DeleteEdge(graph.conjugate(removed));
+    EdgeId added = graph.AddEdge(v1, v2, RandomSequence(60));
+    EdgeId transient = graph.AddEdge(v2, v1, RandomSequence(70));
+    graph.DeleteEdge(graph.conjugate(transient));
+    EdgeId kept = graph.AddEdge(v1, v1, RandomSequence(80));
+    EXPECT_EQ(2u, journal.added_edges().size());
+    EXPECT_EQ(1u, journal.removed_edges().size());
+
+    GraphDeltaIO<Graph>().Save(delta, graph, journal);
+
+    Graph new_graph(graph.k());
+    GraphDeltaIO<Graph>().Load(delta, new_graph);
+
+    CompareGraphIterators(graph.SmartVertexBegin(), new_graph.SmartVertexBegin());
+    CompareGraphIterators(graph.SmartEdgeBegin(), new_graph.SmartEdgeBegin());
+    for (EdgeId e : {added, kept}) {
+        EXPECT_TRUE(new_graph.contains(e));
+        EXPECT_EQ(graph.EdgeNucls(e), new_graph.EdgeNucls(e));
+        EXPECT_EQ(graph.conjugate(e).int_id(), new_graph.conjugate(e).int_id());
+    }
+}
+
+static std::string FileContents(const std::string &filename) {
+    std::ifstream is(filename, std::ios::binary);
+    std::stringstream ss;
+    ss << is.rdbuf();
+    return ss.str();
+}
+
+static ino_t FileInode(const std::string &filename) {
+    struct stat st;
+    EXPECT_EQ(0, stat(filename.c_str(), &st)) << filename;
+    return st.st_ino;
+}
+
+// Checks that exactly the files of the save identical to the ones of the base
+// are hard-linked to them, returns the number of such files
+static size_t CheckSharedFiles(const std::string &save, const std::string &base) {
+    size_t shared = 0;
+    for (const auto &file : fs::glob(save + "*")) {
+        std::string base_file = fs::append_path(fs::parent_path(base), fs::filename(file));
+        if (fs::extension(file) == ".toc" || !fs::FileExists(base_file))
+            continue;
+        bool same = FileContents(file) == FileContents(base_file);
+        EXPECT_EQ(same, FileInode(file) == FileInode(base_file)) << file;
+        shared += same;
+    }
+    return shared;
+}
+
+TEST(Io, IncrementalPack) {
+    TmpFolderFixture fixture("tmp_incremental");
+    auto save_path = [&](const std::string &name) {
+        std::string dir = fs::append_path(fixture.tmp_folder(), name);
+        fs::make_dirs(dir);
+        return fs::append_path(dir, "graph_pack");
+    };
+    std::string base = save_path("base"), delta = save_path("delta"), old_delta = save_path("old_delta");
+
+    GraphPack gp(55, fixture.tmp_folder(), 1);
+    auto &graph = gp.get_mutable<Graph>();
+    RandomGraph<Graph>(graph, /*max_size*/100).Generate(/*iterations*/1000);
+    auto &journal = gp.get_mutable<omnigraph::GraphJournal<Graph>>();
+    journal.Attach();
+    FullPackIO().Save(base, gp);
+    journal.Rebase("base");
+
+    // The graph and the clustered index change, the other components stay the same
+    auto v = *graph.SmartVertexBegin();
+    graph.AddEdge(v, graph.conjugate(v), RandomSequence(70));
+    EdgeId e = *graph.SmartEdgeBegin();
+    gp.get_mutable<omnigraph::de::PairedInfoIndicesT<Graph>>("clustered_indices")[0].Add(e, e, omnigraph::de::Point(1, 5, 0));
+
+    IncrementalPackIO(journal).Save(delta, gp);
+    EXPECT_GT(CheckSharedFiles(delta, base), 0);
+    EXPECT_TRUE(GraphDeltaIO<Graph>::Exists(delta));
+
+    GraphPack loaded(55, fixture.tmp_folder(), 1);
+    ASSERT_TRUE(FullPackIO().Load(delta, loaded));
+    CompareGraphIterators(graph.SmartVertexBegin(), loaded.get<Graph>().SmartVertexBegin());
+    CompareGraphIterators(graph.SmartEdgeBegin(), loaded.get<Graph>().SmartEdgeBegin());
+    EXPECT_EQ(gp.get<omnigraph::de::PairedInfoIndicesT<Graph>>("clustered_indices")[0].size(),
+              loaded.get<omnigraph::de::PairedInfoIndicesT<Graph>>("clustered_indices")[0].size());
+
+    // Nothing is shared with a base whose table of contents has no checksums
+    std::ifstream toc(base + ".toc");
+    std::string name, line, old_toc;
+    size_t size;
+    while (std::getline(toc, line) && std::istringstream(line) >> name >> size)
+        old_toc += name + " " + std::to_string(size) + "\n";
+    toc.close();
+    std::ofstream(base + ".toc") << old_toc;
+    IncrementalPackIO(journal).Save(old_delta, gp);
+    for (const auto &file : fs::glob(old_delta + "*")) {
+        std::string base_file = fs::append_path(fs::parent_path(base), fs::filename(file));
+        if (fs::FileExists(base_file)) {
+            EXPECT_NE(FileInode(file), FileInode(base_file)) << file;
+        }
+    }
+}
+
+// GFAReader::to_graph as it was before the parallel construction: edges and
+// vertices are created one by one in the order of segments
+static void SequentialGFAGraph(const gfa_t *gfa, Graph &g, io::IdMapper<std::string> &id_mapper,
+                               std::vector<std::vector<EdgeId>> &paths) {
+    auto helper = g.GetConstructionHelper();
+    std::vector<EdgeId> edges;
+    for (uint32_t i = 0; i < gfa->n_seg; ++i) {
+        gfa_seg_t *seg = gfa->seg + i;
+        uint8_t *kc = gfa_aux_get(seg->aux.l_aux, seg->aux.aux, "KC");
+        unsigned cov = (kc && kc[0] == 'i') ? *(int32_t*)(kc + 1) : 0;
+        EdgeId e = helper.AddEdge(DeBruijnEdgeData(Sequence(seg->seq)));
+        g.coverage_index().SetRawCoverage(e, cov);
+        g.coverage_index().SetRawCoverage(g.conjugate(e), cov);
+        id_mapper[e.int_id()] = seg->name;
+        if (e != g.conjugate(e))
+            id_mapper[g.conjugate(e).int_id()] = std::string(seg->name) + '\'';
+        edges.push_back(e);
+    }
+
+    std::vector<VertexId> vertices;
+    for (EdgeId e : edges) {
+        vertices.push_back(helper.CreateVertex(DeBruijnVertexData()));
+        helper.LinkIncomingEdge(vertices.back(), e);
+        if (e != g.conjugate(e)) {
+            vertices.push_back(helper.CreateVertex(DeBruijnVertexData()));
+            helper.LinkIncomingEdge(vertices.back(), g.conjugate(e));
+        }
+    }
+
+    for (uint32_t v = 0; v < 2 * gfa->n_seg; ++v) {
+        EdgeId e1 = (v & 1) ? g.conjugate(edges[v >> 1]) : edges[v >> 1];
+        gfa_arc_t *av = gfa_arc_a(gfa, v);
+        for (size_t j = 0; j < gfa_arc_n(gfa, v); ++j) {
+            EdgeId e2 = edges[av[j].w >> 1];
+            helper.LinkEdges(e1, (av[j].w & 1) ? g.conjugate(e2) : e2);
+        }
+    }
+
+    for (VertexId v : vertices) {
+        if (g.OutgoingEdgeCount(v) == 0 && g.IncomingEdgeCount(v) == 0)
+            g.DeleteVertex(v);
+    }
+
+    for (uint32_t i = 0; i < gfa->n_path; ++i) {
+        paths.emplace_back();
+        for (uint32_t j = 0; j < gfa->path[i].n_seg; ++j) {
+            uint32_t v = gfa->path[i].v[j];
+            paths.back().push_back((v & 1) ? g.conjugate(edges[v >> 1]) : edges[v >> 1]);
+        }
+    }
+}
+
+static void CompareAux(const gfa_aux_t &expected, const gfa_aux_t &actual) {
+    ASSERT_EQ(expected.l_aux, actual.l_aux);
+    if (expected.l_aux) {
+        EXPECT_EQ(0, memcmp(expected.aux, actual.aux, expected.l_aux));
+    }
+}
+
+// The parsed records must be the same as gfa_read() gives for the whole file
+static void CompareGFA(const gfa_t *expected, const gfa_t *actual) {
+    ASSERT_EQ(expected->n_seg, actual->n_seg);
+    for (uint32_t i = 0; i < expected->n_seg; ++i) {
+        const gfa_seg_t &s1 = expected->seg[i], &s2 = actual->seg[i];
+        EXPECT_STREQ(s1.name, s2.name);
+        EXPECT_STREQ(s1.seq, s2.seq);
+        EXPECT_EQ(s1.len, s2.len);
+        EXPECT_EQ(s1.del, s2.del);
+        CompareAux(s1.aux, s2.aux);
+    }
+
+    ASSERT_EQ(expected->n_arc, actual->n_arc);
+    for (uint64_t k = 0; k < expected->n_arc; ++k) {
+        const gfa_arc_t &a1 = expected->arc[k], &a2 = actual->arc[k];
+        EXPECT_EQ(a1.v_lv, a2.v_lv);
+        EXPECT_EQ(a1.w, a2.w);
+        EXPECT_EQ(a1.lw, a2.lw);
+        EXPECT_EQ(a1.ov, a2.ov);
+        EXPECT_EQ(a1.ow, a2.ow);
+        EXPECT_EQ(a1.link_id, a2.link_id);
+        EXPECT_EQ(a1.comp, a2.comp);
+        CompareAux(expected->arc_aux[k], actual->arc_aux[k]);
+    }
+    for (uint32_t v = 0; v < 2 * expected->n_seg; ++v)
+        EXPECT_EQ(expected->idx[v], actual->idx[v]);
+
+    ASSERT_EQ(expected->n_path, actual->n_path);
+    for (uint32_t i = 0; i < expected->n_path; ++i) {
+        const gfa_path_t &p1 = expected->path[i], &p2 = actual->path[i];
+        EXPECT_STREQ(p1.name, p2.name);
+        ASSERT_EQ(p1.n_seg, p2.n_seg);
+        for (uint32_t j = 0; j < p1.n_seg; ++j)
+            EXPECT_EQ(p1.v[j], p2.v[j]);
+    }
+}
+
+template<class Container>
+static std::vector<size_t> EdgeIds(const Container &edges) {
+    std::vector<size_t> ids;
+    for (EdgeId e : edges)
+        ids.push_back(e.int_id());
+    return ids;
+}
+
+TEST(Io, GFAReader) {
+    TmpFolderFixture fixture("tmp_gfa");
+    std::string filename = fs::append_path(fixture.tmp_folder(), "graph.gfa");
+
+    Graph graph(55);
+    RandomGraph<Graph>(graph, /*max_size*/100).Generate(/*iterations*/1000);
+    {
+        std::ofstream os(filename);
+        gfa::GFAWriter(graph, os).WriteSegmentsAndLinks();
+
+        // Self-conjugate segments, links given together with their
+        // complements, segments mentioned before and redefined after their
+        // S-lines, CRLF and empty lines, a malformed link and paths
+        io::CanonicalEdgeHelper<Graph> namer(graph);
+        EdgeId e = *graph.SmartEdgeBegin();
+        Sequence half = RandomSequence(40);
+        os << "S\tpal1\t" << half << !half << "\tKC:i:7\n"
+           << "L\tpal1\t+\tpal1\t-\t55M\n"
+           << "L\tlate\t+\tpal1\t+\t55M\tL1:i:100\n"
+           << "L\tpal1\t-\tlate\t-\t55M\r\n"
+           << "\n"
+           << "L\tlate\t?\tpal1\t+\t55M\n"
+           << "S\tlate\t" << RandomSequence(120) << "\tKC:i:3\r\n"
+           << "L\t" << namer.EdgeOrientationString(e, "\t") << "\tlate\t+\t55M\n"
+           << "P\tpath1\tlate+,pal1-," << namer.EdgeOrientationString(graph.conjugate(e)) << "\t*\n";
+        half = RandomSequence(31);
+        os << "S\tpal2\t" << half << !half << "\n"
+           << "L\tpal2\t+\tlate\t+\t55M\n"
+           << "S\tlate\t" << RandomSequence(90) << "\tKC:i:5\n"
+           << "L\tlate\t+\tpal2\t-\t55M\tL1:i:200\n"
+           << "P\tpath2\tpal2+,late-\t*";
+    }
+
+    std::unique_ptr<gfa_t, void(*)(gfa_t*)> expected(gfa_read(filename.c_str()), gfa_destroy);
+    ASSERT_TRUE(expected);
+    Graph expected_graph(graph.k());
+    io::IdMapper<std::string> expected_ids;
+    std::vector<std::vector<EdgeId>> expected_paths;
+    SequentialGFAGraph(expected.get(), expected_graph, expected_ids, expected_paths);
+    EXPECT_EQ(2u, expected->n_path);
+
+    int max_threads = omp_get_max_threads();
+    for (int nthreads : { 1, 3, 8 }) {
+        omp_set_num_threads(nthreads);
+        gfa::GFAReader reader(filename);
+        ASSERT_TRUE(reader.valid());
+        CompareGFA(expected.get(), reader.get());
+
+        Graph new_graph(graph.k());
+        io::IdMapper<std::string> new_ids;
+        reader.to_graph(new_graph, &new_ids);
+
+        CompareGraphIterators(expected_graph.SmartVertexBegin(), new_graph.SmartVertexBegin());
+        CompareGraphIterators(expected_graph.SmartEdgeBegin(), new_graph.SmartEdgeBegin());
+        EXPECT_EQ(expected_ids.size(), new_ids.size());
+        for (EdgeId e : expected_graph.edges()) {
+            ASSERT_TRUE(new_graph.contains(e));
+            EXPECT_EQ(expected_graph.EdgeNucls(e), new_graph.EdgeNucls(e));
+            EXPECT_EQ(expected_graph.conjugate(e).int_id(), new_graph.conjugate(e).int_id());
+            EXPECT_EQ(expected_graph.EdgeStart(e).int_id(), new_graph.EdgeStart(e).int_id());
+            EXPECT_EQ(expected_graph.EdgeEnd(e).int_id(), new_graph.EdgeEnd(e).int_id());
+            EXPECT_EQ(expected_graph.coverage_index().RawCoverage(e), new_graph.coverage_index().RawCoverage(e));
+            EXPECT_EQ(expected_ids[e.int_id()], new_ids[e.int_id()]);
+        }
+        for (VertexId v : expected_graph.vertices()) {
+            ASSERT_TRUE(new_graph.contains(v));
+            EXPECT_EQ(expected_graph.conjugate(v).int_id(), new_graph.conjugate(v).int_id());
+            EXPECT_EQ(EdgeIds(expected_graph.OutgoingEdges(v)), EdgeIds(new_graph.OutgoingEdges(v)));
+        }
+
+        ASSERT_EQ(expected_paths.size(), reader.num_paths());
+        auto path = reader.path_begin();
+        for (size_t i = 0; i < expected_paths.size(); ++i, ++path)
+            EXPECT_EQ(EdgeIds(expected_paths[i]), EdgeIds(path->edges));
+    }
+    omp_set_num_threads(max_threads);
+
+    size_t self_conjugate = 0;
+    for (EdgeId e : expected_graph.edges())
+        self_conjugate += (e == expected_graph.conjugate(e));
+    EXPECT_EQ(2u, self_conjugate);
+}
+
+// Reads with quality and N's, trimmed to the longest valid piece as the
+// converter does. There are several blocks of reads, the last one incomplete
+static std::vector<io::SingleRead> BinaryTestReads(size_t count, const std::string &prefix) {
+    std::vector<io::SingleRead> reads;
+    for (size_t i = 0; i < count; ++i) {
+        std::string seq = RandomSequence(50 + rand() % 100).str();
+        if (i % 3 == 0)
+            seq[rand() % seq.size()] = 'N';
+        if (i % 7 == 0)
+            seq[rand() % seq.size()] = 'N';
+        io::SingleRead read(prefix + std::to_string(i), seq, std::string(seq.size(), 'I'));
+        io::LongestValid(read);
+        reads.push_back(read);
+    }
+    return reads;
+}
+
+static void CompareReads(const io::SingleRead &expected, const io::SingleReadSeq &actual) {
+    EXPECT_EQ(expected.sequence(), actual.sequence());
+    EXPECT_EQ(expected.GetLeftOffset(), actual.GetLeftOffset());
+    EXPECT_EQ(expected.GetRightOffset(), actual.GetRightOffset());
+}
+
+TEST(Io, BinaryReads) {
+    TmpFolderFixture fixture("tmp_reads");
+    std::string single = fs::append_path(fixture.tmp_folder(), "single");
+    std::string paired = fs::append_path(fixture.tmp_folder(), "paired");
+
+    const size_t count = 3 * io::BinaryWriter::CHUNK + 42;
+    auto reads = BinaryTestReads(count, "read");
+    {
+        io::ReadStream<io::SingleRead> stream(io::VectorReadStream<io::SingleRead>{reads});
+        auto stat = io::BinaryWriter(single).ToBinary(stream);
+        EXPECT_EQ(count, stat.read_count);
+    }
+
+    std::vector<io::PairedRead> pairs;
+    auto lefts = BinaryTestReads(count, "left"), rights = BinaryTestReads(count, "right");
+    for (size_t i = 0; i < count; ++i)
+        pairs.emplace_back(lefts[i], rights[i], 300);
+    {
+        io::ReadStream<io::PairedRead> stream(io::VectorReadStream<io::PairedRead>{pairs});
+        auto stat = io::BinaryWriter(paired).ToBinary(stream, io::LibraryOrientation::FR);
+        EXPECT_EQ(count, stat.read_count);
+    }
+
+    {
+        io::BinaryFileSingleStream stream(single, 1, 0);
+        io::SingleReadSeq read;
+        for (size_t i = 0; i < count; ++i) {
+            ASSERT_FALSE(stream.eof());
+            stream >> read;
+            CompareReads(reads[i], read);
+        }
+        EXPECT_TRUE(stream.eof());
+    }
+
+    // FR reads are stored with the second mate reverse-complemented
+    {
+        io::BinaryFilePairedStream stream(paired, 300, 1, 0);
+        io::PairedReadSeq read;
+        for (size_t i = 0; i < count; ++i) {
+            ASSERT_FALSE(stream.eof());
+            stream >> read;
+            CompareReads(pairs[i].first(), read.first());
+            CompareReads(!pairs[i].second(), read.second());
+            EXPECT_EQ(300, read.orig_insert_size());
+        }
+        EXPECT_TRUE(stream.eof());
+    }
+
+    // The streams over the shared blocks interleave them and
+    // all together read every read exactly once
+    {
+        const size_t stream_count = 3;
+        auto chunks = std::make_shared<io::BinaryReadBlocks>(single);
+        std::vector<std::unique_ptr<io::BinaryFileSingleStream>> streams;
+        for (size_t i = 0; i < stream_count; ++i)
+            streams.emplace_back(new io::BinaryFileSingleStream(chunks, i, stream_count));
+
+        size_t read_count = 0;
+        for (size_t block = 0; read_count < count; ++block) {
+            auto &stream = *streams[block % stream_count];
+            io::SingleReadSeq read;
+            for (size_t i = 0; i < io::BinaryWriter::CHUNK && read_count < count; ++i, ++read_count) {
+                ASSERT_FALSE(stream.eof());
+                stream >> read;
+                CompareReads(reads[read_count], read);
+            }
+        }
+        for (const auto &stream : streams)
+            EXPECT_TRUE(stream->eof());
+
+        // Reset rewinds to the first block of the stream
+        streams[1]->reset();
+        io::SingleReadSeq read;
+        *streams[1] >> read;
+        CompareReads(reads[io::BinaryWriter::CHUNK], read);
+    }
+}
+
+// Writes a BAM file spanning several batches of BGZF blocks, with unmapped
+// reads mixed with the aligned ones
+static void WriteTestBam(const std::string &filename, size_t count) {
+    BamTools::RefVector refs = { BamTools::RefData("ref", 1000000) };
+    BamTools::BamWriter writer;
+    ASSERT_TRUE(writer.Open(filename, "@HD\tVN:1.4\tSO:unsorted\n@SQ\tSN:ref\tLN:1000000\n", refs));
+    for (size_t i = 0; i < count; ++i) {
+        BamTools::BamAlignment alignment;
+        alignment.Name = "read" + std::to_string(i);
+        alignment.QueryBases = RandomSequence(50 + rand() % 250).str();
+        if (i % 5 == 0)
+            alignment.QueryBases[rand() % alignment.QueryBases.size()] = 'N';
+        alignment.Length = int32_t(alignment.QueryBases.size());
+        for (size_t j = 0; j < alignment.QueryBases.size(); ++j)
+            alignment.Qualities.push_back(char(33 + rand() % 40));
+        if (i % 2) {
+            alignment.RefID = 0;
+            alignment.Position = int32_t(rand() % 100000);
+            alignment.MapQuality = 60;
+            uint32_t clip = uint32_t(alignment.Length / 4);
+            alignment.CigarData = { BamTools::CigarOp('S', clip), BamTools::CigarOp('M', alignment.Length - clip) };
+        } else {
+            alignment.RefID = alignment.MateRefID = -1;
+            alignment.Position = alignment.MatePosition = -1;
+            alignment.SetIsMapped(false);
+        }
+        alignment.AddTag("RG", "Z", std::string("group"));
+        ASSERT_TRUE(writer.SaveAlignment(alignment));
+    }
+    writer.Close();
+}
+
+static void CompareAlignments(const BamTools::BamAlignment &expected, const BamTools::BamAlignment &actual) {
+    EXPECT_EQ(expected.Name, actual.Name);
+    EXPECT_EQ(expected.QueryBases, actual.QueryBases);
+    EXPECT_EQ(expected.Qualities, actual.Qualities);
+    EXPECT_EQ(expected.AlignedBases, actual.AlignedBases);
+    EXPECT_EQ(expected.TagData, actual.TagData);
+    EXPECT_EQ(expected.Length, actual.Length);
+    EXPECT_EQ(expected.AlignmentFlag, actual.AlignmentFlag);
+    EXPECT_EQ(expected.RefID, actual.RefID);
+    EXPECT_EQ(expected.Position, actual.Position);
+    EXPECT_EQ(expected.MapQuality, actual.MapQuality);
+    ASSERT_EQ(expected.CigarData.size(), actual.CigarData.size());
+    for (size_t i = 0; i < expected.CigarData.size(); ++i) {
+        EXPECT_EQ(expected.CigarData[i].Type, actual.CigarData[i].Type);
+        EXPECT_EQ(expected.CigarData[i].Length, actual.CigarData[i].Length);
+    }
+}
+
+TEST(Io, ParallelBamReader) {
+    TmpFolderFixture fixture("tmp_bam");
+    std::string filename = fs::append_path(fixture.tmp_folder(), "reads.bam");
+    const size_t count = 40000;
+    WriteTestBam(filename, count);
+
+    std::vector<BamTools::BamAlignment> expected;
+    {
+        BamTools::BamReader reader;
+        ASSERT_TRUE(reader.Open(filename));
+        BamTools::BamAlignment alignment;
+        while (reader.GetNextAlignment(alignment))
+            expected.push_back(alignment);
+    }
+    ASSERT_EQ(count, expected.size());
+
+    // Records are returned in the file order whatever the number of threads
+    for (unsigned nthreads : {1u, 2u}) {
+        ThreadPool::ThreadPool pool(nthreads);
+        io::ParallelBamParser parser(filename, pool, nthreads);
+        ASSERT_TRUE(parser.is_open());
+
+        std::vector<BamTools::BamAlignment> batch;
+        size_t read = 0, batches = 0;
+        while (parser.ReadBatch(batch)) {
+            batches += 1;
+            ASSERT_LE(read + batch.size(), count);
+            for (size_t i = 0; i < batch.size(); ++i)
+                CompareAlignments(expected[read + i], batch[i]);
+            read += batch.size();
+        }
+        EXPECT_EQ(count, read);
+        EXPECT_GT(batches, 1);
+    }
+
+    io::UnmappedBamStream sequential(filename);
+    io::ParallelUnmappedBamStream parallel(filename, 3);
+    for (size_t pass = 0; pass < 2; ++pass) {
+        io::BamRead expected_read, read;
+        size_t read_count = 0;
+        while (!sequential.eof()) {
+            ASSERT_FALSE(parallel.eof());
+            sequential >> expected_read;
+            parallel >> read;
+            CompareAlignments(expected_read, read);
+            read_count += 1;
+        }
+        EXPECT_TRUE(parallel.eof());
+        EXPECT_EQ(count, read_count);
+
+        sequential.reset();
+        parallel.reset();
+    }
+}
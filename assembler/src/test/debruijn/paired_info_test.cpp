@@ -6,6 +6,7 @@
 
 #include "random_graph.hpp"
 
+#include "paired_info/frozen_paired_index.hpp"
 #include "paired_info/index_point.hpp"
 #include "paired_info/paired_info_helpers.hpp"
 //#include "io/binary/paired_index.hpp"
@@ -458,3 +459,46 @@ TEST(PairedInfo, RandomSymmetry) {
         }
     }
 }
+
+TEST(PairedInfo, Frozen) {
+    using namespace debruijn_graph;
+    Graph graph(55);
+    RandomGraph<Graph>(graph, /*max_size*/100).Generate(/*iterations*/1000);
+
+    PairedInfoIndexT<Graph> pi(graph);
+    std::vector<EdgeId> edges;
+    for (auto it = graph.ConstEdgeBegin(); !it.IsEnd(); ++it)
+        edges.push_back(*it);
+    for (size_t i = 0; i < 2000; ++i) {
+        EdgeId e1 = edges[rand() % edges.size()], e2 = edges[rand() % edges.size()];
+        pi.Add(e1, e2, Point(DEDistance(rand() % 100), DEWeight(1 + rand() % 3), DEVariance(rand() % 5)));
+    }
+    //Add more self-conjugates
+    for (size_t i = 0; i < 5; ++i)
+        pi.Add(edges[i], graph.conjugate(edges[i]), Point(42, 1, 0));
+
+    FrozenPairedInfoIndexT<Graph> frozen(pi);
+    EXPECT_EQ(pi.size(), frozen.size());
+
+    for (EdgeId e1 : edges) {
+        std::vector<std::pair<EdgeId, std::vector<Point>>> expected, actual;
+        for (auto entry : pi.Get(e1))
+            expected.emplace_back(entry.first, std::vector<Point>(entry.second.begin(), entry.second.end()));
+        for (auto entry : frozen.Get(e1))
+            actual.emplace_back(entry.first, std::vector<Point>(entry.second.begin(), entry.second.end()));
+        EXPECT_EQ(expected, actual);
+
+        for (EdgeId e2 : edges) {
+            auto hist = pi.Get(e1, e2);
+            auto frozen_hist = frozen.Get(e1, e2);
+            ASSERT_EQ(hist.size(), frozen_hist.size());
+            EXPECT_EQ(pi.contains(e1, e2), frozen.contains(e1, e2));
+            auto j = frozen_hist.begin();
+            for (auto i = hist.begin(); i != hist.end(); ++i, ++j) {
+                EXPECT_EQ(*i, *j);
+                EXPECT_EQ((*i).weight, (*j).weight);
+                EXPECT_EQ((*i).var, (*j).var);
+            }
+        }
+    }
+}
@@ -7,8 +7,16 @@
 
 #include "modules/path_extend/path_visualizer.hpp"
 #include "modules/path_extend/pe_utils.hpp"
+#include "modules/path_extend/paired_library.hpp"
+#include "modules/path_extend/path_extender.hpp"
+#include "modules/path_extend/pe_resolver.hpp"
+#include "modules/path_extend/long_reads_coverage_map.hpp"
+#include "modules/path_extend/scaffolder2015/connection_condition2015.hpp"
+#include "assembly_graph/components/connected_component.hpp"
+#include "assembly_graph/graph_support/detail_coverage.hpp"
 
 #include "graphio.hpp"
+#include "random_graph.hpp"
 
 #include <gtest/gtest.h>
 
@@ -755,3 +763,348 @@ TEST( PathExtend, BidirectionalPathLoopDetector ) {
     EXPECT_EQ(path1->Size(), 12);
     EXPECT_EQ(path1->Back(), e7);
 }
+
+TEST( PathExtend, PairedHistogramCache ) {
+    Graph g(13);
+    ASSERT_TRUE(graphio::ScanBasicGraph("./src/test/debruijn/graph_fragments/path_extend/distance_estimation", g));
+    std::vector<EdgeId> edges;
+    for (EdgeId e : g.edges())
+        edges.push_back(e);
+    ASSERT_GE(edges.size(), 2);
+
+    size_t fills = 0;
+    auto fill = [&](EdgeId e1, EdgeId e2) {
+        return [&fills, e1, e2](PairedHistogramCache::Points &points) {
+            ++fills;
+            points.emplace_back(float(e1.int_id()), float(e2.int_id()), 0.f);
+        };
+    };
+    auto first_d = [](const PairedHistogramCache::PointsRef &points) {
+        EXPECT_EQ(std::distance(points.begin(), points.end()), 1);
+        return points.begin()->d;
+    };
+
+    PairedHistogramCache cache;
+    for (size_t round = 0; round < 2; ++round)
+        for (EdgeId e1 : edges)
+            for (EdgeId e2 : edges)
+                EXPECT_EQ(first_d(cache.Get(e1, e2, fill(e1, e2))), float(e1.int_id()));
+    EXPECT_EQ(fills, edges.size() * edges.size());
+    EXPECT_EQ(cache.misses(), edges.size() * edges.size());
+    EXPECT_EQ(cache.hits(), edges.size() * edges.size());
+    EXPECT_EQ(cache.evictions(), 0);
+
+    // Nothing fits, every pair is evicted by the next one of its shard
+    fills = 0;
+    PairedHistogramCache tiny_cache(0);
+    auto kept = tiny_cache.Get(edges[0], edges[1], fill(edges[0], edges[1]));
+    for (size_t round = 0; round < 2; ++round)
+        for (EdgeId e1 : edges)
+            for (EdgeId e2 : edges)
+                EXPECT_EQ(first_d(tiny_cache.Get(e1, e2, fill(e1, e2))), float(e1.int_id()));
+    EXPECT_GT(tiny_cache.evictions(), 0);
+    EXPECT_GT(fills, edges.size() * edges.size());
+    EXPECT_EQ(first_d(kept), float(edges[0].int_id()));
+}
+
+TEST( PathExtend, BidirectionalPathLengthAtMixed ) {
+    Graph g(13);
+    ASSERT_TRUE(graphio::ScanBasicGraph("./src/test/debruijn/graph_fragments/path_extend/distance_estimation", g));
+    std::vector<EdgeId> edges;
+    for (EdgeId e : g.edges())
+        edges.push_back(e);
+
+    // Length from the beginning of i-th edge to the path end computed directly
+    auto length_at = [&g](const BidirectionalPath &path, size_t i) {
+        size_t length = 0;
+        for (size_t j = i; j < path.Size(); ++j)
+            length += g.length(path[j]) + (j > i ? path.GapAt(j).gap : 0);
+        return length;
+    };
+
+    // Edges are added to and removed from the front of the path through its conjugate
+    auto path = BidirectionalPath::create(g);
+    auto conj_path = BidirectionalPath::create(g);
+    path->Subscribe(*conj_path);
+    conj_path->Subscribe(*path);
+    path->PushBack(edges[0]);
+    // Positions of the edge starts are kept in a ring buffer, so a mix of the
+    // operations at both ends makes it wrap around and grow while wrapped
+    for (size_t step = 0; step < 200; ++step) {
+        EdgeId e = edges[(step * 7) % edges.size()];
+        int gap = int(step % 5) * 10;
+        switch ((step * 13 + step / 7) % 5) {
+            case 0:
+            case 1:
+                conj_path->PushBack(g.conjugate(e), Gap(gap));
+                break;
+            case 2:
+                path->PushBack(e, Gap(gap));
+                break;
+            case 3:
+                if (path->Size() > 1)
+                    path->PopBack();
+                break;
+            default:
+                if (path->Size() > 1)
+                    conj_path->PopBack();
+        }
+
+        ASSERT_EQ(conj_path->Conjugate(), *path);
+        ASSERT_EQ(path->Length(), length_at(*path, 0));
+        for (size_t i = 0; i < path->Size(); ++i)
+            ASSERT_EQ(path->LengthAt(i), length_at(*path, i)) << "step " << step << ", edge " << i;
+    }
+    EXPECT_GT(path->Size(), 4);
+}
+
+TEST( PathExtend, IdealPairInfoConcurrent ) {
+    Graph g(13);
+    ASSERT_TRUE(graphio::ScanBasicGraph("./src/test/debruijn/graph_fragments/path_extend/distance_estimation", g));
+    std::map<int, size_t> is_distribution = { {180, 10}, {200, 30}, {220, 10} };
+    IdealPairInfoCounter counter(g, 180, 220, 100, is_distribution);
+
+    std::vector<double> expected;
+    for (EdgeId e1 : g.edges())
+        for (EdgeId e2 : g.edges())
+            for (int dist : { -50, 0, 30, 120 })
+                expected.push_back(counter.IdealPairedInfo(g.length(e1), g.length(e2), dist));
+
+    // Cached weights are moved between the modes and stay the same
+    for (bool concurrent : { false, true, false, true }) {
+        counter.set_concurrent(concurrent);
+        EXPECT_EQ(counter.concurrent(), concurrent);
+        size_t i = 0;
+        for (EdgeId e1 : g.edges())
+            for (EdgeId e2 : g.edges())
+                for (int dist : { -50, 0, 30, 120 })
+                    EXPECT_EQ(counter.IdealPairedInfo(e1, e2, dist), expected[i++]);
+    }
+}
+
+// Every component is a repeat R between the genome walks A R B E and C R D,
+// the paired info of the walks is needed to get through the repeat
+static void MakeRepeatComponents(Graph &g, size_t count,
+                                 PairedInfoIndexT<Graph> &index) {
+    auto edge_len = [&g](size_t min_len, size_t max_len) {
+        return RandomSequence(min_len + rand() % (max_len - min_len) + g.k());
+    };
+    for (size_t c = 0; c < count; ++c) {
+        std::vector<VertexId> v;
+        for (size_t i = 0; i < 7; ++i)
+            v.push_back(g.AddVertex());
+        EdgeId a = g.AddEdge(v[0], v[1], edge_len(200, 600));
+        EdgeId r = g.AddEdge(v[1], v[2], edge_len(50, 120));
+        EdgeId b = g.AddEdge(v[2], v[3], edge_len(200, 600));
+        EdgeId e = g.AddEdge(v[3], v[4], edge_len(100, 300));
+        EdgeId cc = g.AddEdge(v[5], v[1], edge_len(200, 600));
+        EdgeId d = g.AddEdge(v[2], v[6], edge_len(200, 600));
+
+        for (const std::vector<EdgeId> &walk : { std::vector<EdgeId>{ a, r, b, e },
+                                                 std::vector<EdgeId>{ cc, r, d } }) {
+            for (size_t i = 0; i < walk.size(); ++i) {
+                size_t dist = 0;
+                for (size_t j = i; j < walk.size(); ++j) {
+                    index.Add(walk[i], walk[j], omnigraph::de::Point(float(dist), 1000.f, 0.f));
+                    dist += g.length(walk[j]);
+                }
+            }
+        }
+    }
+}
+
+static void ExpectSamePaths(const PathContainer &expected, const PathContainer &paths) {
+    ASSERT_EQ(expected.size(), paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        for (const auto &pair : { std::make_pair(&expected.Get(i), &paths.Get(i)),
+                                  std::make_pair(&expected.GetConjugate(i), &paths.GetConjugate(i)) }) {
+            const BidirectionalPath &e = *pair.first, &p = *pair.second;
+            ASSERT_EQ(e.Size(), p.Size()) << "path " << i;
+            for (size_t j = 0; j < p.Size(); ++j) {
+                EXPECT_EQ(e[j], p[j]) << "path " << i << ", edge " << j;
+                EXPECT_EQ(e.GapAt(j), p.GapAt(j)) << "path " << i << ", edge " << j;
+            }
+        }
+        EXPECT_EQ(paths.Get(i).GetConjPath(), &paths.GetConjugate(i));
+        EXPECT_EQ(paths.GetConjugate(i).GetConjPath(), &paths.Get(i));
+    }
+}
+
+TEST( PathExtend, ExtendSeedsByComponents ) {
+    srand(42);
+    Graph g(21);
+    omnigraph::FlankingCoverage<Graph> flanking_cov(g, 50);
+    PairedInfoIndexT<Graph> index(g);
+    MakeRepeatComponents(g, 12, index);
+
+    std::map<int, size_t> is_distribution = { {300, 10}, {350, 30}, {400, 10} };
+    auto lib = std::make_shared<PairedInfoLibraryWithIndex<PairedInfoIndexT<Graph>>>(
+            g, 100, 350, 300, 400, 20., index, false, is_distribution);
+    ScaffoldingUniqueEdgeStorage unique_storage;
+
+    struct ThreadExtender {
+        GraphCoverageMap cover_map;
+        UsedUniqueStorage used;
+        std::unique_ptr<CompositeExtender> extender;
+
+        ThreadExtender(const Graph &g, const omnigraph::FlankingCoverage<Graph> &flanking_cov,
+                       const ScaffoldingUniqueEdgeStorage &unique_storage,
+                       std::shared_ptr<PairedInfoLibrary> lib)
+                : cover_map(g), used(unique_storage, g) {
+            auto wc = std::make_shared<PathCoverWeightCounter>(g, lib, true, 0.3);
+            auto chooser = std::make_shared<SimpleExtensionChooser>(g, wc, 0.5, 1.5);
+            std::vector<std::shared_ptr<PathExtender>> pes = {
+                std::make_shared<SimpleExtender>(g, flanking_cov, cover_map, used, chooser,
+                                                 false, false, lib->GetISMax(), 0.5)
+            };
+            extender = std::make_unique<CompositeExtender>(g, cover_map, used, pes);
+        }
+    };
+
+    PathExtendResolver resolver(g);
+    auto make_seeds = [&resolver]() {
+        auto seeds = resolver.MakeSimpleSeeds();
+        seeds.SortByLength();
+        return seeds;
+    };
+
+    ThreadExtender sequential(g, flanking_cov, unique_storage, lib);
+    auto seeds = make_seeds();
+    auto expected = resolver.ExtendSeeds(seeds, *sequential.extender);
+    // The repeats were resolved, so the paired info was used
+    size_t longest = 0;
+    for (const auto &entry : expected)
+        longest = std::max(longest, entry.first->Size());
+    EXPECT_EQ(longest, 4);
+
+    debruijn_graph::ConnectedComponentCounter components(g);
+    components.CalculateComponents();
+    ASSERT_GE(components.component_total_len_.size(), 12);
+
+    lib->SetConcurrent(true);
+    for (size_t nthreads : { 1, 4 }) {
+        std::vector<std::unique_ptr<ThreadExtender>> threads;
+        std::vector<std::unique_ptr<CompositeExtender>> extenders;
+        for (size_t i = 0; i < nthreads; ++i) {
+            threads.push_back(std::make_unique<ThreadExtender>(g, flanking_cov, unique_storage, lib));
+            extenders.push_back(std::move(threads.back()->extender));
+        }
+        GraphCoverageMap cover_map(g);
+        auto component_seeds = make_seeds();
+        auto paths = resolver.ExtendSeeds(component_seeds, components, extenders, cover_map);
+        ExpectSamePaths(expected, paths);
+        for (EdgeId e : g.edges())
+            EXPECT_EQ(cover_map.GetCoverage(e), sequential.cover_map.GetCoverage(e));
+    }
+    lib->SetConcurrent(false);
+}
+
+static std::vector<EdgeId> RandomWalk(const Graph &g, EdgeId start, size_t max_size) {
+    std::vector<EdgeId> walk = { start };
+    while (walk.size() < max_size && g.OutgoingEdgeCount(g.EdgeEnd(walk.back()))) {
+        auto out = g.OutgoingEdges(g.EdgeEnd(walk.back()));
+        auto it = out.begin();
+        std::advance(it, rand() % g.OutgoingEdgeCount(g.EdgeEnd(walk.back())));
+        walk.push_back(*it);
+    }
+    return walk;
+}
+
+TEST( PathExtend, LongReadsCoverageMap ) {
+    srand(42);
+    Graph g(21);
+    PairedInfoIndexT<Graph> index(g);
+    MakeRepeatComponents(g, 6, index);
+    // A loop to have the edges repeated within the paths
+    VertexId u = g.AddVertex(), v = g.AddVertex(), w = g.AddVertex();
+    g.AddEdge(u, v, RandomSequence(300 + g.k()));
+    g.AddEdge(v, v, RandomSequence(80 + g.k()));
+    g.AddEdge(v, w, RandomSequence(300 + g.k()));
+
+    std::vector<EdgeId> edges;
+    for (EdgeId e : g.edges())
+        edges.push_back(e);
+    PathStorage<Graph> storage(g);
+    for (size_t i = 0; i < 2000; ++i)
+        storage.AddPath(RandomWalk(g, edges[rand() % edges.size()], 1 + rand() % 6), 1 + rand() % 3, rand() % 2);
+
+    // The paths as they were created from the storage for the long read choosers
+    PathContainer paths;
+    std::vector<PathInfo<Graph>> infos;
+    storage.SaveAllPaths(infos);
+    for (const auto &info : infos) {
+        if (info.path().size() <= 1)
+            continue;
+        auto pair = paths.CreatePair(g, info.path());
+        pair.first.SetWeight((float) info.weight());
+        pair.second.SetWeight((float) info.weight());
+    }
+    LongReadsCoverageMap expected(g, paths);
+
+    storage.BuildCoverageIndex(2);
+    LongReadsCoverageMap cov_map(g, storage);
+    EXPECT_FALSE(cov_map.empty());
+    EXPECT_TRUE(LongReadsCoverageMap(g).empty());
+
+    for (EdgeId e : g.edges()) {
+        auto expected_paths = expected.GetCoveringPaths(e);
+        auto cov_paths = cov_map.GetCoveringPaths(e);
+        ASSERT_EQ(expected_paths.size(), cov_paths.size()) << "edge " << e;
+        for (size_t i = 0; i < cov_paths.size(); ++i) {
+            const LongReadPath &p1 = expected_paths[i], &p2 = cov_paths[i];
+            ASSERT_EQ(p1.Size(), p2.Size());
+            for (size_t j = 0; j < p1.Size(); ++j) {
+                EXPECT_EQ(p1[j], p2[j]);
+                EXPECT_EQ(p1.LengthAt(j), p2.LengthAt(j));
+                EXPECT_EQ(p1.GapAt(j).gap, p2.GapAt(j).gap);
+            }
+            EXPECT_EQ(p1.FindAll(e), p2.FindAll(e));
+            EXPECT_EQ(p1.GetWeight(), p2.GetWeight());
+        }
+    }
+
+    for (double prior_threshold : { 1.5, 5. }) {
+        LongReadsUniqueEdgeAnalyzer expected_analyzer(g, expected, 20., prior_threshold, 8000, false);
+        LongReadsUniqueEdgeAnalyzer analyzer(g, cov_map, 20., prior_threshold, 8000, false);
+        size_t unique = 0;
+        for (EdgeId e : g.edges()) {
+            EXPECT_EQ(expected_analyzer.IsUnique(e), analyzer.IsUnique(e)) << "edge " << e;
+            unique += analyzer.IsUnique(e);
+        }
+        EXPECT_GT(unique, 0);
+        EXPECT_LT(unique, edges.size());
+    }
+
+    LongReadsExtensionChooser expected_chooser(g, expected, 2., 1.2, 1.5, 0, 8000, false);
+    LongReadsExtensionChooser chooser(g, cov_map, 2., 1.2, 1.5, 0, 8000, false);
+    LongReadsRNAExtensionChooser expected_rna_chooser(g, expected, 1.5, 0);
+    LongReadsRNAExtensionChooser rna_chooser(g, cov_map, 1.5, 0);
+    LongReadsLibConnectionCondition expected_condition(g, 0, 2, expected);
+    LongReadsLibConnectionCondition condition(g, 0, 2, cov_map);
+    auto to_edges = [](const ExtensionChooser::EdgeContainer &container) {
+        std::vector<EdgeId> result;
+        for (const auto &edge : container)
+            result.push_back(edge.e_);
+        return result;
+    };
+    size_t chosen = 0;
+    for (size_t i = 0; i < 500; ++i) {
+        auto walk = RandomWalk(g, edges[rand() % edges.size()], 1 + rand() % 4);
+        auto path = BidirectionalPath::create(g, walk);
+        ExtensionChooser::EdgeContainer candidates;
+        for (EdgeId e : g.OutgoingEdges(g.EdgeEnd(walk.back())))
+            candidates.emplace_back(e, 0);
+
+        auto result = to_edges(chooser.Filter(*path, candidates));
+        EXPECT_EQ(to_edges(expected_chooser.Filter(*path, candidates)), result);
+        chosen += result.size() == 1;
+        EXPECT_EQ(to_edges(expected_rna_chooser.Filter(*path, candidates)),
+                  to_edges(rna_chooser.Filter(*path, candidates)));
+        if (walk.size() > 1) {
+            EXPECT_EQ(expected_condition.GetMedianGap(walk.front(), walk.back()),
+                      condition.GetMedianGap(walk.front(), walk.back()));
+        }
+    }
+    // The choosers were not trivially empty
+    EXPECT_GT(chosen, 0);
+}
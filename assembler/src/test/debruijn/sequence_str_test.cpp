@@ -0,0 +1,66 @@
+//***************************************************************************
+//* Copyright (c) 2021 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#include "random_graph.hpp"
+#include "sequence/sequence.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace debruijn_graph;
+
+// Reference conversion, one nucleotide at a time
+static std::string NaiveStr(const Sequence &s) {
+    std::string res(s.size(), '-');
+    for (size_t i = 0; i < s.size(); ++i)
+        res[i] = nucl(s[i]);
+    return res;
+}
+
+static void CheckStr(const Sequence &s) {
+    EXPECT_EQ(NaiveStr(s), s.str());
+
+    // Appending keeps the existing contents
+    std::string out = "prefix";
+    s.AppendStr(out);
+    EXPECT_EQ("prefix" + NaiveStr(s), out);
+}
+
+TEST(Sequence, Str) {
+    for (size_t len : {0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 1000}) {
+        Sequence s = RandomSequence(len);
+        CheckStr(s);
+        CheckStr(!s);
+        CheckStr(!!s);
+    }
+}
+
+// Subsequences start and end at every offset within a byte, both in direct
+// and reverse-complement sequences
+TEST(Sequence, StrSubseq) {
+    Sequence s = RandomSequence(70);
+    for (const Sequence &seq : {s, !s}) {
+        for (size_t from = 0; from < 12; ++from) {
+            for (size_t to = seq.size() - 12; to <= seq.size(); ++to) {
+                Sequence sub = seq.Subseq(from, to);
+                CheckStr(sub);
+                CheckStr(!sub);
+                CheckStr((!sub).Subseq(1, sub.size() - 1));
+            }
+            for (size_t len = 0; len < 9; ++len)
+                CheckStr(seq.Subseq(from, from + len));
+        }
+    }
+}
+
+TEST(Sequence, StrRandom) {
+    for (size_t i = 0; i < 1000; ++i) {
+        Sequence s = RandomSequence(1 + rand() % 300);
+        size_t from = rand() % s.size();
+        size_t to = from + rand() % (s.size() - from + 1);
+        Sequence sub = (rand() % 2 ? !s : s).Subseq(from, to);
+        CheckStr(rand() % 2 ? !sub : sub);
+    }
+}